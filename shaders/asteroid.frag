@@ -0,0 +1,17 @@
+#version 330 core
+in vec3 FragPos;
+in vec3 Normal;
+in float Shade;
+out vec4 FragColor;
+
+uniform vec3 lightPos;     // the Sun
+uniform float ambientK;
+
+void main()
+{
+    vec3 albedo = vec3(0.55, 0.5, 0.45) * Shade;
+    vec3 N = normalize(Normal);
+    vec3 L = normalize(lightPos - FragPos);
+    float diff = max(dot(N, L), 0.0);
+    FragColor = vec4(ambientK * albedo + diff * albedo, 1.0);
+}
@@ -0,0 +1,37 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTex;     // unused
+// per-instance heliocentric ecliptic position in AU (one buffer per axis)
+layout(location = 3) in float aX;
+layout(location = 4) in float aY;
+layout(location = 5) in float aZ;
+
+out vec3 FragPos;
+out vec3 Normal;
+out float Shade;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec2 beltAU;       // min/max heliocentric distance in AU
+uniform vec2 beltScene;    // the same radii in scene units
+uniform float size;
+
+float hash(float n) { return fract(sin(n) * 43758.5453); }
+
+void main()
+{
+    // ecliptic (z up) -> scene (y up), distance remapped onto the scene's Mars..Jupiter gap
+    vec3 ecl = vec3(aX, aY, aZ);
+    float r = max(length(ecl), 1e-6);
+    float t = (r - beltAU.x) / (beltAU.y - beltAU.x);
+    vec3 center = vec3(ecl.x, ecl.z, ecl.y) * (mix(beltScene.x, beltScene.y, t) / r);
+
+    float id = float(gl_InstanceID);
+    float s = size * (0.4 + 1.2 * hash(id));
+    Shade = 0.6 + 0.4 * hash(id + 17.0);
+
+    FragPos = center + aPos * s;
+    Normal = aNormal;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
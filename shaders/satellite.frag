@@ -0,0 +1,11 @@
+#version 330 core
+flat in vec3 Color;
+out vec4 FragColor;
+
+void main()
+{
+    // round points
+    vec2 d = gl_PointCoord - vec2(0.5);
+    if (dot(d, d) > 0.25) discard;
+    FragColor = vec4(Color, 1.0);
+}
@@ -0,0 +1,32 @@
+#version 330 core
+// per-instance TEME position, km, as three float streams
+layout(location = 0) in float aX;
+layout(location = 1) in float aY;
+layout(location = 2) in float aZ;
+
+flat out vec3 Color;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 centre;       // the Earth's scene position
+uniform float kmScale;     // scene units per km: drawn radius / equatorial radius
+uniform vec2 tilt;         // sin, cos of the drawn Earth's axial tilt
+uniform float pointSize;
+
+void main()
+{
+    float r = length(vec3(aX, aY, aZ));
+    float alt = r - 6378.135;
+    // LEO green, MEO orange, near-geosynchronous red, beyond violet
+    Color = alt < 2000.0 ? vec3(0.45, 1.0, 0.55)
+          : alt < 34000.0 ? vec3(1.0, 0.7, 0.3)
+          : alt < 37500.0 ? vec3(1.0, 0.35, 0.35) : vec3(0.75, 0.55, 1.0);
+    // TEME z along the drawn spin axis, the equator in the drawn equatorial plane
+    vec3 scene = centre + kmScale * (aX * vec3(0.0, 0.0, -1.0)
+                                   + aY * vec3(tilt.y, -tilt.x, 0.0)
+                                   + aZ * vec3(tilt.x, tilt.y, 0.0));
+    gl_Position = projection * view * vec4(scene, 1.0);
+    // lost objects sit at the centre: move them out of the clip volume
+    if (r < 1.0) gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    gl_PointSize = pointSize;
+}
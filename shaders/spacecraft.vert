@@ -0,0 +1,22 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;  // unused
+layout(location = 2) in vec2 aTex;     // unused
+// per-instance scene position, and the level of the body the craft orbits (0 Sun, 1 planet, 2 moon)
+layout(location = 3) in vec4 aCraft;
+
+flat out vec3 Color;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float size;        // marker radius as a fraction of the distance to the camera
+
+void main()
+{
+    const vec3 colors[3] = vec3[3](vec3(1.0, 0.85, 0.25), vec3(0.3, 0.9, 1.0), vec3(1.0, 0.45, 0.85));
+    Color = colors[clamp(int(aCraft.w + 0.5), 0, 2)];
+    // a constant size on screen, however far the camera is
+    vec4 eye = view * vec4(aCraft.xyz, 1.0);
+    eye.xyz += aPos * size * max(-eye.z, 1e-3);
+    gl_Position = projection * eye;
+}
@@ -0,0 +1,7 @@
+// src/headless.cpp
+// Viewer-less entry point for compute nodes without GL/GLFW.
+#include "sim/solar_sim.h"
+
+int main(int argc, char** argv) {
+    return headlessMain(argc, argv);
+}
@@ -10,13 +10,25 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <cmath>
+#include <cstdlib>
 #include <map>
+#include <future>
+
+#include "sim/solar_sim.h"
+#include "sim/event_search.h"
+#include "sim/gravity_assist.h"
+#include "sim/kepler.h"
+#include "sim/nbody.h"
+#include "sim/porkchop.h"
+#include "sim/sim_thread.h"
+#include "sim/thread_pool.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../include/stb_image.h"
@@ -43,13 +55,15 @@ std::string readFile(const std::string &rel) {
 }
 
 // Format simulated time function
-std::string formatSimulatedTime(float simulatedTimeDays) {
-    int totalDays = static_cast<int>(simulatedTimeDays);
-    int years = totalDays / 365;
-    int weeks = (totalDays % 365) / 7;
-    int days = (totalDays % 365) % 7;
-
+std::string formatSimulatedTime(SimTicks simulatedTime) {
+    // whole days straight from the integer clock, before J2000 as well
+    long long totalDays = simulatedTime / TICKS_PER_DAY;
     std::string res;
+    if (totalDays < 0) { res = "-"; totalDays = -totalDays; }
+    long long years = totalDays / 365;
+    long long weeks = (totalDays % 365) / 7;
+    long long days = (totalDays % 365) % 7;
+
     if (years > 0) {
         res += std::to_string(years) + (years == 1 ? " year " : " years ");
     }
@@ -139,6 +153,25 @@ void createOrbitLine(float radius, int segments, std::vector<float> &vertices) {
     }
 }
 
+// Ecliptic (z up, AU) -> scene (y up). `scale` maps AU onto the scene's orbit radii.
+glm::vec3 eclipticToScene(float x, float y, float z, float scale) {
+    return glm::vec3(x, z, y) * scale;
+}
+
+// --- Keplerian orbit line generator ---
+void createKeplerOrbitLine(const OrbitalElements &el, float scale, int segments, std::vector<float> &vertices) {
+    vertices.clear();
+    const double period = TWO_PI / (GAUSS_K / sqrt(el.a * el.a * el.a));
+    for (int i = 0; i <= segments; ++i) {
+        double r[3];
+        keplerPosition(el, 1.0, el.epoch + period * i / segments, r);
+        glm::vec3 v = eclipticToScene((float)r[0], (float)r[1], (float)r[2], scale);
+        vertices.push_back(v.x);
+        vertices.push_back(v.y);
+        vertices.push_back(v.z);
+    }
+}
+
 // --- texture loader ---
 GLuint loadTextureTry(const std::string &relPath) {
     std::string path = tryPrefixes(relPath);
@@ -180,6 +213,40 @@ GLuint loadCubemapFaces(const std::vector<std::string>& facePaths) {
     return texID;
 }
 
+// --- porkchop heatmap ---
+// Departure along x, arrival up y. Values from the map minimum to `top` run
+// blue -> cyan -> yellow -> red in 16 bands (the band edges read as contours);
+// anything above `top` or without a transfer is dark.
+void uploadHeatmap(GLuint &tex, const PorkchopGrid &grid, const std::vector<float> &map, float top) {
+    const size_t nd = grid.spec.departSteps, na = grid.spec.arriveSteps;
+    const size_t best = grid.minimum(map);
+    const float lo = best < map.size() ? map[best] : 0.0f;
+    const float stops[4][3] = {{0.1f, 0.2f, 0.8f}, {0.1f, 0.8f, 0.9f}, {0.95f, 0.9f, 0.2f}, {0.9f, 0.15f, 0.1f}};
+    std::vector<unsigned char> rgba(nd * na * 4);
+    for (size_t i = 0; i < nd; ++i) {
+        for (size_t j = 0; j < na; ++j) {
+            unsigned char* px = &rgba[((na - 1 - j) * nd + i) * 4];
+            const float v = grid.at(map, i, j);
+            px[3] = 255;
+            if (std::isnan(v) || v > top || top <= lo) {
+                px[0] = px[1] = px[2] = 24;
+                continue;
+            }
+            const float t = std::floor((v - lo) / (top - lo) * 16.0f) / 16.0f * 2.999f;
+            const int k = (int)t;
+            const float f = t - (float)k;
+            for (int c = 0; c < 3; ++c) px[c] = (unsigned char)(255.0f * (stops[k][c] + f * (stops[k + 1][c] - stops[k][c])));
+        }
+    }
+    if (!tex) glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (GLsizei)nd, (GLsizei)na, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
 // --- skybox VAO ---
 void createSkyboxVAO(GLuint &vao, GLuint &vbo) {
     static const float skyboxVertices[] = {
@@ -392,41 +459,36 @@ void keyCB(GLFWwindow* w, int key, int sc, int action, int mods) {
     }
 }
 
-auto degPerSec = [](float days) -> float {
-    return 360.0f / (days * 86400.0f);
-};
-
 bool simulationRunning = true;
 float timeMultiplier = 1.0f;
-float simulatedTimeDays = 0.0f;
-
-struct Moon {
-    std::string name;
-    float orbitRadius;
-    float orbitSpeed;
-    float rotationSpeed;
-    float size;
-    GLuint texture;
-    float orbitAngle;
-    float rotationAngle;
-};
+SimTicks simulatedTime = 0;   // ms since J2000
+bool closedFormTime = true;   // angles from absolute time instead of per-frame accumulation
+int orbitModel = ORBIT_CIRCULAR;
 
-struct Planet {
-    std::string name;
-    float orbitRadius;
-    float orbitSpeed;
-    float rotationSpeed;
-    float axialTilt;
-    float size;
+// GL handles for a Planet, kept out of the simulation state
+struct PlanetVisual {
     GLuint texture;
-    float orbitAngle;
-    float rotationAngle;
-    bool hasRing;
     GLuint ringTex;
-    std::vector<Moon> moons; 
+    std::vector<GLuint> moonTextures;
 };
 
-int main() {
+int main(int argc, char** argv) {
+    std::string ephemerisPath = "planets.eph";
+    std::string dePath = "de440.bin";
+    std::string vsopDir = "vsop87";
+    std::string tlePath = "satellites.tle";
+    size_t extraMoons = 0;
+    std::string replayPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--headless") return headlessMain(argc, argv);
+        if (std::string(argv[i]) == "--ephemeris" && i + 1 < argc) ephemerisPath = argv[++i];
+        if (std::string(argv[i]) == "--de" && i + 1 < argc) dePath = argv[++i];
+        if (std::string(argv[i]) == "--vsop87" && i + 1 < argc) vsopDir = argv[++i];
+        if (std::string(argv[i]) == "--tle" && i + 1 < argc) tlePath = argv[++i];
+        if (std::string(argv[i]) == "--moons" && i + 1 < argc) extraMoons = (size_t)std::atol(argv[++i]);
+        if (std::string(argv[i]) == "--replay" && i + 1 < argc) replayPath = argv[++i];
+    }
+
     int selectedPlanetIndex = -1;
 
     if (!glfwInit()) { std::cerr << "GLFW init failed\n"; return -1; }
@@ -534,39 +596,29 @@ int main() {
     GLint skyLoc = glGetUniformLocation(skyProg, "skybox");
     if (skyLoc >= 0) glUniform1i(skyLoc, 0);
 
-    std::map<std::string, float> orbitalPeriods = {
-        {"Mercury", 87.97f},
-        {"Venus", 224.7f},
-        {"Earth", 365.256f},
-        {"Mars", 687.0f},
-        {"Jupiter", 4331.0f},
-        {"Saturn", 10747.0f},
-        {"Uranus", 30589.0f},
-        {"Neptune", 59800.0f}
-    };
-    auto rotSpeedH = [](float hours) -> float {
-        return 360.0f / (hours * 3600.0f);
+    std::vector<Planet> planets = createSolarSystem();
+    addSyntheticMoons(planets, extraMoons);   // same seed as the sim thread's copy
+    std::vector<PlanetVisual> visuals = {
+        {texMercury, 0, {}},
+        {texVenus,   0, {}},
+        {texEarth,   0, {texMoon}},
+        {texMars,    0, {}},
+        {texJupiter, 0, {}},
+        {texSaturn,  texSaturnRing, {}},
+        {texUranus,  0, {}},
+        {texNeptune, 0, {}}
     };
 
-    std::vector<Planet> planets = {
-        {"Mercury", 2.0f, degPerSec(orbitalPeriods["Mercury"]), rotSpeedH(1407.6f), 0.01f, 0.09f, texMercury, 0.0f, 0.0f, false, 0, {}},
-        {"Venus",   3.0f, degPerSec(orbitalPeriods["Venus"]),   rotSpeedH(-5832.5f), 177.4f, 0.19f, texVenus, 60.0f, 0.0f, false, 0, {}},
-        {"Earth",   4.0f, degPerSec(orbitalPeriods["Earth"]),   rotSpeedH(23.93f), 23.44f, 0.205f, texEarth, 120.0f, 0.0f, false, 0, {}},
-        {"Mars",    5.0f, degPerSec(orbitalPeriods["Mars"]),    rotSpeedH(24.62f), 25.19f, 0.14f, texMars, 200.0f, 0.0f, false, 0, {}},
-        {"Jupiter", 7.0f, degPerSec(orbitalPeriods["Jupiter"]), rotSpeedH(9.93f), 3.13f, 0.48f, texJupiter, 20.0f, 0.0f, false, 0, {}},
-        {"Saturn",  9.0f, degPerSec(orbitalPeriods["Saturn"]),  rotSpeedH(10.56f), 26.73f, 0.42f, texSaturn, 300.0f, 0.0f, true,  texSaturnRing, {}},
-        {"Uranus",  11.5f, degPerSec(orbitalPeriods["Uranus"]),  rotSpeedH(-17.24f), 97.77f, 0.28f, texUranus, 340.0f, 0.0f, false, 0, {}},
-        {"Neptune", 14.0f, degPerSec(orbitalPeriods["Neptune"]), rotSpeedH(16.11f), 28.32f, 0.27f, texNeptune, 80.0f, 0.0f, false, 0, {}}
-    };
-    planets[2].moons.push_back({
-        "Moon",  
-        0.3f,                
-        degPerSec(27.3f),     
-        degPerSec(27.3f),
-        0.05f,               
-        texMoon,
-        0.0f, 0.0f
-    });
+    // Body order of the sim's registry (planets, then moons by planet) with
+    // one texture per body, so drawing is a single pass over the snapshot.
+    BodyRegistry bodyLayout = buildRegistry(planets);
+    std::vector<GLuint> bodyTextures;
+    for (size_t pi = 0; pi < planets.size(); ++pi) bodyTextures.push_back(visuals[pi].texture);
+    for (size_t pi = 0; pi < planets.size(); ++pi) {
+        for (size_t mi = 0; mi < planets[pi].moons.size(); ++mi) {
+            bodyTextures.push_back(mi < visuals[pi].moonTextures.size() ? visuals[pi].moonTextures[mi] : texMoon);
+        }
+    }
 
     GLuint ringVAO = 0, ringVBO = 0, ringEBO = 0; GLsizei ringIndexCount = 0;
     if (texSaturnRing) {
@@ -585,22 +637,249 @@ int main() {
     glEnableVertexAttribArray(2); glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,stride,(void*)(6*sizeof(float)));
     glBindVertexArray(0);
 
+    std::vector<OrbitalElements> planetElements = planetElementsJ2000();
+    std::vector<float> keplerScale(planets.size());
+    for (size_t i = 0; i < planets.size(); ++i) {
+        keplerScale[i] = planets[i].orbitRadius / (float)planetElements[i].a;
+    }
+
+    // === ASTEROID BELT ===
+    // Positions come from the SoA Kepler kernels on the sim thread; the GPU reads
+    // them as three per-instance float streams (x, y, z blocks of one buffer)
+    // and draws the whole belt with a single instanced call.
+    const int beltCounts[] = {10000, 100000, 1000000};
+    int beltCountIdx = 1;
+    bool showBelt = true;
+    double beltSubmitMs = 0.0, beltGpuMs = 0.0;
+
+    std::string asteroidVSs = readFile("shaders/asteroid.vert");
+    std::string asteroidFSs = readFile("shaders/asteroid.frag");
+    GLuint asteroidV = compileShaderSrc(asteroidVSs.c_str(), GL_VERTEX_SHADER, "asteroid.vert");
+    GLuint asteroidF = compileShaderSrc(asteroidFSs.c_str(), GL_FRAGMENT_SHADER, "asteroid.frag");
+    GLuint asteroidProg = linkProgram(asteroidV, asteroidF);
+
+    std::vector<float> rockVerts; std::vector<unsigned int> rockInds;
+    createSphere(1.0f, 6, 4, rockVerts, rockInds);
+    GLsizei rockIndexCount = (GLsizei)rockInds.size();
+    GLuint rockVAO, rockVBO, rockEBO, beltInstanceVBO;
+    glGenVertexArrays(1, &rockVAO);
+    glGenBuffers(1, &rockVBO);
+    glGenBuffers(1, &rockEBO);
+    glGenBuffers(1, &beltInstanceVBO);
+    glBindVertexArray(rockVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, rockVBO); glBufferData(GL_ARRAY_BUFFER, rockVerts.size()*sizeof(float), rockVerts.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rockEBO); glBufferData(GL_ELEMENT_ARRAY_BUFFER, rockInds.size()*sizeof(unsigned int), rockInds.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0); glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,stride,(void*)0);
+    glEnableVertexAttribArray(1); glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,stride,(void*)(3*sizeof(float)));
+    glEnableVertexAttribArray(2); glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,stride,(void*)(6*sizeof(float)));
+    glBindVertexArray(0);
+
+    // (re)size the instance buffer and point attributes 3..5 at its x/y/z blocks
+    size_t beltAllocated = 0;
+    auto allocBeltBuffer = [&](size_t n) {
+        beltAllocated = n;
+        glBindVertexArray(rockVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, beltInstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, 3*n*sizeof(float), NULL, GL_STREAM_DRAW);
+        for (GLuint c = 0; c < 3; ++c) {
+            glEnableVertexAttribArray(3 + c);
+            glVertexAttribPointer(3 + c, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(c*n*sizeof(float)));
+            glVertexAttribDivisor(3 + c, 1);
+        }
+        glBindVertexArray(0);
+    };
+
+    GLuint beltQuery; glGenQueries(1, &beltQuery);
+    bool beltQueryPending = false;
+
+    // === SIMULATION THREAD ===
+    // The loop below only reads snapshots and hands over settings.
+    SimulationThread sim(&sharedThreadPool(), extraMoons);
+    int nbodyIntegrator = (int)Integrator::WisdomHolman;
+    bool barnesHut = false;
+    float theta = 0.5f;
+    int substepBudget = 1000;
+    if (sim.loadEphemeris(ephemerisPath)) {
+        std::cout << "Ephemeris " << ephemerisPath << ": days " << sim.ephemeris().startDays()
+                  << ".." << sim.ephemeris().endDays() << " mapped\n";
+    } else {
+        std::cout << "No ephemeris at " << ephemerisPath << " (build one with --headless --build-ephemeris "
+                  << ephemerisPath << ")\n";
+    }
+    if (sim.loadJplEphemeris(dePath)) {
+        std::cout << "JPL DE" << sim.jplEphemeris().version() << " " << dePath << ": days "
+                  << sim.jplEphemeris().startDays() << ".." << sim.jplEphemeris().endDays() << " mapped\n";
+    }
+    if (sim.loadVsop87(vsopDir)) {
+        std::cout << "VSOP87A " << vsopDir << ": " << sim.vsop87().termCount(0) << " terms\n";
+    }
+    if (sim.loadTle(tlePath)) {
+        std::cout << "TLE " << tlePath << ": " << sim.satellites().size() << " satellites ("
+                  << sim.satellites().deepSpaceCount() << " deep space, " << sim.satellites().rejected
+                  << " rejected)\n";
+    }
+    int vsopLevel = 0;
+    bool showTrails = true;
+    float checkpointDays = 30.0f;
+    int checkpointBudgetMB = 32;
+    float rewindDays = 0.0f;
+    bool blockSteps = true;
+    bool simLod = true;
+    float lodMinPixels = 24.0f;
+    float lodBudgetMs = 0.5f;
+    std::vector<uint8_t> systemLod(planets.size(), LOD_FULL);
+
+    // === REPLAY ===
+    // Frames come from the mapped recording; the sim thread is never started.
+    StateReplay replay;
+    SimSnapshot replaySnap;
+    BodyRegistry replayLayout;
+    SimTicks replayTime = 0;
+    if (!replayPath.empty() && replay.open(replayPath)) {
+        replayLayout = buildRegistry(planets);   // already carries the --moons satellites
+        if (replay.bodyCount() == replayLayout.size()) {
+            replayTime = replay.startTime();
+            replaySnap.px.resize(replay.bodyCount());
+            replaySnap.py.resize(replay.bodyCount());
+            replaySnap.pz.resize(replay.bodyCount());
+            replaySnap.model.resize(16 * replay.bodyCount());
+            std::cout << "Replaying " << replayPath << ": " << replay.frameCount() << " frames, days "
+                      << ticksToDays(replay.startTime()) << ".." << ticksToDays(replay.endTime()) << "\n";
+        } else {
+            std::cerr << "Recording has " << replay.bodyCount() << " bodies, expected " << replayLayout.size()
+                      << " (same --moons as when recorded)\n";
+            replay.close();
+        }
+    }
+    const bool replaying = replay.valid();
+    const std::string recordFile = "recording.rec";   // where the Record button writes
+    if (!replaying) sim.start();
+    // time controls move the replay clock instead when there is no sim thread
+    auto jumpToTicks = [&](SimTicks t) {
+        if (replaying) replayTime = std::min(std::max(t, replay.startTime()), replay.endTime());
+        else sim.jumpToTicks(t);
+    };
+    double jumpDay = 0.0;
+    float scrubYears = 0.0f;
+
+    // === EVENT SEARCH ===
+    // Runs off the UI thread; the index is swapped in when it finishes.
+    EventIndex eventIndex;
+    std::future<std::vector<AstroEvent>> eventSearch;
+    int eventFromYear = 1900, eventToYear = 2100;
+    bool eventTypes[EVENT_TYPES] = {true, true, false, false, true};
+
+    // === PORKCHOP ===
+    // Grids are computed off the UI thread on the shared pool, then coloured into a texture.
+    std::future<PorkchopGrid> porkchopJob;
+    PorkchopGrid porkchop;
+    GLuint porkchopTex = 0;
+    int porkchopFrom = 2, porkchopTo = 3, porkchopYear = 2020, porkchopSpan = 365, porkchopGridIdx = 1;
+    int porkchopMap = 0;
+    float porkchopTop[3] = {60.0f, 10.0f, 15.0f};   // colour scale top per map
+    bool porkchopDirty = false;
+    std::vector<const char*> porkchopBodies;
+    for (size_t i = 0; i < planets.size() && i < planetElements.size(); ++i) porkchopBodies.push_back(planets[i].name.c_str());
+
+    // === GRAVITY ASSIST ===
+    // The search runs off the UI thread; its progress and best-so-far are polled every frame.
+    GravityAssistSearch assistSearch;
+    std::future<GravityAssistPath> assistJob;
+    int assistFrom = 2, assistTo = 4, assistYear = 1989, assistSpan = 730, assistFlybys = 3;
+    bool assistVia[8] = {false, true, true, true, false, false, false, false};   // Venus, Earth, Mars
+
+    // === SPACECRAFT ===
+    // Patched-conic craft from the sim thread: one vec4 per craft (scene position,
+    // level of the body it orbits), drawn as instanced markers on the rock mesh.
+    std::string craftVSs = readFile("shaders/spacecraft.vert");
+    std::string craftFSs = readFile("shaders/spacecraft.frag");
+    GLuint craftV = compileShaderSrc(craftVSs.c_str(), GL_VERTEX_SHADER, "spacecraft.vert");
+    GLuint craftF = compileShaderSrc(craftFSs.c_str(), GL_FRAGMENT_SHADER, "spacecraft.frag");
+    GLuint craftProg = linkProgram(craftV, craftF);
+    GLuint craftVAO, craftInstanceVBO;
+    glGenVertexArrays(1, &craftVAO);
+    glGenBuffers(1, &craftInstanceVBO);
+    glBindVertexArray(craftVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, rockVBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, rockEBO);
+    glEnableVertexAttribArray(0); glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,stride,(void*)0);
+    glEnableVertexAttribArray(1); glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,stride,(void*)(3*sizeof(float)));
+    glEnableVertexAttribArray(2); glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,stride,(void*)(6*sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, craftInstanceVBO);
+    glEnableVertexAttribArray(3); glVertexAttribPointer(3,4,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)0);
+    glVertexAttribDivisor(3, 1);
+    glBindVertexArray(0);
+    bool showCraft = true;
+    int craftFrom = 2, craftCount = 100;
+    float craftVMin = 1.0f, craftVMax = 6.0f;   // excess speed range, km/s
+
+    // === EARTH SATELLITES ===
+    // SGP4 positions (TEME km) from the sim thread, three per-instance float
+    // streams like the belt, drawn as one instanced point per object around
+    // the Earth at the drawn Earth's scale and tilt.
+    std::string satVSs = readFile("shaders/satellite.vert");
+    std::string satFSs = readFile("shaders/satellite.frag");
+    GLuint satV = compileShaderSrc(satVSs.c_str(), GL_VERTEX_SHADER, "satellite.vert");
+    GLuint satF = compileShaderSrc(satFSs.c_str(), GL_FRAGMENT_SHADER, "satellite.frag");
+    GLuint satProg = linkProgram(satV, satF);
+    GLuint satVAO, satInstanceVBO;
+    glGenVertexArrays(1, &satVAO);
+    glGenBuffers(1, &satInstanceVBO);
+    size_t satAllocated = 0;
+    auto allocSatBuffer = [&](size_t n) {
+        satAllocated = n;
+        glBindVertexArray(satVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, satInstanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, 3*n*sizeof(float), NULL, GL_STREAM_DRAW);
+        for (GLuint c = 0; c < 3; ++c) {
+            glEnableVertexAttribArray(c);
+            glVertexAttribPointer(c, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(c*n*sizeof(float)));
+            glVertexAttribDivisor(c, 1);
+        }
+        glBindVertexArray(0);
+    };
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    bool showSatellites = true;
+    float satPointSize = 2.0f;
+    const int earthIndex = 2;   // createSolarSystem() order
+
+    auto uploadLineStrip = [](const std::vector<float> &lineVerts, GLuint &vao, GLuint &vbo) {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, lineVerts.size()*sizeof(float), lineVerts.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(float),(void*)0);
+        glBindVertexArray(0);
+    };
+
     std::vector<GLuint> orbitVAOs(planets.size());
     std::vector<GLuint> orbitVBOs(planets.size());
     std::vector<int> orbitVertexCounts(planets.size());
+    std::vector<GLuint> keplerOrbitVAOs(planets.size());
+    std::vector<GLuint> keplerOrbitVBOs(planets.size());
+    std::vector<int> keplerOrbitVertexCounts(planets.size());
     for (size_t i = 0; i < planets.size(); ++i) {
         std::vector<float> orbitLineVerts;
         createOrbitLine(planets[i].orbitRadius, 128, orbitLineVerts);
         orbitVertexCounts[i] = (int)orbitLineVerts.size()/3;
-        glGenVertexArrays(1, &orbitVAOs[i]);
-        glGenBuffers(1, &orbitVBOs[i]);
-        glBindVertexArray(orbitVAOs[i]);
-        glBindBuffer(GL_ARRAY_BUFFER, orbitVBOs[i]);
-        glBufferData(GL_ARRAY_BUFFER, orbitLineVerts.size()*sizeof(float), orbitLineVerts.data(), GL_STATIC_DRAW);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(float),(void*)0);
-        glBindVertexArray(0);
+        uploadLineStrip(orbitLineVerts, orbitVAOs[i], orbitVBOs[i]);
+
+        createKeplerOrbitLine(planetElements[i], keplerScale[i], 256, orbitLineVerts);
+        keplerOrbitVertexCounts[i] = (int)orbitLineVerts.size()/3;
+        uploadLineStrip(orbitLineVerts, keplerOrbitVAOs[i], keplerOrbitVBOs[i]);
     }
+    // N-body trails: rewritten from each snapshot, TRAIL_SAMPLES points per planet
+    GLuint trailVAO, trailVBO;
+    glGenVertexArrays(1, &trailVAO);
+    glGenBuffers(1, &trailVBO);
+    glBindVertexArray(trailVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, trailVBO);
+    glBufferData(GL_ARRAY_BUFFER, planets.size() * TRAIL_SAMPLES * 3 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(float),(void*)0);
+    glBindVertexArray(0);
 
     cam.distance = 12.0f; cam.yaw = glm::radians(90.0f); cam.pitch = glm::radians(-10.0f);
     cam.flyPos = glm::vec3(0.0f, 0.0f, 12.0f);
@@ -642,6 +921,21 @@ int main() {
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
+        if (replaying) {
+            if (simulationRunning) {
+                replayTime += ticksFromSeconds((double)dtReal * timeMultiplier);
+                replayTime = std::min(std::max(replayTime, replay.startTime()), replay.endTime());
+            }
+            const SimTicks t = replay.frameAt(replayTime, replaySnap.px.data(), replaySnap.py.data(),
+                                              replaySnap.pz.data(), replayLayout.rotationAngle.data());
+            modelMatrices(replayLayout, replaySnap.px.data(), replaySnap.py.data(), replaySnap.pz.data(),
+                          replaySnap.model.data());
+            replaySnap.time = replaySnap.renderTime = t;
+            replaySnap.timeDays = replaySnap.renderDays = ticksToDays(t);
+        }
+        const SimSnapshot &snap = replaying ? replaySnap : sim.latest();
+        simulatedTime = snap.time;
+
         // === ImGui панели ===
         ImGui::Begin("Focus");
         const char* planetNames[] = {"Sun","Mercury","Venus","Earth","Mars","Jupiter","Saturn","Uranus","Neptune"};
@@ -652,58 +946,354 @@ int main() {
         }
         ImGui::End();
 
+        if (replaying) {
+            ImGui::Begin("Replay");
+            ImGui::Text("%s: %zu frames", replayPath.c_str(), replay.frameCount());
+            float replayDays = (float)ticksToDays(replayTime);
+            if (ImGui::SliderFloat("Day", &replayDays, (float)ticksToDays(replay.startTime()),
+                                   (float)ticksToDays(replay.endTime()), "%.2f")) {
+                replayTime = ticksFromDays(replayDays);
+            }
+            ImGui::End();
+        }
+
         ImGui::Begin("Simulation");
         if(ImGui::Button(simulationRunning?"Pause":"Start")) simulationRunning=!simulationRunning;
         ImGui::SameLine(); 
         if(ImGui::Button("Reset")) {
-            simulatedTimeDays=0.0f; 
-            for(auto &p:planets){
-                p.orbitAngle=0.0f;
-                p.rotationAngle=0.0f;
-                for(auto &m:p.moons){
-                    m.orbitAngle=0.0f;
-                    m.rotationAngle=0.0f;
+            jumpToTicks(0);
+        }
+        ImGui::SliderFloat("Speed",&timeMultiplier,0.1f,315360000.f,"%.0fx",ImGuiSliderFlags_Logarithmic);
+        ImGui::Checkbox("Closed-form time", &closedFormTime);
+        const char* orbitModelNames[] = {"Circular", "Keplerian", "N-body", "Ephemeris", "JPL DE", "VSOP87"};
+        ImGui::Combo("Orbits", &orbitModel, orbitModelNames, 6);
+        if (orbitModel == ORBIT_EPHEMERIS) {
+            if (sim.ephemeris().valid()) {
+                ImGui::Text("Ephemeris: days %.0f..%.0f%s", sim.ephemeris().startDays(), sim.ephemeris().endDays(),
+                            snap.ephemerisCovered ? "" : " (outside, using Kepler)");
+                // every position is a table lookup, so dragging across centuries costs nothing
+                if (ImGui::SliderFloat("Scrub (years)", &scrubYears, (float)(sim.ephemeris().startDays() / 365.25),
+                                       (float)(sim.ephemeris().endDays() / 365.25), "%.1f")) {
+                    jumpToTicks(ticksFromDays(scrubYears * 365.25));
                 }
+            } else {
+                ImGui::Text("No ephemeris file, using Kepler");
             }
         }
-        ImGui::SliderFloat("Speed",&timeMultiplier,0.1f,315360000.f,"%.0fx",ImGuiSliderFlags_Logarithmic);
-        std::string simTimeStr=formatSimulatedTime(simulatedTimeDays);
+        if (orbitModel == ORBIT_JPL_DE) {
+            if (sim.jplEphemeris().valid()) {
+                ImGui::Text("DE%d: days %.0f..%.0f%s", sim.jplEphemeris().version(), sim.jplEphemeris().startDays(),
+                            sim.jplEphemeris().endDays(), snap.ephemerisCovered ? "" : " (outside, using Kepler)");
+            } else {
+                ImGui::Text("No DE file (--de <file>), using Kepler");
+            }
+        }
+        if (orbitModel == ORBIT_VSOP87) {
+            if (sim.vsop87().valid()) {
+                const char* levelNames[] = {"Full", "1e-9 AU", "1e-8 AU", "1e-7 AU", "1e-6 AU", "1e-5 AU"};
+                ImGui::Combo("Truncation", &vsopLevel, levelNames, VSOP87_LEVELS);
+                ImGui::Text("%zu terms per epoch", sim.vsop87().termCount(vsopLevel));
+            } else {
+                ImGui::Text("No VSOP87A files (--vsop87 <dir>), showing circular orbits");
+            }
+        }
+        if (orbitModel == ORBIT_NBODY) {
+            const char* integratorNames[] = {"Leapfrog", "Yoshida 4", "Wisdom-Holman", "DOP853"};
+            ImGui::Combo("Integrator", &nbodyIntegrator, integratorNames, 4);
+            ImGui::Checkbox("Barnes-Hut", &barnesHut);
+            if (barnesHut) ImGui::SliderFloat("Opening angle", &theta, 0.1f, 1.2f, "%.2f");
+            ImGui::Text("N-body: %.0f steps/s, energy drift %.2e", snap.nbodyStepsPerSec, snap.energyDrift);
+            ImGui::Text("Steps %lld (rejected %lld), force evals %lld", snap.nbodySteps, snap.nbodyRejected,
+                        snap.nbodyForceEvals);
+            ImGui::Checkbox("Trails", &showTrails);
+            // rewinding restores the nearest checkpoint and integrates the gap again
+            ImGui::SliderFloat("Checkpoint every (days)", &checkpointDays, 1.0f, 3650.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+            ImGui::SliderInt("Checkpoint memory (MB)", &checkpointBudgetMB, 1, 1024, "%d", ImGuiSliderFlags_Logarithmic);
+            ImGui::Text("Checkpoints: %zu, %.2f MB (%.2fx), days %.0f..%.0f", snap.checkpoints,
+                        snap.checkpointBytes / 1048576.0, snap.checkpointRatio, snap.checkpointOldest, snap.checkpointNewest);
+            if (snap.checkpoints > 0 && snap.renderDays > snap.checkpointOldest) {
+                if (ImGui::SliderFloat("Rewind (days)", &rewindDays, (float)snap.checkpointOldest, (float)snap.renderDays, "%.1f")) {
+                    sim.jumpTo((double)rewindDays);
+                }
+                // follow the clock unless the slider is being dragged
+                if (!ImGui::IsItemActive()) rewindDays = (float)snap.renderDays;
+            }
+            ImGui::Text("Last rewind: from day %.1f, %.1f days re-integrated in %.2f ms", snap.rewindFromDays,
+                        snap.rewindGapDays, snap.rewindMs);
+        }
+        ImGui::InputDouble("Day", &jumpDay, 1.0, 365.0, "%.2f");
+        ImGui::SameLine();
+        if(ImGui::Button("Jump")) {
+            jumpToTicks(ticksFromDays(jumpDay));
+        }
+        std::string simTimeStr=formatSimulatedTime(simulatedTime);
         ImGui::Text("Simulated Time: %s",simTimeStr.c_str());
+        int64_t jdDay; double jdFraction;
+        ticksToJulian(simulatedTime, jdDay, jdFraction);
+        ImGui::Text("%s TT, JD %lld + %.6f", formatCalendar(simulatedTime).c_str(), (long long)jdDay, jdFraction);
+        ImGui::SliderInt("Substep budget", &substepBudget, 10, 10000, "%d", ImGuiSliderFlags_Logarithmic);
+        ImGui::Text("Substeps: %d x %.0f s, dropped %.1f days", snap.substeps, snap.stepSeconds, snap.droppedSeconds/86400.0);
+        ImGui::Checkbox("Block timesteps", &blockSteps);
+        ImGui::Text("Body updates: %zu this tick (%zu without blocks)", snap.bodyUpdates,
+                    (size_t)snap.substeps * bodyLayout.size());
+        ImGui::Checkbox("Simulation LOD", &simLod);
+        if (simLod) {
+            ImGui::SliderFloat("Full-rate size (px)", &lodMinPixels, 1.0f, 200.0f, "%.0f");
+            ImGui::SliderFloat("LOD budget (ms)", &lodBudgetMs, 0.05f, 4.0f, "%.2f");
+            ImGui::Text("LOD: %zu full, %zu refreshed (%zu systems deferred), %zu frozen, %.3f ms",
+                        snap.lodFull, snap.lodRefreshed, snap.lodDeferred, snap.lodFrozen, snap.lodMs);
+        }
+        ImGui::Text("Sim thread: %.2f ms/tick", snap.tickMs);
+        if (!replaying) {
+            if (ImGui::Button(snap.recording ? "Stop recording" : "Record")) {
+                sim.record(snap.recording ? std::string() : recordFile);
+            }
+            if (snap.recording) {
+                ImGui::SameLine();
+                ImGui::Text("%s: %zu frames, %.2f MB", recordFile.c_str(), snap.recordedFrames,
+                            snap.recordedBytes / 1048576.0);
+            }
+        }
+        ImGui::End();
+
+        ImGui::Begin("Events");
+        {
+            const bool searching = eventSearch.valid();
+            if (searching && eventSearch.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                eventIndex.assign(eventSearch.get());
+            }
+            ImGui::InputInt("From year", &eventFromYear, 10, 100);
+            ImGui::InputInt("To year", &eventToYear, 10, 100);
+            ImGui::BeginDisabled(searching);
+            if (ImGui::Button(searching ? "Searching..." : "Search") && eventToYear > eventFromYear) {
+                EventSearch es;
+                if (sim.jplEphemeris().valid()) es.de = &sim.jplEphemeris();
+                // calendar years to days from J2000 (2000-01-01 12:00)
+                const double from = ((eventFromYear - 2000) * 365.2425) - 0.5;
+                const double to = ((eventToYear - 2000) * 365.2425) - 0.5;
+                eventSearch = std::async(std::launch::async, [es, from, to]() {
+                    return es.search(from, to, &sharedThreadPool());
+                });
+            }
+            ImGui::EndDisabled();
+
+            uint32_t mask = 0;
+            for (int k = 0; k < EVENT_TYPES; ++k) {
+                if (k) ImGui::SameLine();
+                ImGui::Checkbox(eventTypeName((EventType)k), &eventTypes[k]);
+                if (eventTypes[k]) mask |= 1u << k;
+            }
+            auto jumpToEvent = [&](size_t i) {
+                if (i >= eventIndex.events().size()) return;
+                jumpToTicks(eventIndex.events()[i].time);
+            };
+            if (ImGui::Button("Previous")) jumpToEvent(eventIndex.previous(snap.time, mask));
+            ImGui::SameLine();
+            if (ImGui::Button("Next")) jumpToEvent(eventIndex.next(snap.time, mask));
+            ImGui::SameLine();
+            ImGui::Text("%zu events", eventIndex.events().size());
+
+            // upcoming events from the current time
+            if (ImGui::BeginListBox("##events", ImVec2(-1, 200))) {
+                int shown = 0;
+                for (size_t i = eventIndex.next(snap.time - 1, mask); i < eventIndex.events().size() && shown < 100; ++i) {
+                    const AstroEvent &e = eventIndex.events()[i];
+                    if (!(mask & (1u << e.type))) continue;
+                    std::string label = formatCalendar(e.time) + "  " + describeEvent(e);
+                    ImGui::PushID((int)i);
+                    if (ImGui::Selectable(label.c_str())) jumpToEvent(i);
+                    ImGui::PopID();
+                    ++shown;
+                }
+                ImGui::EndListBox();
+            }
+        }
         ImGui::End();
 
-        if(simulationRunning) simulatedTimeDays+=dtReal*timeMultiplier/86400.f;
-        float dtSim = dtReal * timeMultiplier;
-
-        for(size_t i = 0; i < planets.size(); ++i) {
-            Planet &p = planets[i];
-            p.orbitAngle += dtSim * p.orbitSpeed;
-            if(p.orbitAngle > 360.f) p.orbitAngle -= 360.f;
-            float oldRotation = p.rotationAngle;
-            p.rotationAngle += dtSim * p.rotationSpeed;
-            if(p.rotationAngle > 360.f) p.rotationAngle -= 360.f;
-            
-            static int debugPlanetFrameCount = 0;
-            if (debugPlanetFrameCount++ == 0 && i == 0) { 
-                std::cout << "=== DEBUG: Планета " << p.name << " rotationAngle обновлен: " << oldRotation 
-                          << " -> " << p.rotationAngle << " (dtSim=" << dtSim << ", speed=" << p.rotationSpeed << ")\n";
-                std::cout << "=== DEBUG: rotationAngle НЕ зависит от камеры, только от времени!\n";
+        ImGui::Begin("Porkchop");
+        {
+            const bool computing = porkchopJob.valid();
+            if (computing && porkchopJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                porkchop = porkchopJob.get();
+                porkchopDirty = true;
             }
+            ImGui::Combo("From", &porkchopFrom, porkchopBodies.data(), (int)porkchopBodies.size());
+            ImGui::Combo("To", &porkchopTo, porkchopBodies.data(), (int)porkchopBodies.size());
+            ImGui::InputInt("Departure year", &porkchopYear, 1, 10);
+            ImGui::InputInt("Departure span (days)", &porkchopSpan, 30, 365);
+            const char* gridNames[] = {"256 x 256", "1024 x 1024", "2048 x 2048"};
+            const size_t gridSteps[] = {256, 1024, 2048};
+            ImGui::Combo("Grid", &porkchopGridIdx, gridNames, 3);
+            ImGui::BeginDisabled(computing);
+            if (ImGui::Button(computing ? "Computing..." : "Compute") && porkchopFrom != porkchopTo && porkchopSpan > 0) {
+                const PorkchopSpec spec = porkchopWindow(porkchopFrom, porkchopTo, (porkchopYear - 2000) * 365.2425 - 0.5,
+                                                         porkchopSpan, gridSteps[porkchopGridIdx]);
+                porkchopJob = std::async(std::launch::async, [spec]() {
+                    return computePorkchop(spec, &sharedThreadPool());
+                });
+            }
+            ImGui::EndDisabled();
+
+            if (!porkchop.c3.empty()) {
+                const std::vector<float>* maps[3] = {&porkchop.c3, &porkchop.vInfArrive, &porkchop.deltaV};
+                const char* mapNames[] = {"Departure C3 (km^2/s^2)", "Arrival vInf (km/s)", "Total vInf (km/s)"};
+                if (ImGui::Combo("Map", &porkchopMap, mapNames, 3)) porkchopDirty = true;
+                if (ImGui::SliderFloat("Scale top", &porkchopTop[porkchopMap], 1.0f, 500.0f, "%.1f",
+                                       ImGuiSliderFlags_Logarithmic)) {
+                    porkchopDirty = true;
+                }
+                const std::vector<float>& map = *maps[porkchopMap];
+                if (porkchopDirty) {
+                    uploadHeatmap(porkchopTex, porkchop, map, porkchopTop[porkchopMap]);
+                    porkchopDirty = false;
+                }
+                const PorkchopSpec& ps = porkchop.spec;
+                ImGui::Text("%s -> %s, %zu cells in %.2f s", porkchopBodies[ps.from], porkchopBodies[ps.to], map.size(),
+                            porkchop.wallSeconds);
+                ImGui::Image((ImTextureID)(intptr_t)porkchopTex, ImVec2(400, 400));
+                if (ImGui::IsItemHovered()) {
+                    // cell under the mouse; the image's y axis is flipped
+                    const ImVec2 m = ImGui::GetMousePos(), o = ImGui::GetItemRectMin();
+                    const float u = std::max(0.0f, (m.x - o.x) / 400.0f), v = std::max(0.0f, 1.0f - (m.y - o.y) / 400.0f);
+                    const size_t i = std::min(ps.departSteps - 1, (size_t)(u * ps.departSteps));
+                    const size_t j = std::min(ps.arriveSteps - 1, (size_t)(v * ps.arriveSteps));
+                    const std::string dep = formatCalendar(ticksFromDays(ps.departDay(i))).substr(0, 10);
+                    const std::string arr = formatCalendar(ticksFromDays(ps.arriveDay(j))).substr(0, 10);
+                    ImGui::Text("Depart %s, arrive %s: %.2f", dep.c_str(), arr.c_str(), porkchop.at(map, i, j));
+                } else {
+                    ImGui::TextDisabled("Departure along x, arrival up y");
+                }
+                const size_t best = porkchop.minimum(map);
+                if (best < map.size()) {
+                    const std::string dep = formatCalendar(ticksFromDays(ps.departDay(best / ps.arriveSteps))).substr(0, 10);
+                    const std::string arr = formatCalendar(ticksFromDays(ps.arriveDay(best % ps.arriveSteps))).substr(0, 10);
+                    ImGui::Text("Best %.2f: depart %s, arrive %s", map[best], dep.c_str(), arr.c_str());
+                }
+                if (ImGui::Button("Save porkchop.bin")) porkchop.save("porkchop.bin");
+            }
+        }
+        ImGui::End();
 
-            for(auto &m : p.moons) {
-                m.orbitAngle += dtSim * m.orbitSpeed;
-                if(m.orbitAngle > 360.0f) m.orbitAngle -= 360.0f;
-                m.rotationAngle += dtSim * m.rotationSpeed;
-                if(m.rotationAngle > 360.0f) m.rotationAngle -= 360.0f;
+        ImGui::Begin("Gravity assist");
+        {
+            const bool searching = assistJob.valid();
+            if (searching && assistJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready) assistJob.get();
+            ImGui::Combo("From##assist", &assistFrom, porkchopBodies.data(), (int)porkchopBodies.size());
+            ImGui::Combo("To##assist", &assistTo, porkchopBodies.data(), (int)porkchopBodies.size());
+            ImGui::InputInt("Launch year", &assistYear, 1, 10);
+            ImGui::InputInt("Launch span (days)", &assistSpan, 30, 365);
+            ImGui::SliderInt("Max flybys", &assistFlybys, 0, 4);
+            for (size_t b = 0; b < porkchopBodies.size() && b < 8; ++b) {
+                if (b % 4) ImGui::SameLine();
+                ImGui::Checkbox(porkchopBodies[b], &assistVia[b]);
+            }
+            ImGui::BeginDisabled(searching);
+            if (ImGui::Button("Search##assist") && assistFrom != assistTo && assistSpan > 0) {
+                GravityAssistSpec spec;
+                spec.from = assistFrom;
+                spec.to = assistTo;
+                spec.maxFlybys = assistFlybys;
+                spec.flybyBodies.clear();
+                for (int b = 0; b < 8; ++b) {
+                    if (assistVia[b]) spec.flybyBodies.push_back(b);
+                }
+                spec.departStart = (assistYear - 2000) * 365.2425 - 0.5;
+                spec.departSpan = assistSpan;
+                spec.departSteps = (size_t)(assistSpan / 10) + 1;
+                assistJob = std::async(std::launch::async, [&assistSearch, spec]() {
+                    return assistSearch.run(spec, &sharedThreadPool());
+                });
+            }
+            ImGui::EndDisabled();
+            ImGui::SameLine();
+            ImGui::BeginDisabled(!searching);
+            if (ImGui::Button("Cancel##assist")) assistSearch.cancel();
+            ImGui::EndDisabled();
+            ImGui::ProgressBar(assistSearch.progress());
+            ImGui::Text("%llu legs, %llu pruned%s", (unsigned long long)assistSearch.legsSolved,
+                        (unsigned long long)assistSearch.pruned, assistSearch.wasCancelled() ? " (cancelled)" : "");
+
+            // best so far, live while searching; click an encounter to jump there
+            const GravityAssistPath best = assistSearch.best();
+            if (best.valid()) {
+                ImGui::Text("Best: %.3f km/s", best.total);
+                for (size_t k = 0; k < best.bodies.size(); ++k) {
+                    std::string label = formatCalendar(ticksFromDays(best.days[k])).substr(0, 10) + "  "
+                                        + porkchopBodies[best.bodies[k]] + "  " + std::to_string(best.deltaV[k]) + " km/s";
+                    ImGui::PushID((int)k);
+                    if (ImGui::Selectable(label.c_str())) {
+                        jumpToTicks(ticksFromDays(best.days[k]));
+                    }
+                    ImGui::PopID();
+                }
             }
         }
+        ImGui::End();
 
+        ImGui::Begin("Spacecraft");
+        ImGui::Checkbox("Show##craft", &showCraft);
+        ImGui::Combo("From##craft", &craftFrom, porkchopBodies.data(), (int)porkchopBodies.size());
+        ImGui::SliderInt("Count##craft", &craftCount, 1, 500);
+        ImGui::SliderFloat("Min v-inf (km/s)", &craftVMin, 0.1f, 30.0f);
+        ImGui::SliderFloat("Max v-inf (km/s)", &craftVMax, 0.1f, 30.0f);
+        if (ImGui::Button("Launch")) {
+            sim.launchSpacecraft(craftFrom, (size_t)craftCount, craftVMin, std::max(craftVMin, craftVMax));
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear##craft")) sim.clearSpacecraft();
+        ImGui::Text("%zu craft, %zu launched so far", snap.craft.size() / 4, snap.craftCount);
+        ImGui::Text("Update: %.3f ms, %zu SOI switches, %zu event searches", snap.craftUpdateMs, snap.craftSwitches,
+                    snap.craftSearched);
+        ImGui::TextDisabled("Yellow: about the Sun, cyan: a planet, pink: a moon");
+        ImGui::End();
+
+        ImGui::Begin("Satellites");
+        if (snap.satCount == 0 && sim.satellites().size() == 0) {
+            ImGui::Text("No TLE catalogue (--tle <file>)");
+        } else {
+            ImGui::Checkbox("Show##sats", &showSatellites);
+            ImGui::SliderFloat("Point size", &satPointSize, 1.0f, 6.0f);
+            ImGui::Text("%zu objects, %zu deep space (SDP4)", snap.satCount, snap.satDeep);
+            ImGui::Text("%zu decayed, %zu rejected at load", snap.satLost, snap.satRejected);
+            ImGui::Text("Update: %.2f ms (%s, %u threads)", snap.satUpdateMs, simdLevelName(sim.satellites().level),
+                        sharedThreadPool().size());
+            ImGui::TextDisabled("Green LEO, orange MEO, red GEO, violet beyond");
+        }
+        ImGui::End();
+
+        ImGui::Begin("Asteroid belt");
+        ImGui::Checkbox("Show", &showBelt);
+        const char* beltCountNames[] = {"10k", "100k", "1M"};
+        ImGui::Combo("Asteroids", &beltCountIdx, beltCountNames, 3);
+        ImGui::Text("Update: %.2f ms (%s, %u threads)", snap.beltUpdateMs, simdLevelName(detectSimdLevel()), sharedThreadPool().size());
+        ImGui::Text("Draw: %.2f ms upload+submit, %.2f ms GPU", beltSubmitMs, beltGpuMs);
+        ImGui::End();
+
+        SimControls simCtl;
+        simCtl.running = simulationRunning;
+        simCtl.timeMultiplier = timeMultiplier;
+        simCtl.closedForm = closedFormTime;
+        simCtl.orbitModel = orbitModel;
+        simCtl.integrator = (Integrator)nbodyIntegrator;
+        simCtl.barnesHut = barnesHut;
+        simCtl.theta = theta;
+        simCtl.substepBudget = substepBudget;
+        simCtl.showBelt = showBelt;
+        simCtl.showSatellites = showSatellites;
+        simCtl.vsopLevel = vsopLevel;
+        simCtl.showTrails = showTrails;
+        simCtl.checkpointDays = checkpointDays;
+        simCtl.checkpointBudgetMB = (size_t)checkpointBudgetMB;
+        simCtl.blockSteps = blockSteps;
+        simCtl.beltCount = (size_t)beltCounts[beltCountIdx];
+        simCtl.simLod = simLod;
+        simCtl.focusBody = selectedPlanetIndex;
+        simCtl.lodBudgetMs = lodBudgetMs;
 
         // === CAMERA TARGET ===
+        // Positions are the interpolated state published by the sim thread.
         if (selectedPlanetIndex >= 0 && selectedPlanetIndex < (int)planets.size()) {
-            Planet& p = planets[selectedPlanetIndex];
-            float angRad = glm::radians(p.orbitAngle);
-            glm::vec3 planetCenter(cosf(angRad) * p.orbitRadius, 0.f, sinf(angRad) * p.orbitRadius);
-            cam.setTarget(planetCenter); 
+            cam.setTarget(glm::vec3(snap.px[selectedPlanetIndex], snap.py[selectedPlanetIndex], snap.pz[selectedPlanetIndex])); 
         } else {
             cam.setTarget(glm::vec3(0.0f)); 
         }
@@ -715,6 +1305,14 @@ int main() {
         glm::mat4 proj = glm::perspective(glm::radians(45.0f),(float)SCR_W/(float)SCR_H,0.1f,200.0f);
         glm::mat4 view = cam.view();  
         glm::vec3 camPos = cam.pos();
+
+        // === SIMULATION LOD ===
+        // Tiers from this frame's camera; the sim thread picks them up next tick.
+        glm::mat4 viewProj = proj * view;
+        classifySystems(bodyLayout, snap.px.data(), snap.py.data(), snap.pz.data(), glm::value_ptr(viewProj),
+                        0.5f * (float)SCR_H * proj[1][1], lodMinPixels, systemLod.data());
+        simCtl.systemLod = systemLod;
+        sim.setControls(simCtl);
         
         glm::vec3 sunPos = glm::vec3(0.0f, 0.0f, 0.0f);
 
@@ -765,8 +1363,18 @@ int main() {
             glUniformMatrix4fv(glGetUniformLocation(planetProg,"view"),1,GL_FALSE,glm::value_ptr(view));
             glUniformMatrix4fv(glGetUniformLocation(planetProg,"projection"),1,GL_FALSE,glm::value_ptr(proj));
 
-            glBindVertexArray(orbitVAOs[i]);
-            glDrawArrays(GL_LINE_STRIP, 0, orbitVertexCounts[i]);
+            bool elliptic = orbitModel != ORBIT_CIRCULAR;
+            glBindVertexArray(elliptic ? keplerOrbitVAOs[i] : orbitVAOs[i]);
+            glDrawArrays(GL_LINE_STRIP, 0, elliptic ? keplerOrbitVertexCounts[i] : orbitVertexCounts[i]);
+            glBindVertexArray(0);
+        }
+        if (!snap.trail.empty()) {
+            glBindBuffer(GL_ARRAY_BUFFER, trailVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, snap.trail.size() * sizeof(float), snap.trail.data());
+            glBindVertexArray(trailVAO);
+            for (size_t i = 0; i < snap.trailLength.size(); ++i) {
+                glDrawArrays(GL_LINE_STRIP, (GLint)(i * TRAIL_SAMPLES), (GLsizei)snap.trailLength[i]);
+            }
             glBindVertexArray(0);
         }
 
@@ -791,60 +1399,30 @@ int main() {
             glUniform3f(planetViewPosLoc, camPos.x, camPos.y, camPos.z);
         }
         
-        for(auto &p:planets) {
-            float angRad=glm::radians(p.orbitAngle);
-            glm::vec3 planetPos(cosf(angRad)*p.orbitRadius,0.f,sinf(angRad)*p.orbitRadius);
-
-            glm::mat4 pModel = glm::mat4(1.0f);
-            pModel = glm::translate(pModel, planetPos);  
-            pModel = glm::rotate(pModel, glm::radians(-90.0f), glm::vec3(1.0f,0.0f,0.0f)); 
-            pModel = glm::rotate(pModel, glm::radians(p.axialTilt), glm::vec3(0.0f,1.0f,0.0f)); 
-            pModel = glm::rotate(pModel, glm::radians(p.rotationAngle), glm::vec3(0.0f,0.0f,1.0f)); 
-            pModel = glm::scale(pModel, glm::vec3(p.size));
-
-            if (planetModelLoc >= 0) glUniformMatrix4fv(planetModelLoc, 1, GL_FALSE, glm::value_ptr(pModel));
-            if (planetViewLoc >= 0) glUniformMatrix4fv(planetViewLoc, 1, GL_FALSE, glm::value_ptr(view));
-            if (planetProjLoc >= 0) glUniformMatrix4fv(planetProjLoc, 1, GL_FALSE, glm::value_ptr(proj));
-                    
-            if (planetAmbientKLoc >= 0) {
-                glUniform1f(planetAmbientKLoc, 0.10f); 
-            }
-                    
-            if (planetTexLoc >= 0) glUniform1i(planetTexLoc, 0);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, p.texture); 
-            glBindVertexArray(planetVAO);
-            glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
-
-
-
-            // === MOONS ===
-            for (auto &m : p.moons) {
-                float moonAngRad = glm::radians(m.orbitAngle);
-                glm::vec3 moonPos = planetPos + glm::vec3(cosf(moonAngRad) * m.orbitRadius, 0.0f, sinf(moonAngRad) * m.orbitRadius);
-
-                glm::mat4 moonModel = glm::mat4(1.0f);
-                moonModel = glm::translate(moonModel, moonPos);
-                moonModel = glm::rotate(moonModel, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f)); 
-                moonModel = glm::rotate(moonModel, glm::radians(m.rotationAngle), glm::vec3(0.0f, 0.0f, 1.0f)); 
-                moonModel = glm::scale(moonModel, glm::vec3(m.size));
-
-                if (planetModelLoc >= 0) glUniformMatrix4fv(planetModelLoc, 1, GL_FALSE, glm::value_ptr(moonModel));
+        if (planetViewLoc >= 0) glUniformMatrix4fv(planetViewLoc, 1, GL_FALSE, glm::value_ptr(view));
+        if (planetProjLoc >= 0) glUniformMatrix4fv(planetProjLoc, 1, GL_FALSE, glm::value_ptr(proj));
+        if (planetAmbientKLoc >= 0) glUniform1f(planetAmbientKLoc, 0.10f);
+        if (planetTexLoc >= 0) glUniform1i(planetTexLoc, 0);
+        glActiveTexture(GL_TEXTURE0);
 
+        // model matrices come ready-made from the snapshot, one per body
+        glBindVertexArray(planetVAO);
+        for (size_t bi = 0; bi < bodyLayout.size(); ++bi) {
+            if (planetModelLoc >= 0) glUniformMatrix4fv(planetModelLoc, 1, GL_FALSE, &snap.model[16 * bi]);
+            glBindTexture(GL_TEXTURE_2D, bodyTextures[bi]);
+            glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
+        }
+        glBindVertexArray(0);
 
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, m.texture);
-                glBindVertexArray(planetVAO);
-                glDrawElements(GL_TRIANGLES, sphereIndexCount, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-            }       
+        for (size_t pi = 0; pi < bodyLayout.rootCount; ++pi) {
+            const PlanetVisual &pv = visuals[pi];
+            glm::vec3 planetPos(snap.px[pi], snap.py[pi], snap.pz[pi]);
 
             // === SATURN RING ===
-            if (p.hasRing && ringVAO && p.ringTex) {
+            if (bodyLayout.info[pi].hasRing && ringVAO && pv.ringTex) {
                 glm::mat4 rModel=glm::translate(glm::mat4(1.0f),planetPos);
                 rModel = glm::rotate(rModel, glm::radians(26.7f), glm::vec3(1.0f,0.0f,0.0f));
-                rModel = glm::scale(rModel, glm::vec3(p.size*2.0f));
+                rModel = glm::scale(rModel, glm::vec3(bodyLayout.bodySize[pi]*2.0f));
 
                 if (planetModelLoc >= 0) glUniformMatrix4fv(planetModelLoc, 1, GL_FALSE, glm::value_ptr(rModel));
                 if (planetViewLoc >= 0) glUniformMatrix4fv(planetViewLoc, 1, GL_FALSE, glm::value_ptr(view));
@@ -854,7 +1432,7 @@ int main() {
                 glEnable(GL_BLEND);
                 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
                 glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D,p.ringTex);
+                glBindTexture(GL_TEXTURE_2D,pv.ringTex);
                 glBindVertexArray(ringVAO); 
                 glDrawElements(GL_TRIANGLES, ringIndexCount, GL_UNSIGNED_INT, 0); 
                 glBindVertexArray(0);
@@ -862,11 +1440,94 @@ int main() {
             }
         }
 
+        // === 5. ASTEROID BELT ===
+        if (showBelt && !snap.beltX.empty()) {
+            const size_t n = snap.beltX.size();
+            if (n != beltAllocated) allocBeltBuffer(n);
+
+            // the GPU time of an earlier frame is read back once it is available
+            if (beltQueryPending) {
+                GLint available = 0;
+                glGetQueryObjectiv(beltQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available) {
+                    GLuint64 ns = 0;
+                    glGetQueryObjectui64v(beltQuery, GL_QUERY_RESULT, &ns);
+                    beltGpuMs = ns / 1.0e6;
+                    beltQueryPending = false;
+                }
+            }
+            bool timing = !beltQueryPending;
+            if (timing) glBeginQuery(GL_TIME_ELAPSED, beltQuery);
+
+            double t0 = glfwGetTime();
+            glBindBuffer(GL_ARRAY_BUFFER, beltInstanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, 3*n*sizeof(float), NULL, GL_STREAM_DRAW);   // orphan last frame's data
+            glBufferSubData(GL_ARRAY_BUFFER, 0, n*sizeof(float), snap.beltX.data());
+            glBufferSubData(GL_ARRAY_BUFFER, n*sizeof(float), n*sizeof(float), snap.beltY.data());
+            glBufferSubData(GL_ARRAY_BUFFER, 2*n*sizeof(float), n*sizeof(float), snap.beltZ.data());
+
+            glUseProgram(asteroidProg);
+            glUniformMatrix4fv(glGetUniformLocation(asteroidProg,"view"),1,GL_FALSE,glm::value_ptr(view));
+            glUniformMatrix4fv(glGetUniformLocation(asteroidProg,"projection"),1,GL_FALSE,glm::value_ptr(proj));
+            glUniform2f(glGetUniformLocation(asteroidProg,"beltAU"), snap.beltMinAU, snap.beltMaxAU);
+            glUniform2f(glGetUniformLocation(asteroidProg,"beltScene"), planets[3].orbitRadius + 0.1f, planets[4].orbitRadius - 0.1f);
+            glUniform1f(glGetUniformLocation(asteroidProg,"size"), 0.012f);
+            glUniform3f(glGetUniformLocation(asteroidProg,"lightPos"), sunPos.x, sunPos.y, sunPos.z);
+            glUniform1f(glGetUniformLocation(asteroidProg,"ambientK"), 0.10f);
+            glBindVertexArray(rockVAO);
+            glDrawElementsInstanced(GL_TRIANGLES, rockIndexCount, GL_UNSIGNED_INT, 0, (GLsizei)n);
+            glBindVertexArray(0);
+            beltSubmitMs = (glfwGetTime() - t0) * 1000.0;
+
+            if (timing) {
+                glEndQuery(GL_TIME_ELAPSED);
+                beltQueryPending = true;
+            }
+        }
+
+        // === 6. SPACECRAFT ===
+        if (showCraft && !snap.craft.empty()) {
+            glBindBuffer(GL_ARRAY_BUFFER, craftInstanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, snap.craft.size()*sizeof(float), snap.craft.data(), GL_STREAM_DRAW);
+            glUseProgram(craftProg);
+            glUniformMatrix4fv(glGetUniformLocation(craftProg,"view"),1,GL_FALSE,glm::value_ptr(view));
+            glUniformMatrix4fv(glGetUniformLocation(craftProg,"projection"),1,GL_FALSE,glm::value_ptr(proj));
+            glUniform1f(glGetUniformLocation(craftProg,"size"), 0.004f);
+            glBindVertexArray(craftVAO);
+            glDrawElementsInstanced(GL_TRIANGLES, rockIndexCount, GL_UNSIGNED_INT, 0, (GLsizei)(snap.craft.size() / 4));
+            glBindVertexArray(0);
+        }
+
+        // === 7. EARTH SATELLITES ===
+        if (showSatellites && !snap.satX.empty()) {
+            const size_t n = snap.satX.size();
+            if (n != satAllocated) allocSatBuffer(n);
+            glBindBuffer(GL_ARRAY_BUFFER, satInstanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, 3*n*sizeof(float), NULL, GL_STREAM_DRAW);   // orphan last frame's data
+            glBufferSubData(GL_ARRAY_BUFFER, 0, n*sizeof(float), snap.satX.data());
+            glBufferSubData(GL_ARRAY_BUFFER, n*sizeof(float), n*sizeof(float), snap.satY.data());
+            glBufferSubData(GL_ARRAY_BUFFER, 2*n*sizeof(float), n*sizeof(float), snap.satZ.data());
+
+            const float tilt = glm::radians((float)bodyLayout.axialTilt[earthIndex]);
+            glUseProgram(satProg);
+            glUniformMatrix4fv(glGetUniformLocation(satProg,"view"),1,GL_FALSE,glm::value_ptr(view));
+            glUniformMatrix4fv(glGetUniformLocation(satProg,"projection"),1,GL_FALSE,glm::value_ptr(proj));
+            glUniform3f(glGetUniformLocation(satProg,"centre"), snap.px[earthIndex], snap.py[earthIndex], snap.pz[earthIndex]);
+            glUniform1f(glGetUniformLocation(satProg,"kmScale"), bodyLayout.bodySize[earthIndex] / (float)SGP4_EARTH_RADIUS_KM);
+            glUniform2f(glGetUniformLocation(satProg,"tilt"), std::sin(tilt), std::cos(tilt));
+            glUniform1f(glGetUniformLocation(satProg,"pointSize"), satPointSize);
+            glBindVertexArray(satVAO);
+            glDrawArraysInstanced(GL_POINTS, 0, 1, (GLsizei)n);
+            glBindVertexArray(0);
+        }
+
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         glfwSwapBuffers(window);
-    }   
-
+    }
+    sim.stop();
+    assistSearch.cancel();
+    if (assistJob.valid()) assistJob.wait();
 
     // --- cleanup ---
     ImGui_ImplOpenGL3_Shutdown(); ImGui_ImplGlfw_Shutdown(); ImGui::DestroyContext();
@@ -875,8 +1536,16 @@ int main() {
     if (ringVAO) { glDeleteVertexArrays(1,&ringVAO); glDeleteBuffers(1,&ringVBO); glDeleteBuffers(1,&ringEBO);}
     for(auto vao:orbitVAOs) glDeleteVertexArrays(1,&vao);
     for(auto vbo:orbitVBOs) glDeleteBuffers(1,&vbo);
+    for(auto vao:keplerOrbitVAOs) glDeleteVertexArrays(1,&vao);
+    for(auto vbo:keplerOrbitVBOs) glDeleteBuffers(1,&vbo);
+    glDeleteVertexArrays(1,&trailVAO); glDeleteBuffers(1,&trailVBO);
     glDeleteVertexArrays(1,&skyVAO); glDeleteBuffers(1,&skyVBO);
-    glDeleteProgram(planetProg); glDeleteProgram(skyProg);
+    glDeleteVertexArrays(1,&rockVAO); glDeleteBuffers(1,&rockVBO); glDeleteBuffers(1,&rockEBO); glDeleteBuffers(1,&beltInstanceVBO);
+    glDeleteVertexArrays(1,&craftVAO); glDeleteBuffers(1,&craftInstanceVBO);
+    glDeleteVertexArrays(1,&satVAO); glDeleteBuffers(1,&satInstanceVBO);
+    glDeleteQueries(1,&beltQuery);
+    if (porkchopTex) glDeleteTextures(1,&porkchopTex);
+    glDeleteProgram(planetProg); glDeleteProgram(skyProg); glDeleteProgram(asteroidProg); glDeleteProgram(craftProg); glDeleteProgram(satProg);
     GLuint texs[]={sunTex,texMercury,texVenus,texEarth,texMars,texJupiter,texSaturn,texUranus,texNeptune,texSaturnRing,cubemap,texMoon};
     for(auto t:texs) if(t) glDeleteTextures(1,&t);
     glfwTerminate();
@@ -0,0 +1,48 @@
+// src/sim/asteroid_belt.cpp
+#include "asteroid_belt.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+AsteroidBelt::AsteroidBelt(ThreadPool* pool) {
+    prop.pool = pool;
+}
+
+// 4:1, 3:1, 5:2, 7:3, 2:1 resonances with Jupiter
+static bool inKirkwoodGap(double a) {
+    const double gaps[] = {2.06, 2.50, 2.82, 2.95, 3.27};
+    for (double g : gaps) {
+        if (std::fabs(a - g) < 0.02) return true;
+    }
+    return false;
+}
+
+std::vector<OrbitalElements> AsteroidBelt::orbits(size_t count, unsigned seed) const {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> ua(innerAU, outerAU), uang(0.0, TWO_PI);
+    std::normal_distribution<double> ne(0.1, 0.06), ni(0.0, 0.15);
+
+    std::vector<OrbitalElements> out;
+    out.reserve(count);
+    for (size_t k = 0; k < count; ++k) {
+        double a;
+        do { a = ua(rng); } while (inKirkwoodGap(a));
+        double e = std::fmin(std::fabs(ne(rng)), maxEccentricity);
+        double i = std::fabs(ni(rng));
+        out.push_back({a, e, i, uang(rng), uang(rng), uang(rng), 0.0});
+    }
+    return out;
+}
+
+void AsteroidBelt::generate(size_t count, unsigned seed) {
+    prop.clear();
+    for (const OrbitalElements& el : orbits(count, seed)) prop.add(el);
+}
+
+void AsteroidBelt::update(double tDays) {
+    auto t0 = std::chrono::steady_clock::now();
+    prop.propagate(tDays);
+    auto t1 = std::chrono::steady_clock::now();
+    lastUpdateMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
@@ -0,0 +1,38 @@
+// src/sim/asteroid_belt.h
+// Main-belt asteroid population: random heliocentric orbits between Mars and
+// Jupiter propagated every frame by the SoA Kepler kernels.
+#pragma once
+
+#include "kepler.h"
+
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+class AsteroidBelt {
+public:
+    explicit AsteroidBelt(ThreadPool* pool = nullptr);
+
+    // Replace the population with `count` bodies (a in [innerAU, outerAU],
+    // Kirkwood gaps left empty). Deterministic for a given seed.
+    void generate(size_t count, unsigned seed = 2024);
+    // The elements generate() would add, e.g. as a catalogue for screening.
+    std::vector<OrbitalElements> orbits(size_t count, unsigned seed = 2024) const;
+    void update(double tDays);
+
+    size_t size() const { return prop.size(); }
+    const float* x() const { return prop.x(); }
+    const float* y() const { return prop.y(); }
+    const float* z() const { return prop.z(); }
+
+    KeplerPropagator prop;
+    double innerAU = 2.1;
+    double outerAU = 3.3;
+    double maxEccentricity = 0.25;
+
+    // Heliocentric distance range the population can reach.
+    double minRadius() const { return innerAU * (1.0 - maxEccentricity); }
+    double maxRadius() const { return outerAU * (1.0 + maxEccentricity); }
+    double lastUpdateMs = 0.0;
+};
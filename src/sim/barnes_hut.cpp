@@ -0,0 +1,376 @@
+// src/sim/barnes_hut.cpp
+#include "barnes_hut.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static const int MORTON_LEVELS = 21;   // bits per axis in a 63-bit key
+
+static uint64_t spreadBits(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+    v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2)  & 0x1249249249249249ULL;
+    return v;
+}
+
+static inline unsigned octant(uint64_t code, int level) {
+    return (unsigned)(code >> (3 * (MORTON_LEVELS - 1 - level))) & 7u;
+}
+
+static void runParallel(ThreadPool* pool, size_t count, size_t grain,
+                        const std::function<void(size_t, size_t)>& fn) {
+    if (pool) pool->parallelFor(count, grain, fn);
+    else fn(0, count);
+}
+
+void radixSortPairs(std::vector<uint64_t>& keys, std::vector<uint32_t>& vals, ThreadPool* pool) {
+    const size_t n = keys.size();
+    const size_t chunks = (pool && n >= 65536) ? pool->size() : 1;
+    const size_t chunkLen = (n + chunks - 1) / chunks;
+    std::vector<uint64_t> tmpK(n);
+    std::vector<uint32_t> tmpV(n);
+    std::vector<size_t> hist(chunks * 256);
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        std::fill(hist.begin(), hist.end(), 0);
+        runParallel(pool, chunks, 1, [&](size_t cb, size_t ce) {
+            for (size_t c = cb; c < ce; ++c) {
+                size_t* h = &hist[c * 256];
+                size_t end = std::min(n, (c + 1) * chunkLen);
+                for (size_t k = c * chunkLen; k < end; ++k) ++h[(keys[k] >> shift) & 0xff];
+            }
+        });
+
+        // every key has the same digit: the pass would be a plain copy
+        bool trivial = false;
+        for (size_t d = 0; d < 256 && !trivial; ++d) {
+            size_t total = 0;
+            for (size_t c = 0; c < chunks; ++c) total += hist[c * 256 + d];
+            trivial = total == n;
+        }
+        if (trivial) continue;
+
+        size_t running = 0;
+        for (size_t d = 0; d < 256; ++d) {
+            for (size_t c = 0; c < chunks; ++c) {
+                size_t cnt = hist[c * 256 + d];
+                hist[c * 256 + d] = running;
+                running += cnt;
+            }
+        }
+        runParallel(pool, chunks, 1, [&](size_t cb, size_t ce) {
+            for (size_t c = cb; c < ce; ++c) {
+                size_t* off = &hist[c * 256];
+                size_t end = std::min(n, (c + 1) * chunkLen);
+                for (size_t k = c * chunkLen; k < end; ++k) {
+                    size_t dst = off[(keys[k] >> shift) & 0xff]++;
+                    tmpK[dst] = keys[k];
+                    tmpV[dst] = vals[k];
+                }
+            }
+        });
+        keys.swap(tmpK);
+        vals.swap(tmpV);
+    }
+}
+
+bool BarnesHutTree::isLeaf(uint32_t begin, uint32_t end, int level) const {
+    return end - begin <= leafSize || level >= MORTON_LEVELS;
+}
+
+int BarnesHutTree::childRanges(uint32_t begin, uint32_t end, int level, Range out[8]) const {
+    int count = 0;
+    uint32_t cb = begin;
+    for (unsigned d = 0; d < 8 && cb < end; ++d) {
+        auto it = std::partition_point(codes.begin() + cb, codes.begin() + end,
+                                       [&](uint64_t c) { return octant(c, level) <= d; });
+        uint32_t ce = (uint32_t)(it - codes.begin());
+        if (ce > cb) out[count++] = {cb, ce, level + 1};
+        cb = ce;
+    }
+    return count;
+}
+
+void BarnesHutTree::finishNode(BHNode& node, const std::vector<BHNode>& nodes,
+                               const uint32_t* children, int count) const {
+    double m = 0.0, cx = 0.0, cy = 0.0, cz = 0.0;
+    for (int c = 0; c < count; ++c) {
+        const BHNode& ch = nodes[children[c]];
+        m += ch.gm; cx += ch.gm * ch.cx; cy += ch.gm * ch.cy; cz += ch.gm * ch.cz;
+    }
+    node.gm = m;
+    if (m > 0.0) { node.cx = cx / m; node.cy = cy / m; node.cz = cz / m; }
+}
+
+void BarnesHutTree::buildRange(uint32_t begin, uint32_t end, int level, std::vector<BHNode>& out) const {
+    const uint32_t idx = (uint32_t)out.size();
+    BHNode node = {0.0, 0.0, 0.0, 0.0, std::ldexp(rootSize, -level), 0, begin, end, 0};
+    out.push_back(node);
+
+    if (isLeaf(begin, end, level)) {
+        double m = 0.0, cx = 0.0, cy = 0.0, cz = 0.0;
+        for (uint32_t k = begin; k < end; ++k) {
+            m += sgm[k]; cx += sgm[k] * sx[k]; cy += sgm[k] * sy[k]; cz += sgm[k] * sz[k];
+        }
+        BHNode& leaf = out[idx];
+        leaf.leaf = 1;
+        leaf.gm = m;
+        if (m > 0.0) { leaf.cx = cx / m; leaf.cy = cy / m; leaf.cz = cz / m; }
+        leaf.next = (uint32_t)out.size();
+        return;
+    }
+
+    Range kids[8];
+    const int nk = childRanges(begin, end, level, kids);
+    uint32_t childIdx[8];
+    for (int c = 0; c < nk; ++c) {
+        childIdx[c] = (uint32_t)out.size();
+        buildRange(kids[c].begin, kids[c].end, kids[c].level, out);
+    }
+    finishNode(out[idx], out, childIdx, nk);
+    out[idx].next = (uint32_t)out.size();
+}
+
+void BarnesHutTree::collectTasks(uint32_t begin, uint32_t end, int level, std::vector<Range>& tasks) const {
+    if (level >= splitLevel || isLeaf(begin, end, level)) {
+        tasks.push_back({begin, end, level});
+        return;
+    }
+    Range kids[8];
+    const int nk = childRanges(begin, end, level, kids);
+    for (int c = 0; c < nk; ++c) collectTasks(kids[c].begin, kids[c].end, kids[c].level, tasks);
+}
+
+// Same walk as collectTasks, now emitting the top nodes and splicing in the
+// subtrees the workers built (their skip links shifted to the final offset).
+void BarnesHutTree::emitTop(uint32_t begin, uint32_t end, int level,
+                            const std::vector<std::vector<BHNode>>& parts, size_t& partIdx) {
+    if (level >= splitLevel || isLeaf(begin, end, level)) {
+        const std::vector<BHNode>& part = parts[partIdx++];
+        const uint32_t offset = (uint32_t)tree.size();
+        for (BHNode node : part) {
+            node.next += offset;
+            tree.push_back(node);
+        }
+        return;
+    }
+    const uint32_t idx = (uint32_t)tree.size();
+    BHNode node = {0.0, 0.0, 0.0, 0.0, std::ldexp(rootSize, -level), 0, begin, end, 0};
+    tree.push_back(node);
+
+    Range kids[8];
+    const int nk = childRanges(begin, end, level, kids);
+    uint32_t childIdx[8];
+    for (int c = 0; c < nk; ++c) {
+        childIdx[c] = (uint32_t)tree.size();
+        emitTop(kids[c].begin, kids[c].end, kids[c].level, parts, partIdx);
+    }
+    finishNode(tree[idx], tree, childIdx, nk);
+    tree[idx].next = (uint32_t)tree.size();
+}
+
+void BarnesHutTree::build(const double* x, const double* y, const double* z, const double* gm,
+                          const std::vector<size_t>& sources, ThreadPool* pool) {
+    auto t0 = std::chrono::steady_clock::now();
+    const size_t n = sources.size();
+    tree.clear();
+    leaves.clear();
+    order.clear();
+    if (n == 0) { lastBuildSeconds = 0.0; return; }
+
+    // bounding cube, reduced per chunk
+    const size_t chunks = pool ? pool->size() : 1;
+    const size_t chunkLen = (n + chunks - 1) / chunks;
+    std::vector<double> lo(chunks * 3, 1e300), hi(chunks * 3, -1e300);
+    runParallel(pool, chunks, 1, [&](size_t cb, size_t ce) {
+        for (size_t c = cb; c < ce; ++c) {
+            size_t end = std::min(n, (c + 1) * chunkLen);
+            for (size_t k = c * chunkLen; k < end; ++k) {
+                size_t s = sources[k];
+                const double p[3] = {x[s], y[s], z[s]};
+                for (int a = 0; a < 3; ++a) {
+                    lo[c * 3 + a] = std::min(lo[c * 3 + a], p[a]);
+                    hi[c * 3 + a] = std::max(hi[c * 3 + a], p[a]);
+                }
+            }
+        }
+    });
+    double bmin[3] = {1e300, 1e300, 1e300}, bmax[3] = {-1e300, -1e300, -1e300};
+    for (size_t c = 0; c < chunks; ++c) {
+        for (int a = 0; a < 3; ++a) {
+            bmin[a] = std::min(bmin[a], lo[c * 3 + a]);
+            bmax[a] = std::max(bmax[a], hi[c * 3 + a]);
+        }
+    }
+    rootSize = std::max(std::max(bmax[0] - bmin[0], bmax[1] - bmin[1]), bmax[2] - bmin[2]);
+    rootSize = rootSize > 0.0 ? rootSize * (1.0 + 1e-9) : 1e-9;
+    for (int a = 0; a < 3; ++a) origin[a] = bmin[a];
+
+    // Morton keys, sorted
+    codes.resize(n);
+    std::vector<uint32_t> slot(n);
+    const double scale = (double)(1u << MORTON_LEVELS) / rootSize;
+    runParallel(pool, n, 4096, [&](size_t b, size_t e) {
+        for (size_t k = b; k < e; ++k) {
+            size_t s = sources[k];
+            uint64_t qx = (uint64_t)((x[s] - origin[0]) * scale);
+            uint64_t qy = (uint64_t)((y[s] - origin[1]) * scale);
+            uint64_t qz = (uint64_t)((z[s] - origin[2]) * scale);
+            codes[k] = spreadBits(qx) | spreadBits(qy) << 1 | spreadBits(qz) << 2;
+            slot[k] = (uint32_t)k;
+        }
+    });
+    radixSortPairs(codes, slot, pool);
+
+    order.resize(n); sx.resize(n); sy.resize(n); sz.resize(n); sgm.resize(n);
+    runParallel(pool, n, 4096, [&](size_t b, size_t e) {
+        for (size_t k = b; k < e; ++k) {
+            size_t s = sources[slot[k]];
+            order[k] = (uint32_t)s;
+            sx[k] = x[s]; sy[k] = y[s]; sz[k] = z[s]; sgm[k] = gm[s];
+        }
+    });
+
+    // subtrees below splitLevel in parallel, then the top levels around them
+    std::vector<Range> tasks;
+    collectTasks(0, (uint32_t)n, 0, tasks);
+    std::vector<std::vector<BHNode>> parts(tasks.size());
+    runParallel(pool, tasks.size(), 1, [&](size_t b, size_t e) {
+        for (size_t t = b; t < e; ++t) buildRange(tasks[t].begin, tasks[t].end, tasks[t].level, parts[t]);
+    });
+    size_t partIdx = 0;
+    emitTop(0, (uint32_t)n, 0, parts, partIdx);
+    leaves.clear();
+    for (uint32_t k = 0; k < (uint32_t)tree.size(); ++k) {
+        if (tree[k].leaf) leaves.push_back(k);
+    }
+
+    lastBuildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void BarnesHutTree::walkPoint(double xi, double yi, double zi, size_t self, double out[3]) const {
+    const double theta2 = theta * theta;
+    const double eps2 = softening * softening;
+    const BHNode* nodes = tree.data();
+    const uint32_t nodeCount = (uint32_t)tree.size();
+    double ax = 0.0, ay = 0.0, az = 0.0;
+    uint32_t k = 0;
+    while (k < nodeCount) {
+        const BHNode& nd = nodes[k];
+        if (nd.leaf) {
+            for (uint32_t s = nd.begin; s < nd.end; ++s) {
+                if (order[s] == self) continue;
+                double dx = sx[s] - xi, dy = sy[s] - yi, dz = sz[s] - zi;
+                double r2 = dx*dx + dy*dy + dz*dz + eps2;
+                double inv = sgm[s] / (r2 * std::sqrt(r2));
+                ax += dx * inv; ay += dy * inv; az += dz * inv;
+            }
+            k = nd.next;
+            continue;
+        }
+        double dx = nd.cx - xi, dy = nd.cy - yi, dz = nd.cz - zi;
+        double d2 = dx*dx + dy*dy + dz*dz;
+        double s2 = nd.size * nd.size;
+        // far enough, and the target cannot lie inside the cell
+        if (s2 < theta2 * d2 && d2 > 3.0 * s2) {
+            double r2 = d2 + eps2;
+            double inv = nd.gm / (r2 * std::sqrt(r2));
+            ax += dx * inv; ay += dy * inv; az += dz * inv;
+            k = nd.next;
+        } else {
+            ++k;
+        }
+    }
+    out[0] = ax; out[1] = ay; out[2] = az;
+}
+
+// One walk for every source in a leaf: cells are accepted against the leaf's
+// bounding box, collected into an interaction list and applied to each member.
+void BarnesHutTree::walkLeaf(const BHNode& leaf, double* ax, double* ay, double* az) const {
+    const double theta2 = theta * theta;
+    const double eps2 = softening * softening;
+    double lo[3] = {1e300, 1e300, 1e300}, hi[3] = {-1e300, -1e300, -1e300};
+    for (uint32_t s = leaf.begin; s < leaf.end; ++s) {
+        lo[0] = std::min(lo[0], sx[s]); hi[0] = std::max(hi[0], sx[s]);
+        lo[1] = std::min(lo[1], sy[s]); hi[1] = std::max(hi[1], sy[s]);
+        lo[2] = std::min(lo[2], sz[s]); hi[2] = std::max(hi[2], sz[s]);
+    }
+
+    // interaction list as plain arrays so the inner loop vectorises
+    thread_local std::vector<double> lx, ly, lz, lm;
+    lx.clear(); ly.clear(); lz.clear(); lm.clear();
+    auto push = [](double px, double py, double pz, double m) {
+        lx.push_back(px); ly.push_back(py); lz.push_back(pz); lm.push_back(m);
+    };
+
+    const BHNode* nodes = tree.data();
+    const uint32_t nodeCount = (uint32_t)tree.size();
+    uint32_t k = 0;
+    while (k < nodeCount) {
+        const BHNode& nd = nodes[k];
+        if (nd.leaf) {
+            for (uint32_t s = nd.begin; s < nd.end; ++s) push(sx[s], sy[s], sz[s], sgm[s]);
+            k = nd.next;
+            continue;
+        }
+        // distance from the cell's centre of mass to the nearest point of the box
+        double ex = std::max(0.0, std::max(lo[0] - nd.cx, nd.cx - hi[0]));
+        double ey = std::max(0.0, std::max(lo[1] - nd.cy, nd.cy - hi[1]));
+        double ez = std::max(0.0, std::max(lo[2] - nd.cz, nd.cz - hi[2]));
+        double d2 = ex*ex + ey*ey + ez*ez;
+        double s2 = nd.size * nd.size;
+        if (s2 < theta2 * d2 && d2 > 3.0 * s2) {
+            push(nd.cx, nd.cy, nd.cz, nd.gm);
+            k = nd.next;
+        } else {
+            ++k;
+        }
+    }
+
+    const size_t listLen = lx.size();
+    const double* px = lx.data(); const double* py = ly.data();
+    const double* pz = lz.data(); const double* pm = lm.data();
+    for (uint32_t t = leaf.begin; t < leaf.end; ++t) {
+        const double xi = sx[t], yi = sy[t], zi = sz[t];
+        double sxa = 0.0, sya = 0.0, sza = 0.0;
+        for (size_t j = 0; j < listLen; ++j) {
+            double dx = px[j] - xi, dy = py[j] - yi, dz = pz[j] - zi;
+            double r2 = dx*dx + dy*dy + dz*dz + eps2;
+            // r2 == 0 is the target itself
+            double inv = r2 > 0.0 ? pm[j] / (r2 * std::sqrt(r2)) : 0.0;
+            sxa += dx * inv; sya += dy * inv; sza += dz * inv;
+        }
+        const uint32_t i = order[t];
+        ax[i] = sxa; ay[i] = sya; az[i] = sza;
+    }
+}
+
+void BarnesHutTree::accelerations(const double* x, const double* y, const double* z, size_t count,
+                                  double* ax, double* ay, double* az, ThreadPool* pool) const {
+    auto t0 = std::chrono::steady_clock::now();
+
+    // sources in range: one shared walk per leaf
+    std::vector<char> covered(count, 0);
+    for (uint32_t i : order) {
+        if (i < count) covered[i] = 1;
+    }
+    runParallel(pool, leaves.size(), 16, [&](size_t b, size_t e) {
+        for (size_t l = b; l < e; ++l) walkLeaf(tree[leaves[l]], ax, ay, az);
+    });
+
+    // everything else (massless particles, excluded sources) walks on its own
+    runParallel(pool, count, 256, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            if (covered[i]) continue;
+            double a[3];
+            walkPoint(x[i], y[i], z[i], i, a);
+            ax[i] = a[0]; ay[i] = a[1]; az[i] = a[2];
+        }
+    });
+    lastWalkSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
@@ -0,0 +1,69 @@
+// src/sim/barnes_hut.h
+// Barnes-Hut octree for the N-body force evaluation.
+// Sources are sorted along a 63-bit Morton curve, so every octree cell is a
+// contiguous range of the sorted arrays. Nodes live in one flat array in
+// depth-first pre-order with a skip link ("next"), which makes the walk
+// stackless: open a cell -> go to i+1, accept it -> jump to next.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+struct BHNode {
+    double cx, cy, cz;     // centre of mass
+    double gm;             // total mass (GM)
+    double size;           // cell edge length
+    uint32_t next;         // first node after this subtree
+    uint32_t begin, end;   // source range in Morton order
+    uint32_t leaf;
+};
+
+class BarnesHutTree {
+public:
+    double theta = 0.5;        // opening angle: accept a cell when size/d < theta
+    double softening = 0.0;    // Plummer softening length
+    uint32_t leafSize = 8;
+
+    // Build over the given source indices (positions and GM read through them).
+    void build(const double* x, const double* y, const double* z, const double* gm,
+               const std::vector<size_t>& sources, ThreadPool* pool);
+
+    // Acceleration at every target in [0, count); a target that is itself a
+    // source (same index) does not attract itself. Targets that are sources
+    // share one walk per leaf bucket (x/y/z must be the arrays given to build);
+    // the rest walk individually.
+    void accelerations(const double* x, const double* y, const double* z, size_t count,
+                       double* ax, double* ay, double* az, ThreadPool* pool) const;
+
+    const std::vector<BHNode>& nodes() const { return tree; }
+    double lastBuildSeconds = 0.0;
+    mutable double lastWalkSeconds = 0.0;
+
+private:
+    struct Range { uint32_t begin, end; int level; };
+
+    bool isLeaf(uint32_t begin, uint32_t end, int level) const;
+    int childRanges(uint32_t begin, uint32_t end, int level, Range out[8]) const;
+    void buildRange(uint32_t begin, uint32_t end, int level, std::vector<BHNode>& out) const;
+    void collectTasks(uint32_t begin, uint32_t end, int level, std::vector<Range>& tasks) const;
+    void emitTop(uint32_t begin, uint32_t end, int level,
+                 const std::vector<std::vector<BHNode>>& parts, size_t& partIdx);
+    void finishNode(BHNode& node, const std::vector<BHNode>& nodes, const uint32_t* children, int count) const;
+    void walkPoint(double xi, double yi, double zi, size_t self, double out[3]) const;
+    void walkLeaf(const BHNode& leaf, double* ax, double* ay, double* az) const;
+
+    std::vector<BHNode> tree;
+    std::vector<uint32_t> leaves;                  // leaf node indices
+    std::vector<uint64_t> codes;                   // sorted Morton keys
+    std::vector<uint32_t> order;                   // sorted slot -> original index
+    std::vector<double> sx, sy, sz, sgm;           // sources in Morton order
+    double rootSize = 0.0;
+    double origin[3] = {0.0, 0.0, 0.0};
+    int splitLevel = 3;                            // subtrees below this build in parallel
+};
+
+// Sort keys ascending, carrying vals along (LSD radix, parallel histograms).
+void radixSortPairs(std::vector<uint64_t>& keys, std::vector<uint32_t>& vals, ThreadPool* pool);
@@ -0,0 +1,86 @@
+// src/sim/benchmarks.h
+// Throughput benchmarks reachable from the headless CLI.
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Propagate `count` random small bodies for `frames` epochs with every SIMD
+// level the CPU supports and print bodies/second for each.
+int runKeplerBenchmark(size_t count, int frames);
+
+// Integrate the Sun + planets (plus optional massless test particles) for
+// `years` with each integrator and print steps/second and energy drift.
+int runNBodyBenchmark(double years, double dtDays, size_t testParticles);
+
+// Step `count` self-gravitating particles around the Sun with the Barnes-Hut
+// solver and print build/walk time plus force error against direct summation.
+int runBarnesHutBenchmark(size_t count, double theta, int steps);
+
+// Fit a Chebyshev ephemeris of the planets over [fromYears, toYears] (years
+// from J2000) from the Kepler or N-body source, write it to `path`, map it
+// back and print fit time, file size, evaluation rate and error.
+int runEphemerisBuild(const std::string& path, double fromYears, double toYears,
+                      double granuleDays, int degree, bool nbody);
+
+// Map a JPL DE binary file, evaluate the planets over `epochs` random times
+// with the batched API (one thread, then the pool) and print epochs/second
+// plus the largest distance from the Kepler elements as a sanity check.
+int runJplDeBenchmark(const std::string& path, size_t epochs);
+
+// Load the VSOP87A files from `dir` and, for every truncation level, print the
+// term count, single-epoch and batched evaluation rates and the largest
+// position error against the untruncated series.
+int runVsop87Benchmark(const std::string& dir, size_t epochs);
+
+// Run the sim thread synchronously with `moons` synthetic satellites, first
+// with every system at full rate, then with a fixed set of LOD tiers, and
+// print mean / worst tick time and body updates per tick.
+int runSimLodBenchmark(size_t moons, int ticks);
+
+// Run the N-body model (DOP853, every body at full rate) for `days` at
+// daysPerSecond of playback with 60 ticks per second, record every tick to
+// `path`, then replay the file and print size, ratio and decode rate.
+int runRecording(const std::string& path, double days, double daysPerSecond, size_t moons);
+
+// Search [fromYears, toYears) after J2000 for events with the Kepler/lunar
+// series positions, serially and on the shared pool; print counts, timings
+// and the first `listed` eclipses and transits.
+int runEventSearch(double fromYears, double toYears, size_t listed);
+
+// Screen `bodies` belt orbits for approaches within thresholdAU of each other
+// (or the Earth's default threshold) over `days`; below 20k bodies the hash
+// result is checked against every pair.
+int runApproachScreen(size_t bodies, double days, double thresholdAU);
+
+// Run a Monte Carlo ensemble of perturbed N-body runs on the shared pool and
+// print the streamed statistics.
+int runEnsembleBenchmark(size_t members, double years);
+
+// Porkchop grid (steps x steps) from planet `from` to `to` (planetElementsJ2000()
+// indices) for departures over [departYears, departYears + spanDays]; times the
+// scalar and SIMD Lambert kernels, checks cells against the reference solver,
+// prints the best C3 and writes the grid to `path` if given.
+int runPorkchop(int from, int to, double departYears, double spanDays, size_t steps, const std::string& path);
+
+// Gravity-assist search from `from` to `to` (planetElementsJ2000() indices)
+// for launches over [departYears, departYears + spanDays]: through the fixed
+// flyby sequence `via`, or exploring up to maxFlybys flybys of Venus, Earth
+// and Mars when it is empty. Progress is printed while the search runs.
+int runGravityAssist(int from, int to, const std::vector<int>& via, int maxFlybys, double departYears,
+                     double spanDays);
+
+// `count` spacecraft launched at departYears from Earth, Mars and Jupiter and
+// followed for `days` on patched conics: times the per-tick update and the
+// event searches, checks the sphere-of-influence switches of the first few
+// against per-step distance tests, and compares simulation ticks with and
+// without the fleet.
+int runSpacecraft(size_t count, double departYears, double days);
+
+// Earth satellites from the TLE file `source`, or `source` synthetic objects
+// in a mix of LEO, MEO, GEO, Molniya and transfer orbits (formatted as TLEs
+// and parsed back) when it is a number. Checks the reference propagator
+// against Vallado's published vectors, times the catalogue over `days` at
+// every SIMD level and prints the largest kernel difference from the reference.
+int runSgp4(const std::string& source, double days);
@@ -0,0 +1,172 @@
+// src/sim/body_registry.cpp
+#include "body_registry.h"
+#include "solar_sim.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const double DEG = 3.14159265358979323846 / 180.0;
+
+static void pushBody(BodyRegistry& reg, int32_t parent, const std::string& name, double orbitSpeed,
+                     double rotationSpeed, float orbitPhase, float orbitAngle, float rotationAngle,
+                     float orbitRadius, float size, float axialTilt, bool hasRing) {
+    reg.parent.push_back(parent);
+    reg.orbitSpeed.push_back(orbitSpeed);
+    reg.rotationSpeed.push_back(rotationSpeed);
+    reg.orbitPhase.push_back(orbitPhase);
+    reg.orbitAngle.push_back(orbitAngle);
+    reg.rotationAngle.push_back(rotationAngle);
+    reg.orbitRadius.push_back(orbitRadius);
+    reg.bodySize.push_back(size);
+    reg.axialTilt.push_back(axialTilt);
+    reg.moonBegin.push_back(0);
+    reg.moonEnd.push_back(0);
+    BodyInfo info;
+    info.name = name;
+    info.hasRing = hasRing;
+    reg.info.push_back(info);
+}
+
+BodyRegistry buildRegistry(const std::vector<Planet>& planets) {
+    BodyRegistry reg;
+    for (const auto &p : planets) {
+        pushBody(reg, -1, p.name, p.orbitSpeed, p.rotationSpeed, p.orbitPhase, p.orbitAngle,
+                 p.rotationAngle, p.orbitRadius, p.size, p.axialTilt, p.hasRing);
+    }
+    reg.rootCount = planets.size();
+    for (size_t pi = 0; pi < planets.size(); ++pi) {
+        reg.moonBegin[pi] = (uint32_t)reg.size();
+        for (const auto &m : planets[pi].moons) {
+            pushBody(reg, (int32_t)pi, m.name, m.orbitSpeed, m.rotationSpeed, m.orbitPhase, m.orbitAngle,
+                     m.rotationAngle, m.orbitRadius, m.size, 0.0f, false);
+        }
+        reg.moonEnd[pi] = (uint32_t)reg.size();
+    }
+    return reg;
+}
+
+// r - 360*floor(r/360) rather than fmod so the sweeps stay vectorizable
+static inline float wrap360(double deg) {
+    return (float)(deg - 360.0 * std::floor(deg * (1.0 / 360.0)));
+}
+
+void stepBodies(BodyRegistry& reg, double dtSim) {
+    const size_t n = reg.size();
+    float* oa = reg.orbitAngle.data();
+    float* ra = reg.rotationAngle.data();
+    const double* os = reg.orbitSpeed.data();
+    const double* rs = reg.rotationSpeed.data();
+    for (size_t i = 0; i < n; ++i) {
+        oa[i] = wrap360(oa[i] + dtSim * os[i]);
+        ra[i] = wrap360(ra[i] + dtSim * rs[i]);
+    }
+}
+
+void assignStepLevels(BodyRegistry& reg, double baseSeconds, double maxDegrees, double maxSeconds,
+                      const uint8_t* active) {
+    const size_t n = reg.size();
+    reg.stepLevel.assign(n, 0);
+    std::vector<uint32_t> count(MAX_STEP_LEVEL + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const double w = std::fabs(reg.orbitSpeed[i]);
+        const double limit = w > 0.0 ? std::fmin(maxSeconds, maxDegrees / w) : maxSeconds;
+        int level = 0;
+        while (level < MAX_STEP_LEVEL && baseSeconds * (double)(2 << level) <= limit) ++level;
+        reg.stepLevel[i] = (uint8_t)level;
+        if (!active || active[i]) ++count[level];
+    }
+    // counting sort keeps registry order inside a level
+    reg.levelStart.assign(MAX_STEP_LEVEL + 2, 0);
+    for (int l = 0; l <= MAX_STEP_LEVEL; ++l) reg.levelStart[l + 1] = reg.levelStart[l] + count[l];
+    reg.levelOrder.resize(reg.levelStart.back());
+    std::vector<uint32_t> fill(reg.levelStart.begin(), reg.levelStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        if (!active || active[i]) reg.levelOrder[fill[reg.stepLevel[i]]++] = (uint32_t)i;
+    }
+}
+
+size_t stepBodyLevels(BodyRegistry& reg, int topLevel, double baseSeconds, float* prevOrbit, float* prevRotation) {
+    float* oa = reg.orbitAngle.data();
+    float* ra = reg.rotationAngle.data();
+    const double* os = reg.orbitSpeed.data();
+    const double* rs = reg.rotationSpeed.data();
+    const uint32_t* order = reg.levelOrder.data();
+    const uint32_t end = reg.levelStart[std::min(topLevel, MAX_STEP_LEVEL) + 1];
+    uint32_t k = 0;
+    for (int l = 0; l <= topLevel && l <= MAX_STEP_LEVEL; ++l) {
+        const double dt = baseSeconds * (double)(1u << l);
+        for (; k < reg.levelStart[l + 1]; ++k) {
+            const uint32_t i = order[k];
+            prevOrbit[i] = oa[i];
+            prevRotation[i] = ra[i];
+            oa[i] = wrap360(oa[i] + dt * os[i]);
+            ra[i] = wrap360(ra[i] + dt * rs[i]);
+        }
+    }
+    return end;
+}
+
+void finishBodyLevels(BodyRegistry& reg, uint64_t substeps, double baseSeconds) {
+    for (size_t i = 0; i < reg.size(); ++i) {
+        const uint64_t rest = substeps & ((1ull << reg.stepLevel[i]) - 1);
+        if (rest == 0) continue;
+        const double dt = baseSeconds * (double)rest;
+        reg.orbitAngle[i] = wrap360(reg.orbitAngle[i] + dt * reg.orbitSpeed[i]);
+        reg.rotationAngle[i] = wrap360(reg.rotationAngle[i] + dt * reg.rotationSpeed[i]);
+    }
+}
+
+void evaluateBodies(BodyRegistry& reg, double simSeconds) {
+    const size_t n = reg.size();
+    float* oa = reg.orbitAngle.data();
+    float* ra = reg.rotationAngle.data();
+    const float* ph = reg.orbitPhase.data();
+    const double* os = reg.orbitSpeed.data();
+    const double* rs = reg.rotationSpeed.data();
+    for (size_t i = 0; i < n; ++i) {
+        oa[i] = wrap360(ph[i] + simSeconds * os[i]);
+        ra[i] = wrap360(simSeconds * rs[i]);
+    }
+}
+
+void rootPositions(const BodyRegistry& reg, float* x, float* y, float* z) {
+    for (size_t i = 0; i < reg.rootCount; ++i) {
+        float a = (float)(reg.orbitAngle[i] * DEG);
+        x[i] = std::cos(a) * reg.orbitRadius[i];
+        y[i] = 0.0f;
+        z[i] = std::sin(a) * reg.orbitRadius[i];
+    }
+}
+
+void moonPositions(const BodyRegistry& reg, float* x, float* y, float* z) {
+    const size_t n = reg.size();
+    const int32_t* parent = reg.parent.data();
+    for (size_t i = reg.rootCount; i < n; ++i) {
+        float a = (float)(reg.orbitAngle[i] * DEG);
+        const int32_t p = parent[i];
+        x[i] = x[p] + std::cos(a) * reg.orbitRadius[i];
+        y[i] = y[p];
+        z[i] = z[p] + std::sin(a) * reg.orbitRadius[i];
+    }
+}
+
+void modelMatrices(const BodyRegistry& reg, const float* x, const float* y, const float* z, float* out) {
+    const size_t n = reg.size();
+    for (size_t i = 0; i < n; ++i) {
+        const float t = (float)(reg.axialTilt[i] * DEG), r = (float)(reg.rotationAngle[i] * DEG);
+        const float ct = std::cos(t), st = std::sin(t), cr = std::cos(r), sr = std::sin(r);
+        const float s = reg.bodySize[i];
+        float* m = out + 16 * i;
+        m[0]  =  ct * cr * s; m[1]  = -st * cr * s; m[2]  = -sr * s; m[3]  = 0.0f;
+        m[4]  = -ct * sr * s; m[5]  =  st * sr * s; m[6]  = -cr * s; m[7]  = 0.0f;
+        m[8]  =  st * s;      m[9]  =  ct * s;      m[10] = 0.0f;    m[11] = 0.0f;
+        m[12] = x[i];         m[13] = y[i];         m[14] = z[i];    m[15] = 1.0f;
+    }
+}
+
+void evaluateBodies(BodyRegistry& reg, double simSeconds, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        reg.orbitAngle[i] = wrap360(reg.orbitPhase[i] + simSeconds * reg.orbitSpeed[i]);
+        reg.rotationAngle[i] = wrap360(simSeconds * reg.rotationSpeed[i]);
+    }
+}
@@ -0,0 +1,75 @@
+// src/sim/body_registry.h
+// Flat structure-of-arrays body store. Planets come first (parent -1), then
+// every moon, grouped by parent so a planet's moons are one contiguous range.
+// Per-step data lives in its own arrays and cold descriptive data in `info`,
+// so the update and model-matrix passes are linear sweeps over a few floats.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Planet;
+
+struct BodyInfo {
+    std::string name;
+    bool hasRing = false;
+};
+
+struct BodyRegistry {
+    // --- hot: one entry per body ---
+    std::vector<int32_t> parent;                  // -1 = orbits the Sun
+    std::vector<double> orbitSpeed, rotationSpeed; // degrees per simulated second
+    std::vector<float> orbitPhase;                // orbitAngle at simulated time 0
+    std::vector<float> orbitAngle, rotationAngle; // state, degrees
+    std::vector<float> orbitRadius, bodySize, axialTilt;
+
+    // --- topology ---
+    size_t rootCount = 0;                         // bodies [0, rootCount) orbit the Sun
+    std::vector<uint32_t> moonBegin, moonEnd;     // per body: range of its moons
+
+    // --- block timesteps (assignStepLevels) ---
+    std::vector<uint8_t> stepLevel;               // body steps every 2^level substeps
+    std::vector<uint32_t> levelOrder;             // body indices sorted by level
+    std::vector<uint32_t> levelStart;             // levelOrder range per level, levels + 1 entries
+
+    // --- cold ---
+    std::vector<BodyInfo> info;
+
+    size_t size() const { return parent.size(); }
+};
+
+// Flatten planets and their moons (same planet order, moons after all planets).
+BodyRegistry buildRegistry(const std::vector<Planet>& planets);
+
+// Advance every body by dtSim seconds / set every angle from absolute time.
+void stepBodies(BodyRegistry& reg, double dtSim);
+void evaluateBodies(BodyRegistry& reg, double simSeconds);
+// Closed form for bodies [begin, end) only.
+void evaluateBodies(BodyRegistry& reg, double simSeconds, size_t begin, size_t end);
+
+// Block timesteps: a body whose own step limit, min(maxDegrees / orbit speed,
+// maxSeconds), spans 2^L base substeps is put on level L and advanced only
+// every 2^L substeps, by 2^L * baseSeconds.
+const int MAX_STEP_LEVEL = 16;
+// Bodies with active[i] == 0 keep a level but are left out of the sweep.
+void assignStepLevels(BodyRegistry& reg, double baseSeconds, double maxDegrees, double maxSeconds,
+                      const uint8_t* active = nullptr);
+// Advance levels 0..topLevel (the ones due on this substep), saving each
+// stepped body's previous angles into prevOrbit / prevRotation. Returns the
+// number of bodies stepped.
+size_t stepBodyLevels(BodyRegistry& reg, int topLevel, double baseSeconds, float* prevOrbit, float* prevRotation);
+// After `substeps` base substeps, advance each body by the part of its own
+// step not yet taken, so every level holds the state at the same time.
+void finishBodyLevels(BodyRegistry& reg, uint64_t substeps, double baseSeconds);
+
+// Scene-space (y up) centres on circular orbits. rootPositions fills the
+// planets; moonPositions offsets every moon from its (already placed) parent,
+// so planets may come from another orbit model.
+void rootPositions(const BodyRegistry& reg, float* x, float* y, float* z);
+void moonPositions(const BodyRegistry& reg, float* x, float* y, float* z);
+
+// Column-major model matrices, 16 floats per body:
+// translate(pos) * rotX(-90) * rotY(axialTilt) * rotZ(rotationAngle) * scale(bodySize).
+void modelMatrices(const BodyRegistry& reg, const float* x, const float* y, const float* z, float* out);
@@ -0,0 +1,153 @@
+// src/sim/checkpoint.cpp
+#include "checkpoint.h"
+
+#include <cstring>
+
+// --- value coding ---
+static uint64_t bitsOf(double v) {
+    uint64_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+static double doubleOf(uint64_t b) {
+    double v;
+    std::memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+// One control byte (leading zero bytes << 4 | trailing zero bytes), then the
+// bytes in between, most significant first.
+static void encode(const double* values, const double* ref, size_t count, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t x = bitsOf(values[i]) ^ (ref ? bitsOf(ref[i]) : 0);
+        int lead = 0, trail = 0;
+        while (lead < 8 && ((x >> (56 - 8 * lead)) & 0xff) == 0) ++lead;
+        if (lead < 8) {
+            while (((x >> (8 * trail)) & 0xff) == 0) ++trail;
+        }
+        out.push_back((uint8_t)(lead << 4 | trail));
+        for (int k = 7 - lead; k >= trail; --k) out.push_back((uint8_t)(x >> (8 * k)));
+    }
+}
+
+static void decode(const std::vector<uint8_t>& in, size_t count, const double* ref, double* values) {
+    size_t p = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const int lead = in[p] >> 4, trail = in[p] & 15;
+        ++p;
+        uint64_t x = 0;
+        for (int k = 7 - lead; k >= trail; --k) x |= (uint64_t)in[p++] << (8 * k);
+        values[i] = doubleOf(x ^ (ref ? bitsOf(ref[i]) : 0));
+    }
+}
+
+// Extrapolate the next checkpoint from up to three previous ones in the group
+// (constant, linear, quadratic). Encoder and decoder run the same arithmetic,
+// so the XOR residual restores the exact bits.
+static void predict(const std::vector<std::vector<double>>& hist, size_t count, std::vector<double>& out) {
+    out.resize(count);
+    const size_t h = hist.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (h >= 3) out[i] = 3.0 * hist[h - 1][i] - 3.0 * hist[h - 2][i] + hist[h - 3][i];
+        else if (h == 2) out[i] = 2.0 * hist[h - 1][i] - hist[h - 2][i];
+        else out[i] = hist[h - 1][i];
+    }
+}
+
+static void remember(std::vector<std::vector<double>>& hist, const std::vector<double>& values) {
+    if (hist.size() == 3) hist.erase(hist.begin());
+    hist.push_back(values);
+}
+
+// --- ring ---
+void CheckpointRing::clear() {
+    entries.clear();
+    history.clear();
+    sinceKey = 0;
+    stored = raw = 0;
+}
+
+bool CheckpointRing::due(double t) const {
+    return entries.empty() || t >= entries.back().t + intervalDays;
+}
+
+void CheckpointRing::push(double t, const std::vector<double>& values) {
+    if (!entries.empty() && t <= entries.back().t) return;
+    // a new group on schedule or when the layout changes
+    if (history.empty() || history.back().size() != values.size()) sinceKey = 0;
+    Entry e;
+    e.t = t;
+    e.key = sinceKey == 0 || sinceKey >= groupSize;
+    e.count = values.size();
+    if (e.key) {
+        history.clear();
+        encode(values.data(), nullptr, values.size(), e.data);
+    } else {
+        predict(history, values.size(), prediction);
+        encode(values.data(), prediction.data(), values.size(), e.data);
+    }
+    sinceKey = e.key ? 1 : sinceKey + 1;
+    stored += e.data.size();
+    raw += values.size() * sizeof(double);
+    entries.push_back(std::move(e));
+    remember(history, values);
+    evict();
+}
+
+void CheckpointRing::evict() {
+    // drop whole groups from the front, never the newest one
+    while (stored > budgetBytes && !entries.empty()) {
+        size_t end = 1;
+        while (end < entries.size() && !entries[end].key) ++end;
+        if (end == entries.size()) break;
+        for (size_t k = 0; k < end; ++k) {
+            stored -= entries.front().data.size();
+            raw -= entries.front().count * sizeof(double);
+            entries.pop_front();
+        }
+    }
+}
+
+bool CheckpointRing::nearest(double t, double& at, std::vector<double>& values) const {
+    if (entries.empty() || t < entries.front().t) return false;
+    size_t hit = entries.size() - 1;
+    while (entries[hit].t > t) --hit;
+    size_t key = hit;
+    while (!entries[key].key) --key;
+    at = entries[hit].t;
+    std::vector<std::vector<double>> hist;
+    replay(key, hit, hist);
+    values = hist.back();
+    return true;
+}
+
+void CheckpointRing::truncateAfter(double t) {
+    if (entries.empty() || entries.back().t <= t) return;
+    while (!entries.empty() && entries.back().t > t) {
+        stored -= entries.back().data.size();
+        raw -= entries.back().count * sizeof(double);
+        entries.pop_back();
+    }
+    if (entries.empty()) { clear(); return; }
+    // the group continues from the new newest entry
+    size_t key = entries.size() - 1;
+    while (!entries[key].key) --key;
+    replay(key, entries.size() - 1, history);
+    sinceKey = (int)(entries.size() - key);
+}
+
+void CheckpointRing::replay(size_t key, size_t hit, std::vector<std::vector<double>>& hist) const {
+    hist.clear();
+    std::vector<double> values(entries[key].count), pred;
+    decode(entries[key].data, entries[key].count, nullptr, values.data());
+    remember(hist, values);
+    for (size_t k = key + 1; k <= hit; ++k) {
+        predict(hist, entries[k].count, pred);
+        values.resize(entries[k].count);
+        decode(entries[k].data, entries[k].count, pred.data(), values.data());
+        remember(hist, values);
+    }
+}
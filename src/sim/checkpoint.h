@@ -0,0 +1,57 @@
+// src/sim/checkpoint.h
+// Bounded ring of compressed simulation checkpoints for rewinding integrated
+// (non-analytic) state. Checkpoints come in groups: a keyframe, then deltas
+// that XOR each double against its value extrapolated from the previous
+// checkpoints of the group. Smooth trajectories predict well, so the sign,
+// exponent and leading mantissa bytes of the residual are zero.
+// Every value is stored as one control byte (leading / trailing zero byte
+// counts) plus the bytes in between. When the ring is over its budget the
+// oldest group is dropped whole.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class CheckpointRing {
+public:
+    size_t budgetBytes = 32u << 20;
+    double intervalDays = 30.0;     // spacing of checkpoints in simulated time
+    int groupSize = 16;             // checkpoints per keyframe
+
+    void clear();
+    // True once t is an interval past the newest checkpoint (or the ring is empty).
+    bool due(double t) const;
+    // Store a checkpoint at t; ignored unless t is past the newest one, so
+    // re-integrating over covered time does not duplicate entries.
+    void push(double t, const std::vector<double>& values);
+    // Newest checkpoint at or before t. False if t precedes the ring.
+    bool nearest(double t, double& at, std::vector<double>& values) const;
+    // Drop everything after t (the trajectory there no longer applies).
+    void truncateAfter(double t);
+
+    size_t count() const { return entries.size(); }
+    size_t bytes() const { return stored; }
+    double oldest() const { return entries.empty() ? 0.0 : entries.front().t; }
+    double newest() const { return entries.empty() ? 0.0 : entries.back().t; }
+    // Raw size over stored size of everything in the ring.
+    double ratio() const { return stored > 0 ? (double)raw / (double)stored : 1.0; }
+
+private:
+    struct Entry {
+        double t;
+        bool key;
+        size_t count;               // doubles
+        std::vector<uint8_t> data;
+    };
+    void evict();
+    // Decode entries key..hit; hist ends with the last three, newest last.
+    void replay(size_t key, size_t hit, std::vector<std::vector<double>>& hist) const;
+
+    std::deque<Entry> entries;
+    std::vector<std::vector<double>> history;  // newest entries of the open group
+    std::vector<double> prediction;
+    int sinceKey = 0;
+    size_t stored = 0, raw = 0;
+};
@@ -0,0 +1,245 @@
+// src/sim/close_approach.cpp
+#include "close_approach.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// --- exact refinement ---
+static double dot3(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void relativeState(const OrbitalElements& a, const OrbitalElements& b, double t, double dr[3], double dv[3]) {
+    double pa[3], va[3], pb[3], vb[3];
+    keplerState(a, 1.0, t, pa, va);
+    keplerState(b, 1.0, t, pb, vb);
+    for (int k = 0; k < 3; ++k) {
+        dr[k] = pa[k] - pb[k];
+        dv[k] = va[k] - vb[k];
+    }
+}
+
+// Minimum of |ra - rb| in [t0, t1): r.v must go from negative to
+// non-negative, so a minimum on a step boundary belongs to one step only.
+static bool closestApproach(const OrbitalElements& a, const OrbitalElements& b, double t0, double t1,
+                            double& tca, double& dist) {
+    double dr[3], dv[3];
+    relativeState(a, b, t0, dr, dv);
+    double f0 = dot3(dr, dv);
+    if (f0 >= 0.0) return false;
+    relativeState(a, b, t1, dr, dv);
+    double f1 = dot3(dr, dv);
+    if (f1 < 0.0) return false;
+    // Illinois regula falsi on r.v
+    int side = 0;
+    for (int it = 0; it < 60 && t1 - t0 > 1e-7; ++it) {
+        double tm = (t0 * f1 - t1 * f0) / (f1 - f0);
+        if (!(tm > t0 && tm < t1)) tm = 0.5 * (t0 + t1);
+        relativeState(a, b, tm, dr, dv);
+        const double fm = dot3(dr, dv);
+        if (fm < 0.0) {
+            t0 = tm; f0 = fm;
+            if (side == -1) f1 *= 0.5;
+            side = -1;
+        } else {
+            t1 = tm; f1 = fm;
+            if (side == 1) f0 *= 0.5;
+            side = 1;
+        }
+    }
+    tca = f1 < -f0 ? t1 : t0;
+    relativeState(a, b, tca, dr, dv);
+    dist = std::sqrt(dot3(dr, dr));
+    return true;
+}
+
+// --- spatial hash ---
+struct HashEntry {
+    uint32_t body;
+    int32_t x, y, z;
+};
+
+static uint32_t cellHash(int32_t x, int32_t y, int32_t z) {
+    return ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u) ^ ((uint32_t)z * 83492791u);
+}
+
+// --- slab ---
+struct SlabResult {
+    std::vector<CloseApproach> found;
+    size_t candidates = 0, refined = 0;
+};
+
+// Steps [k0, k1) of the grid from + k * stepDays. The last element is the Earth.
+static void screenSlab(const ApproachScreen& cfg, const std::vector<OrbitalElements>& els, double from,
+                       size_t k0, size_t k1, double bend, SlabResult& res) {
+    const size_t n = els.size(), earth = n - 1;
+    KeplerPropagator prop;
+    for (const OrbitalElements& el : els) prop.add(el);
+
+    std::vector<float> p0[3], p1[3], lo[3], hi[3];
+    for (int a = 0; a < 3; ++a) {
+        p0[a].resize(n); p1[a].resize(n); lo[a].resize(n); hi[a].resize(n);
+    }
+    auto positions = [&](double t, std::vector<float>* p) {
+        prop.propagate(t);
+        std::copy(prop.x(), prop.x() + n, p[0].begin());
+        std::copy(prop.y(), prop.y() + n, p[1].begin());
+        std::copy(prop.z(), prop.z() + n, p[2].begin());
+    };
+    // half of each pair threshold goes on each box
+    const double rBody = 0.5 * cfg.thresholdAU + bend;
+    const double rEarth = cfg.earthThresholdAU - 0.5 * cfg.thresholdAU + bend;
+    std::vector<HashEntry> entries;
+    std::vector<uint32_t> start;
+
+    positions(from + k0 * cfg.stepDays, p0);
+    for (size_t k = k0; k < k1; ++k) {
+        const double t0 = from + k * cfg.stepDays, t1 = t0 + cfg.stepDays;
+        positions(t1, p1);
+
+        float cell = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            const float r = (float)(i == earth ? rEarth : rBody);
+            for (int a = 0; a < 3; ++a) {
+                lo[a][i] = std::min(p0[a][i], p1[a][i]) - r;
+                hi[a][i] = std::max(p0[a][i], p1[a][i]) + r;
+                if (i != earth) cell = std::max(cell, hi[a][i] - lo[a][i]);
+            }
+        }
+
+        auto testPair = [&](size_t i, size_t j) {
+            const bool withEarth = i == earth || j == earth;
+            const double limit = withEarth ? cfg.earthThresholdAU : cfg.thresholdAU;
+            // straight-line motion over the step
+            double d0[3], e[3];
+            for (int a = 0; a < 3; ++a) {
+                d0[a] = (double)p0[a][i] - p0[a][j];
+                e[a] = ((double)p1[a][i] - p1[a][j]) - d0[a];
+            }
+            const double ee = dot3(e, e);
+            const double s = ee > 0.0 ? std::min(1.0, std::max(0.0, -dot3(d0, e) / ee)) : 0.0;
+            double m[3] = {d0[0] + s * e[0], d0[1] + s * e[1], d0[2] + s * e[2]};
+            if (std::sqrt(dot3(m, m)) >= limit + 2.0 * bend) return;
+            ++res.refined;
+            double tca, dist;
+            if (!closestApproach(els[i], els[j], t0, t1, tca, dist) || dist >= limit) return;
+            if (withEarth) res.found.push_back({(uint32_t)(i == earth ? j : i), APPROACH_EARTH, tca, dist});
+            else res.found.push_back({(uint32_t)std::min(i, j), (uint32_t)std::max(i, j), tca, dist});
+        };
+
+        if (cfg.bruteForce) {
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = i + 1; j < n; ++j) {
+                    bool overlap = true;
+                    for (int a = 0; a < 3; ++a) overlap = overlap && lo[a][i] <= hi[a][j] && lo[a][j] <= hi[a][i];
+                    if (overlap) {
+                        ++res.candidates;
+                        testPair(i, j);
+                    }
+                }
+            }
+        } else {
+            // cells twice the largest body box: at most two cells per axis each
+            const float inv = 1.0f / (2.0f * cell);
+            auto cellRange = [&](size_t i, int32_t c0[3], int32_t c1[3]) {
+                for (int a = 0; a < 3; ++a) {
+                    c0[a] = (int32_t)std::floor(lo[a][i] * inv);
+                    c1[a] = (int32_t)std::floor(hi[a][i] * inv);
+                }
+            };
+            size_t count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                int32_t c0[3], c1[3];
+                cellRange(i, c0, c1);
+                count += (size_t)(c1[0] - c0[0] + 1) * (c1[1] - c0[1] + 1) * (c1[2] - c0[2] + 1);
+            }
+            size_t buckets = 64;
+            while (buckets < count) buckets *= 2;
+            const uint32_t mask = (uint32_t)buckets - 1;
+
+            // counting sort of (body, cell) by bucket
+            start.assign(buckets + 1, 0);
+            auto eachCell = [&](size_t i, auto&& fn) {
+                int32_t c0[3], c1[3];
+                cellRange(i, c0, c1);
+                for (int32_t x = c0[0]; x <= c1[0]; ++x)
+                    for (int32_t y = c0[1]; y <= c1[1]; ++y)
+                        for (int32_t z = c0[2]; z <= c1[2]; ++z) fn(x, y, z);
+            };
+            for (size_t i = 0; i < n; ++i) {
+                eachCell(i, [&](int32_t x, int32_t y, int32_t z) { ++start[(cellHash(x, y, z) & mask) + 1]; });
+            }
+            for (size_t b = 0; b < buckets; ++b) start[b + 1] += start[b];
+            entries.resize(count);
+            std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+            for (size_t i = 0; i < n; ++i) {
+                eachCell(i, [&](int32_t x, int32_t y, int32_t z) {
+                    entries[fill[cellHash(x, y, z) & mask]++] = {(uint32_t)i, x, y, z};
+                });
+            }
+
+            for (size_t b = 0; b < buckets; ++b) {
+                for (uint32_t u = start[b]; u < start[b + 1]; ++u) {
+                    const HashEntry& eu = entries[u];
+                    for (uint32_t v = u + 1; v < start[b + 1]; ++v) {
+                        const HashEntry& ev = entries[v];
+                        if (eu.x != ev.x || eu.y != ev.y || eu.z != ev.z) continue;   // bucket collision
+                        const size_t i = eu.body, j = ev.body;
+                        bool owned = true;
+                        const int32_t c[3] = {eu.x, eu.y, eu.z};
+                        for (int a = 0; a < 3 && owned; ++a) {
+                            owned = lo[a][i] <= hi[a][j] && lo[a][j] <= hi[a][i]
+                                    && (int32_t)std::floor(std::max(lo[a][i], lo[a][j]) * inv) == c[a];
+                        }
+                        if (!owned) continue;
+                        ++res.candidates;
+                        testPair(i, j);
+                    }
+                }
+            }
+        }
+        for (int a = 0; a < 3; ++a) p0[a].swap(p1[a]);
+    }
+}
+
+// --- screen ---
+std::vector<CloseApproach> ApproachScreen::screen(const std::vector<OrbitalElements>& bodies, double fromDays,
+                                                  double toDays, ThreadPool* pool) {
+    auto tStart = std::chrono::steady_clock::now();
+    candidates = refined = 0;
+    std::vector<CloseApproach> result;
+    if (!(toDays > fromDays) || stepDays <= 0.0 || bodies.empty()) return result;
+
+    std::vector<OrbitalElements> els = bodies;
+    els.push_back(planetElementsJ2000()[2]);
+    // how far a path can bow away from its chord over a step: a * dt^2 / 8
+    // at the strongest solar pull any body feels, plus float position error
+    double rMin = 1e9;
+    for (const OrbitalElements& el : els) rMin = std::min(rMin, el.a * (1.0 - el.e));
+    const double bend = GAUSS_K * GAUSS_K / (rMin * rMin) * stepDays * stepDays / 8.0 + 1e-5;
+
+    const size_t steps = (size_t)std::ceil((toDays - fromDays) / stepDays);
+    const size_t slabs = std::min(steps, pool ? (size_t)pool->size() * std::max<size_t>(slabsPerThread, 1) : 1);
+    std::vector<SlabResult> res(slabs);
+    auto run = [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            screenSlab(*this, els, fromDays, steps * s / slabs, steps * (s + 1) / slabs, bend, res[s]);
+        }
+    };
+    if (pool) pool->parallelFor(slabs, 1, run);
+    else run(0, slabs);
+
+    for (const SlabResult& r : res) {
+        candidates += r.candidates;
+        refined += r.refined;
+        for (const CloseApproach& c : r.found) {
+            if (c.tDays < toDays) result.push_back(c);
+        }
+    }
+    std::sort(result.begin(), result.end(),
+              [](const CloseApproach& x, const CloseApproach& y) { return x.tDays < y.tDays; });
+    lastMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count();
+    return result;
+}
@@ -0,0 +1,46 @@
+// src/sim/close_approach.h
+// Close-approach screening of a Keplerian population against itself and the
+// Earth. Time is cut into coarse steps. For each step every body's motion is
+// boxed (start and end positions plus the pair threshold and a bound on the
+// path's bend), the boxes are binned into a spatial hash, and only boxes
+// sharing a cell are paired. Each pair passes a straight-line distance test,
+// then an exact one on the two-body orbits: the zero of r.v (relative
+// position and velocity) in the step gives the time and distance of closest
+// approach. A pair is counted only in the cell holding the low corner of
+// the box overlap, so it is tested once per step. Steps are grouped in time
+// slabs that run in parallel, each with its own propagator and hash.
+#pragma once
+
+#include "kepler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+const uint32_t APPROACH_EARTH = 0xffffffffu;
+
+struct CloseApproach {
+    uint32_t a, b;       // population indices, a < b; b = APPROACH_EARTH for the Earth
+    double tDays;        // time of closest approach
+    double distanceAU;
+};
+
+struct ApproachScreen {
+    double stepDays = 1.0;          // one hash per step
+    double thresholdAU = 1e-3;      // between two bodies
+    double earthThresholdAU = 0.05; // between a body and the Earth
+    size_t slabsPerThread = 4;
+    bool bruteForce = false;        // every pair instead of the hash, for checking
+
+    // Every approach closer than the thresholds with its minimum in
+    // [fromDays, toDays), sorted by time.
+    std::vector<CloseApproach> screen(const std::vector<OrbitalElements>& bodies, double fromDays, double toDays,
+                                      ThreadPool* pool = nullptr);
+
+    // counts from the last screen()
+    size_t candidates = 0;   // pairs whose boxes overlap
+    size_t refined = 0;      // pairs that passed the straight-line test
+    double lastMs = 0.0;
+};
@@ -0,0 +1,204 @@
+// src/sim/ensemble.cpp
+#include "ensemble.h"
+#include "kepler.h"
+#include "solar_sim.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// --- reducer ---
+void RunningStats::add(double v) {
+    if (n == 0) {
+        min = max = v;
+    } else {
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+    ++n;
+    const double d = v - mean;
+    mean += d / (double)n;
+    m2 += d * (v - mean);
+}
+
+void RunningStats::merge(const RunningStats& o) {
+    if (o.n == 0) return;
+    if (n == 0) {
+        *this = o;
+        return;
+    }
+    const double na = (double)n, nb = (double)o.n, total = na + nb;
+    const double d = o.mean - mean;
+    mean += d * nb / total;
+    m2 += o.m2 + d * d * na * nb / total;
+    n += o.n;
+    min = std::min(min, o.min);
+    max = std::max(max, o.max);
+}
+
+// --- members ---
+static const size_t PLANETS = PLANET_COUNT;
+static const size_t GROUP = 8;   // members per task
+
+enum Metric : size_t {
+    METRIC_OFFSET = 0,                       // + planet
+    METRIC_MAX_E = PLANETS,                  // + planet
+    METRIC_APPROACH = 2 * PLANETS,
+    METRIC_DRIFT,
+    METRIC_COUNT
+};
+
+// Everything one task reuses for its members, so after the first member
+// a run allocates nothing; in effect a per-thread arena.
+struct MemberScratch {
+    NBodySim sim;
+    NBodyState state;
+    std::vector<OrbitalElements> els;
+    std::vector<double> masses;
+    std::vector<RunningStats> stats;
+};
+
+static void initScratch(MemberScratch& m) {
+    m.state = createSolarSystemNBody(0.0);
+    m.stats.assign(METRIC_COUNT, RunningStats());
+}
+
+// Sun plus planets from m.els / m.masses, barycentric, written in place.
+static void fillState(MemberScratch& m) {
+    NBodyState& s = m.state;
+    s.x[0] = s.y[0] = s.z[0] = s.vx[0] = s.vy[0] = s.vz[0] = 0.0;
+    for (size_t i = 0; i < PLANETS; ++i) {
+        double pos[3], vel[3];
+        keplerState(m.els[i], 1.0 + m.masses[i], 0.0, pos, vel);
+        s.x[i + 1] = pos[0]; s.y[i + 1] = pos[1]; s.z[i + 1] = pos[2];
+        s.vx[i + 1] = vel[0]; s.vy[i + 1] = vel[1]; s.vz[i + 1] = vel[2];
+        s.gm[i + 1] = GM_SUN * m.masses[i];
+    }
+    s.toBarycentric();
+}
+
+static void perturb(const EnsembleSpec& spec, size_t member, MemberScratch& m) {
+    std::seed_seq seq{spec.seed, (unsigned)member, (unsigned)((unsigned long long)member >> 32)};
+    std::mt19937_64 rng(seq);
+    std::normal_distribution<double> g(0.0, 1.0);
+    static const std::vector<OrbitalElements> els = planetElementsJ2000();
+    static const std::vector<double> masses = planetMassesSolar();
+    m.els = els;           // copies into the capacity already there
+    m.masses = masses;
+    for (size_t i = 0; i < PLANETS; ++i) {
+        OrbitalElements& el = m.els[i];
+        el.a *= 1.0 + spec.sigmaA * g(rng);
+        el.e = std::min(std::max(el.e + spec.sigmaE * g(rng), 0.0), 0.99);
+        el.i += spec.sigmaAngle * g(rng);
+        el.raan += spec.sigmaAngle * g(rng);
+        el.argPeri += spec.sigmaAngle * g(rng);
+        el.M0 += spec.sigmaAngle * g(rng);
+        m.masses[i] *= 1.0 + spec.sigmaMass * g(rng);
+    }
+}
+
+// Integrate m.state; the extremes are taken every sampleDays, the final
+// heliocentric positions (24 doubles) at the end.
+static void integrate(const EnsembleSpec& spec, MemberScratch& m, double* finalPos, double maxE[PLANETS],
+                      double& minApproach) {
+    NBodySim& sim = m.sim;
+    sim.integrator = spec.integrator;
+    sim.setState(m.state, 0.0);
+    const double tEnd = spec.years * 365.25;
+    std::fill(maxE, maxE + PLANETS, 0.0);
+    minApproach = 1e30;
+    double h[PLANETS][3];
+    for (double t = 0.0; t < tEnd;) {
+        t = std::min(t + spec.sampleDays, tEnd);
+        sim.advanceTo(t, spec.dtDays);
+        const NBodyState& s = sim.state();
+        for (size_t i = 0; i < PLANETS; ++i) {
+            const size_t b = i + 1;
+            const double r[3] = {s.x[b] - s.x[0], s.y[b] - s.y[0], s.z[b] - s.z[0]};
+            const double v[3] = {s.vx[b] - s.vx[0], s.vy[b] - s.vy[0], s.vz[b] - s.vz[0]};
+            const double mu = s.gm[0] + s.gm[b];
+            const double rl = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+            const double v2 = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+            const double rv = r[0] * v[0] + r[1] * v[1] + r[2] * v[2];
+            double e2 = 0.0;
+            for (int k = 0; k < 3; ++k) {
+                const double ek = ((v2 - mu / rl) * r[k] - rv * v[k]) / mu;
+                e2 += ek * ek;
+            }
+            maxE[i] = std::max(maxE[i], std::sqrt(e2));
+            for (int k = 0; k < 3; ++k) h[i][k] = r[k];
+        }
+        for (size_t i = 0; i < PLANETS; ++i) {
+            for (size_t j = i + 1; j < PLANETS; ++j) {
+                const double d[3] = {h[i][0] - h[j][0], h[i][1] - h[j][1], h[i][2] - h[j][2]};
+                minApproach = std::min(minApproach, std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]));
+            }
+        }
+    }
+    for (size_t i = 0; i < PLANETS; ++i) {
+        // DOP853 may have stepped past tEnd; its dense output covers tEnd
+        if (!sim.heliocentricAt(i + 1, tEnd, finalPos + 3 * i)) sim.heliocentric(i + 1, finalPos + 3 * i);
+    }
+}
+
+// --- ensemble ---
+EnsembleResult runEnsemble(const EnsembleSpec& spec, ThreadPool* pool) {
+    auto t0 = std::chrono::steady_clock::now();
+    EnsembleResult result;
+    for (size_t i = 0; i < PLANETS; ++i) result.names.push_back(std::string(PLANET_NAMES[i]) + " offset (AU)");
+    for (size_t i = 0; i < PLANETS; ++i) result.names.push_back(std::string(PLANET_NAMES[i]) + " max e");
+    result.names.push_back("Closest planet pair (AU)");
+    result.names.push_back("Energy drift");
+    result.stats.assign(METRIC_COUNT, RunningStats());
+    if (spec.members == 0 || spec.years <= 0.0 || spec.dtDays <= 0.0 || spec.sampleDays <= 0.0) return result;
+
+    // the unperturbed run the offsets are measured from
+    double nominal[3 * PLANETS], maxE[PLANETS], approach;
+    {
+        MemberScratch m;
+        initScratch(m);
+        m.els = planetElementsJ2000();
+        m.masses = planetMassesSolar();
+        fillState(m);
+        integrate(spec, m, nominal, maxE, approach);
+    }
+
+    const size_t groups = (spec.members + GROUP - 1) / GROUP;
+    std::vector<std::vector<RunningStats>> groupStats(groups);
+    auto run = [&](size_t begin, size_t end) {
+        MemberScratch m;
+        initScratch(m);
+        for (size_t g = begin; g < end; ++g) {
+            std::fill(m.stats.begin(), m.stats.end(), RunningStats());
+            for (size_t k = g * GROUP; k < std::min((g + 1) * GROUP, spec.members); ++k) {
+                perturb(spec, k, m);
+                fillState(m);
+                double finalPos[3 * PLANETS], e[PLANETS], closest;
+                integrate(spec, m, finalPos, e, closest);
+                for (size_t i = 0; i < PLANETS; ++i) {
+                    const double* p = finalPos + 3 * i;
+                    const double* q = nominal + 3 * i;
+                    m.stats[METRIC_OFFSET + i].add(
+                        std::sqrt((p[0] - q[0]) * (p[0] - q[0]) + (p[1] - q[1]) * (p[1] - q[1]) + (p[2] - q[2]) * (p[2] - q[2])));
+                    m.stats[METRIC_MAX_E + i].add(e[i]);
+                }
+                m.stats[METRIC_APPROACH].add(closest);
+                m.stats[METRIC_DRIFT].add(m.sim.energyDrift());
+            }
+            groupStats[g] = m.stats;
+        }
+    };
+    // a few chunks per thread, one scratch per chunk; chunking does not change the result
+    if (pool) pool->parallelFor(groups, std::max<size_t>(1, groups / (4 * pool->size())), run);
+    else run(0, groups);
+
+    // merged in group order, whatever ran where
+    for (const auto& gs : groupStats) {
+        for (size_t k = 0; k < METRIC_COUNT; ++k) result.stats[k].merge(gs[k]);
+    }
+    result.members = spec.members;
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
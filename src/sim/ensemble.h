@@ -0,0 +1,56 @@
+// src/sim/ensemble.h
+// Monte Carlo ensembles of N-body runs: every member starts from the J2000
+// planets with its elements and masses perturbed by Gaussian noise and is
+// integrated on its own (single-threaded) NBodySim. Members run in parallel.
+// Nothing is kept per member: each group of members owns a simulator,
+// a scratch state and a set of streaming reducers that it reuses, and the
+// groups' reducers are merged at the end. Groups are a fixed size and
+// members draw from their own seeded generator, so results do not depend
+// on the thread count.
+#pragma once
+
+#include "nbody.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Count, mean, variance (Welford), min and max of a stream of values;
+// two reducers merge exactly as if they had seen both streams.
+struct RunningStats {
+    size_t n = 0;
+    double mean = 0.0, m2 = 0.0;
+    double min = 0.0, max = 0.0;
+
+    void add(double v);
+    void merge(const RunningStats& o);
+    double variance() const { return n > 1 ? m2 / (double)(n - 1) : 0.0; }
+};
+
+struct EnsembleSpec {
+    size_t members = 1000;
+    double years = 100.0;
+    Integrator integrator = Integrator::WisdomHolman;
+    double dtDays = 4.0;          // step (DOP853: largest step)
+    double sampleDays = 10.0;     // how often the per-run extremes are updated
+    unsigned seed = 1;
+    // 1-sigma perturbations
+    double sigmaA = 1e-7;         // relative semi-major axis
+    double sigmaE = 1e-6;         // eccentricity
+    double sigmaAngle = 1e-6;     // radians, on i, node, perihelion and mean anomaly
+    double sigmaMass = 1e-4;      // relative planet mass
+};
+
+struct EnsembleResult {
+    // per planet: final offset from the unperturbed run (AU), largest
+    // eccentricity; then the closest planet-planet approach (AU) and the
+    // relative energy drift
+    std::vector<std::string> names;
+    std::vector<RunningStats> stats;
+    size_t members = 0;
+    double wallSeconds = 0.0;
+};
+
+EnsembleResult runEnsemble(const EnsembleSpec& spec, ThreadPool* pool = nullptr);
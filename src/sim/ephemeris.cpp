@@ -0,0 +1,201 @@
+// src/sim/ephemeris.cpp
+#include "ephemeris.h"
+#include "kepler.h"
+#include "nbody.h"
+#include "thread_pool.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+static const char EPH_MAGIC[8] = {'S','O','L','E','P','H','0','1'};
+static const size_t NAME_LEN = 16;
+
+// header + names, rounded up so the coefficients stay 8-byte aligned
+static size_t prefixBytes(size_t bodyCount) {
+    size_t b = sizeof(EphemerisHeader) + bodyCount * NAME_LEN;
+    return (b + 7) / 8 * 8;
+}
+
+Ephemeris::~Ephemeris() {
+    close();
+}
+
+void Ephemeris::close() {
+    file.close();
+    owned.clear();
+    owned.shrink_to_fit();
+    bytes = 0;
+    hdr = nullptr;
+    names = nullptr;
+    coeffs = nullptr;
+}
+
+void Ephemeris::fit(const EphemerisSource& source, const std::vector<std::string>& bodyNames,
+                    double startDays, double endDays, double granuleDays, int degree, ThreadPool* pool) {
+    close();
+    const size_t nb = bodyNames.size();
+    const size_t nc = (size_t)degree + 1;
+    const size_t ng = (size_t)std::ceil((endDays - startDays) / granuleDays);
+    const size_t per = nb * 3 * nc;
+
+    // one contiguous block laid out exactly like the file
+    bytes = prefixBytes(nb) + ng * per * sizeof(double);
+    owned.assign(bytes / sizeof(double), 0.0);
+    char* base = (char*)owned.data();
+    EphemerisHeader* h = (EphemerisHeader*)base;
+    std::memcpy(h->magic, EPH_MAGIC, 8);
+    h->bodyCount = (uint32_t)nb;
+    h->coeffCount = (uint32_t)nc;
+    h->granuleCount = (uint32_t)ng;
+    h->startDays = startDays;
+    h->granuleDays = granuleDays;
+    char* nm = base + sizeof(EphemerisHeader);
+    for (size_t b = 0; b < nb; ++b) std::strncpy(nm + b * NAME_LEN, bodyNames[b].c_str(), NAME_LEN - 1);
+    double* out = (double*)(base + prefixBytes(nb));
+
+    // Chebyshev-Gauss nodes x_j = cos(pi (j + 1/2) / N); c_k = 2/N sum_j f(x_j) T_k(x_j)
+    std::vector<double> nodeX(nc), basis(nc * nc);
+    for (size_t j = 0; j < nc; ++j) {
+        nodeX[j] = std::cos((0.5 * TWO_PI) * (j + 0.5) / nc);
+        for (size_t k = 0; k < nc; ++k) {
+            basis[k * nc + j] = (k == 0 ? 1.0 : 2.0) / nc * std::cos((0.5 * TWO_PI) * k * (j + 0.5) / nc);
+        }
+    }
+
+    auto fitRange = [&](size_t gBegin, size_t gEnd) {
+        std::vector<double> samples(nc * 3 * nb);
+        for (size_t g = gBegin; g < gEnd; ++g) {
+            const double t0 = startDays + g * granuleDays;
+            // nodes run from x = +1 down; walk them backwards so time increases
+            for (size_t jj = nc; jj-- > 0;) {
+                source(t0 + 0.5 * (nodeX[jj] + 1.0) * granuleDays, &samples[jj * 3 * nb]);
+            }
+            double* c = out + g * per;
+            for (size_t b = 0; b < nb; ++b) {
+                for (size_t ax = 0; ax < 3; ++ax) {
+                    for (size_t k = 0; k < nc; ++k) {
+                        double s = 0.0;
+                        for (size_t j = 0; j < nc; ++j) s += basis[k * nc + j] * samples[j * 3 * nb + 3 * b + ax];
+                        c[(b * 3 + ax) * nc + k] = s;
+                    }
+                }
+            }
+        }
+    };
+    if (pool) pool->parallelFor(ng, 16, fitRange);
+    else fitRange(0, ng);
+
+    hdr = h;
+    names = nm;
+    coeffs = out;
+}
+
+bool Ephemeris::save(const std::string& path) const {
+    if (!hdr) return false;
+    std::ofstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "Cannot write ephemeris: " << path << "\n";
+        return false;
+    }
+    f.write((const char*)hdr, (std::streamsize)bytes);
+    return (bool)f;
+}
+
+bool Ephemeris::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    bytes = file.size();
+
+    const EphemerisHeader* h = (const EphemerisHeader*)file.data();
+    const size_t need = bytes >= sizeof(EphemerisHeader)
+        ? prefixBytes(h->bodyCount) + (size_t)h->granuleCount * h->bodyCount * 3 * h->coeffCount * sizeof(double) : 0;
+    if (need == 0 || std::memcmp(h->magic, EPH_MAGIC, 8) != 0 || need > bytes) {
+        std::cerr << "Not a valid ephemeris file: " << path << "\n";
+        close();
+        return false;
+    }
+    hdr = h;
+    names = file.data() + sizeof(EphemerisHeader);
+    coeffs = (const double*)(file.data() + prefixBytes(h->bodyCount));
+    return true;
+}
+
+std::string Ephemeris::bodyName(size_t body) const {
+    if (!hdr || body >= hdr->bodyCount) return std::string();
+    const char* p = names + body * NAME_LEN;
+    return std::string(p, strnlen(p, NAME_LEN));
+}
+
+bool Ephemeris::evaluate(size_t body, double tDays, double pos[3], double vel[3]) const {
+    if (!hdr || body >= hdr->bodyCount) return false;
+    double u = (tDays - hdr->startDays) / hdr->granuleDays;
+    if (u < 0.0 || u > (double)hdr->granuleCount) return false;
+    size_t g = (size_t)u;
+    if (g >= hdr->granuleCount) g = hdr->granuleCount - 1;   // t == end
+    evaluateGranule(body, g, 2.0 * (u - (double)g) - 1.0, pos, vel);
+    return true;
+}
+
+bool Ephemeris::evaluateTicks(size_t body, SimTicks t, double pos[3], double vel[3]) const {
+    if (!hdr || body >= hdr->bodyCount) return false;
+    const SimTicks granule = ticksFromDays(hdr->granuleDays);
+    const SimTicks off = t - ticksFromDays(hdr->startDays);
+    if (granule <= 0 || off < 0 || off > granule * (SimTicks)hdr->granuleCount) return false;
+    size_t g = (size_t)(off / granule);
+    if (g >= hdr->granuleCount) g = hdr->granuleCount - 1;   // t == end
+    evaluateGranule(body, g, 2.0 * (double)(off - (SimTicks)g * granule) / (double)granule - 1.0, pos, vel);
+    return true;
+}
+
+void Ephemeris::evaluateGranule(size_t body, size_t g, double x, double pos[3], double vel[3]) const {
+    const size_t nc = hdr->coeffCount;
+    const double* c = coeffs + ((size_t)g * hdr->bodyCount + body) * 3 * nc;
+
+    for (int ax = 0; ax < 3; ++ax) {
+        const double* a = c + ax * nc;
+        // T_k and dT_k/dx by recurrence
+        double t0 = 1.0, t1 = x, d0 = 0.0, d1 = 1.0;
+        double p = a[0] + (nc > 1 ? a[1] * x : 0.0);
+        double v = nc > 1 ? a[1] : 0.0;
+        for (size_t k = 2; k < nc; ++k) {
+            double t2 = 2.0 * x * t1 - t0;
+            double d2 = 2.0 * t1 + 2.0 * x * d1 - d0;
+            p += a[k] * t2;
+            v += a[k] * d2;
+            t0 = t1; t1 = t2; d0 = d1; d1 = d2;
+        }
+        pos[ax] = p;
+        if (vel) vel[ax] = v * 2.0 / hdr->granuleDays;
+    }
+}
+
+// --- sources ---
+std::vector<std::string> planetEphemerisNames() {
+    return {"Mercury", "Venus", "Earth", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune"};
+}
+
+EphemerisSource keplerEphemerisSource() {
+    std::vector<OrbitalElements> els = planetElementsJ2000();
+    return [els](double tDays, double* xyz) {
+        for (size_t i = 0; i < els.size(); ++i) keplerPosition(els[i], 1.0, tDays, xyz + 3 * i);
+    };
+}
+
+EphemerisSource nbodyEphemerisSource(double startDays, ThreadPool* pool) {
+    // The trajectory is integrated with one fixed step regardless of the
+    // query times; each query finishes with a short step on a copy, so any
+    // two samplings of the source see the same orbit.
+    const double dt = 0.5;
+    std::shared_ptr<NBodySim> sim = std::make_shared<NBodySim>(pool);
+    sim->setState(createSolarSystemNBody(startDays), startDays);
+    return [sim, dt](double tDays, double* xyz) {
+        while (sim->time + dt <= tDays) sim->step(dt);
+        NBodySim probe = *sim;
+        if (tDays > probe.time) probe.step(tDays - probe.time);
+        const size_t n = probe.state().size();
+        for (size_t i = 1; i < n; ++i) probe.heliocentric(i, xyz + 3 * (i - 1));
+    };
+}
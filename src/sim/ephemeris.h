@@ -0,0 +1,86 @@
+// src/sim/ephemeris.h
+// Chebyshev ephemeris cache in the spirit of the JPL DE files: time is cut
+// into fixed granules and every body's x/y/z over a granule is one Chebyshev
+// series. Fitting samples any position source once; afterwards position and
+// velocity at any time inside the coverage cost a few multiply-adds.
+//
+// File layout (native endian, doubles 8-byte aligned):
+//   EphemerisHeader
+//   char names[bodyCount][16]
+//   double coeffs[granuleCount][bodyCount][3][coeffCount]
+#pragma once
+
+#include "mapped_file.h"
+#include "sim_time.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+struct EphemerisHeader {
+    char magic[8];             // "SOLEPH01"
+    uint32_t bodyCount;
+    uint32_t coeffCount;       // per axis (degree + 1)
+    uint32_t granuleCount;
+    uint32_t reserved;
+    double startDays;          // days since J2000
+    double granuleDays;
+};
+
+// Writes 3 * bodyCount doubles (x, y, z per body; AU) for time tDays.
+typedef std::function<void(double tDays, double* xyz)> EphemerisSource;
+
+class Ephemeris {
+public:
+    Ephemeris() = default;
+    ~Ephemeris();
+    Ephemeris(const Ephemeris&) = delete;
+    Ephemeris& operator=(const Ephemeris&) = delete;
+
+    // Sample `source` over [startDays, endDays). A stateful source (N-body)
+    // is called with increasing times and needs pool == nullptr; a pure one
+    // (closed-form) can be fitted granule-parallel.
+    void fit(const EphemerisSource& source, const std::vector<std::string>& names,
+             double startDays, double endDays, double granuleDays, int degree, ThreadPool* pool);
+
+    bool save(const std::string& path) const;
+    // Memory-map a file written by save(); nothing is copied or parsed.
+    bool open(const std::string& path);
+    void close();
+
+    bool valid() const { return hdr != nullptr; }
+    size_t bodyCount() const { return hdr ? hdr->bodyCount : 0; }
+    double startDays() const { return hdr ? hdr->startDays : 0.0; }
+    double endDays() const { return hdr ? hdr->startDays + hdr->granuleCount * hdr->granuleDays : 0.0; }
+    std::string bodyName(size_t body) const;
+    size_t byteSize() const { return bytes; }
+
+    // Position (AU) and, if vel != nullptr, velocity (AU/day) of a body.
+    // Returns false outside the coverage.
+    bool evaluate(size_t body, double tDays, double pos[3], double vel[3] = nullptr) const;
+    // Same on the simulation clock: the granule and the offset into it come
+    // from integer ticks, so far-off dates lose nothing to the day count.
+    bool evaluateTicks(size_t body, SimTicks t, double pos[3], double vel[3] = nullptr) const;
+
+private:
+    void evaluateGranule(size_t body, size_t g, double x, double pos[3], double vel[3]) const;
+
+    std::vector<double> owned;     // backing store after fit()
+    MappedFile file;               // backing store after open()
+    size_t bytes = 0;
+    const EphemerisHeader* hdr = nullptr;
+    const char* names = nullptr;
+    const double* coeffs = nullptr;
+};
+
+// Heliocentric Mercury..Neptune from the J2000 elements (pure, thread-safe).
+EphemerisSource keplerEphemerisSource();
+// Heliocentric Mercury..Neptune integrated with Wisdom-Holman (fixed 0.5 d
+// steps) from startDays (stateful: times must not decrease).
+EphemerisSource nbodyEphemerisSource(double startDays, ThreadPool* pool);
+// Names matching both sources.
+std::vector<std::string> planetEphemerisNames();
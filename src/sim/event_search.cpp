@@ -0,0 +1,389 @@
+// src/sim/event_search.cpp
+#include "event_search.h"
+#include "jpl_de.h"
+#include "kepler.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static const double DEG = TWO_PI / 360.0;
+static const double EARTH_RADIUS_KM = 6378.14;
+static const double SUN_RADIUS_KM = 696000.0;
+static const double MOON_RADIUS_KM = 1737.4;
+static const char* const BODY_NAMES[10] = {"Mercury", "Venus", "Earth", "Mars", "Jupiter",
+                                           "Saturn", "Uranus", "Neptune", "Sun", "Moon"};
+
+// --- lunar series ---
+// Largest terms of ELP-2000/82 as tabulated by Meeus (Astronomical Algorithms
+// ch. 47): multiples of D, M, M', F; longitude in 1e-6 deg, distance in m.
+struct LunarTerm { signed char d, m, mp, f; int l, r; };
+static const LunarTerm LUNAR_LR[] = {
+    {0, 0, 1, 0, 6288774, -20905355}, {2, 0, -1, 0, 1274027, -3699111}, {2, 0, 0, 0, 658314, -2955968},
+    {0, 0, 2, 0, 213618, -569925},    {0, 1, 0, 0, -185116, 48888},     {0, 0, 0, 2, -114332, -3149},
+    {2, 0, -2, 0, 58793, 246158},     {2, -1, -1, 0, 57066, -152138},   {2, 0, 1, 0, 53322, -170733},
+    {2, -1, 0, 0, 45758, -204586},    {0, 1, -1, 0, -40923, -129620},   {1, 0, 0, 0, -34720, 108743},
+    {0, 1, 1, 0, -30383, 104755},     {2, 0, 0, -2, 15327, 10321},      {0, 0, 1, 2, -12528, 0},
+    {0, 0, 1, -2, 10980, 79661},      {4, 0, -1, 0, 10675, -34782},     {0, 0, 3, 0, 10034, -23210},
+    {4, 0, -2, 0, 8548, -21636},      {2, 1, -1, 0, -7888, 24208},      {2, 1, 0, 0, -6766, 30824},
+    {1, 0, -1, 0, -5163, -8379},      {1, 1, 0, 0, 4987, -16675},       {2, -1, 1, 0, 4036, -12831},
+    {2, 0, 2, 0, 3994, -10445},       {4, 0, 0, 0, 3861, -11650},       {2, 0, -3, 0, 3665, 14403},
+    {0, 1, -2, 0, -2689, -7003},      {2, 0, -1, 2, -2602, 0},          {2, -1, -2, 0, 2390, 10056},
+    {1, 0, 1, 0, -2348, 6322},        {2, -2, 0, 0, 2236, -9884},
+};
+// latitude, 1e-6 deg (r unused)
+static const LunarTerm LUNAR_B[] = {
+    {0, 0, 0, 1, 5128122, 0}, {0, 0, 1, 1, 280602, 0}, {0, 0, 1, -1, 277693, 0}, {2, 0, 0, -1, 173237, 0},
+    {2, 0, -1, 1, 55413, 0},  {2, 0, -1, -1, 46271, 0}, {2, 0, 0, 1, 32573, 0},  {0, 0, 2, 1, 17198, 0},
+    {2, 0, 1, -1, 9266, 0},   {0, 0, 2, -1, 8822, 0},   {2, -1, 0, -1, 8216, 0}, {2, 0, -2, -1, 4324, 0},
+    {2, 0, 1, 1, 4200, 0},    {2, 1, 0, -1, -3359, 0},  {2, -1, -1, 1, 2463, 0}, {2, -1, 0, 1, 2211, 0},
+    {2, -1, -1, -1, 2065, 0}, {0, 1, -1, -1, -1870, 0}, {4, 0, -1, -1, 1828, 0}, {0, 1, 0, 1, -1794, 0},
+};
+
+// Geocentric Moon, ecliptic J2000, AU. The series is referred to the equinox
+// of date, so the longitude is taken back by the general precession.
+static void lunarPosition(double tDays, double out[3]) {
+    const double T = tDays / 36525.0;
+    const double Lp = 218.3164477 + 481267.88123421 * T - 0.0015786 * T * T;
+    const double D = (297.8501921 + 445267.1114034 * T - 0.0018819 * T * T) * DEG;
+    const double M = (357.5291092 + 35999.0502909 * T - 0.0001536 * T * T) * DEG;
+    const double Mp = (134.9633964 + 477198.8675055 * T + 0.0087414 * T * T) * DEG;
+    const double F = (93.2720950 + 483202.0175233 * T - 0.0036539 * T * T) * DEG;
+    const double E = 1.0 - 0.002516 * T - 0.0000074 * T * T;   // Earth's orbit eccentricity factor
+    const double A1 = (119.75 + 131.849 * T) * DEG, A2 = (53.09 + 479264.290 * T) * DEG;
+    const double A3 = (313.45 + 481266.484 * T) * DEG;
+
+    double sl = 0.0, sr = 0.0, sb = 0.0;
+    for (const LunarTerm& k : LUNAR_LR) {
+        const double arg = k.d * D + k.m * M + k.mp * Mp + k.f * F;
+        const double e = k.m == 0 ? 1.0 : (k.m == 1 || k.m == -1) ? E : E * E;
+        sl += e * k.l * std::sin(arg);
+        sr += e * k.r * std::cos(arg);
+    }
+    for (const LunarTerm& k : LUNAR_B) {
+        const double e = k.m == 0 ? 1.0 : (k.m == 1 || k.m == -1) ? E : E * E;
+        sb += e * k.l * std::sin(k.d * D + k.m * M + k.mp * Mp + k.f * F);
+    }
+    const double LpR = Lp * DEG;
+    sl += 3958.0 * std::sin(A1) + 1962.0 * std::sin(LpR - F) + 318.0 * std::sin(A2);
+    sb += -2235.0 * std::sin(LpR) + 382.0 * std::sin(A3) + 175.0 * std::sin(A1 - F) + 175.0 * std::sin(A1 + F)
+          + 127.0 * std::sin(LpR - Mp) - 115.0 * std::sin(LpR + Mp);
+
+    const double precession = (5029.0966 * T + 1.11113 * T * T) / 3600.0;
+    const double lon = (Lp + sl * 1e-6 - precession) * DEG;
+    const double lat = sb * 1e-6 * DEG;
+    const double r = (385000.56 + sr * 1e-3) / AU_KM;
+    out[0] = r * std::cos(lat) * std::cos(lon);
+    out[1] = r * std::cos(lat) * std::sin(lon);
+    out[2] = r * std::sin(lat);
+}
+
+// --- sky state ---
+// Geocentric ecliptic J2000 vectors (AU) and longitudes (deg) by body code.
+struct Sky {
+    double v[10][3];
+    double lon[10];
+};
+
+static void skyAt(const EventSearch& es, double tDays, Sky& sky) {
+    static const std::vector<OrbitalElements> elements = planetElementsJ2000();
+    double helio[24];
+    bool haveDe = es.de && es.de->valid() && es.de->planets(tDays, helio) && es.de->moon(tDays, sky.v[EVENT_MOON]);
+    if (!haveDe) {
+        for (size_t p = 0; p < 8; ++p) keplerPosition(elements[p], 1.0, tDays, helio + 3 * p);
+        lunarPosition(tDays, sky.v[EVENT_MOON]);
+    }
+    const double* earth = helio + 6;
+    for (int p = 0; p < 8; ++p) {
+        for (int a = 0; a < 3; ++a) sky.v[p][a] = helio[3 * p + a] - earth[a];
+    }
+    for (int a = 0; a < 3; ++a) sky.v[EVENT_SUN][a] = -earth[a];
+    for (int b = 0; b < 10; ++b) sky.lon[b] = std::atan2(sky.v[b][1], sky.v[b][0]) / DEG;
+}
+
+static double length(const double v[3]) {
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+// Angle between two directions, radians; flip turns b around (anti-Sun).
+static double separation(const double a[3], const double b[3], bool flip = false) {
+    const double s = flip ? -1.0 : 1.0;
+    const double cx = a[1] * b[2] - a[2] * b[1], cy = a[2] * b[0] - a[0] * b[2], cz = a[0] * b[1] - a[1] * b[0];
+    const double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), s * dot);
+}
+
+static double wrap180(double deg) {
+    deg = std::fmod(deg + 180.0, 360.0);
+    return (deg < 0.0 ? deg + 360.0 : deg) - 180.0;
+}
+
+// --- tracks ---
+// One wrapped longitude difference whose zeros are candidate events.
+struct Track {
+    EventType type;
+    uint8_t a, b;
+    double offset;     // degrees
+};
+
+static std::vector<Track> buildTracks() {
+    std::vector<Track> t;
+    t.push_back({EVENT_SOLAR_ECLIPSE, EVENT_MOON, EVENT_SUN, 0.0});
+    t.push_back({EVENT_LUNAR_ECLIPSE, EVENT_MOON, EVENT_SUN, 180.0});
+    for (uint8_t p = 0; p < 8; ++p) {
+        if (p == 2) continue;
+        t.push_back({EVENT_CONJUNCTION, p, EVENT_SUN, 0.0});
+        if (p > 2) t.push_back({EVENT_OPPOSITION, p, EVENT_SUN, 180.0});
+        for (uint8_t q = p + 1; q < 8; ++q) {
+            if (q != 2) t.push_back({EVENT_CONJUNCTION, p, q, 0.0});
+        }
+    }
+    return t;
+}
+
+static double trackValue(const Track& k, const Sky& sky) {
+    return wrap180(sky.lon[k.a] - sky.lon[k.b] - k.offset);
+}
+
+// Zero of the track in [t0, t1] (bracketed), to ~0.1 s. Illinois regula
+// falsi: the tracks are close to linear over a step, so a handful of
+// evaluations does what bisection needs twenty for.
+static double refineRoot(const EventSearch& es, const Track& k, double t0, double f0, double t1, double f1) {
+    Sky sky;
+    int side = 0;
+    for (int it = 0; it < 60 && t1 - t0 > 1e-6; ++it) {
+        double tm = (t0 * f1 - t1 * f0) / (f1 - f0);
+        if (!(tm > t0 && tm < t1)) tm = 0.5 * (t0 + t1);
+        skyAt(es, tm, sky);
+        const double fm = trackValue(k, sky);
+        if (fm == 0.0) return tm;
+        if ((fm < 0.0) == (f0 < 0.0)) {
+            t0 = tm; f0 = fm;
+            if (side == -1) f1 *= 0.5;
+            side = -1;
+        } else {
+            t1 = tm; f1 = fm;
+            if (side == 1) f0 *= 0.5;
+            side = 1;
+        }
+        if (std::fabs(fm) < 1e-7) return tm;   // ~0.1 s of the Moon's motion
+    }
+    return 0.5 * (t0 + t1);
+}
+
+// Time of least separation of a and b (b flipped for the anti-Sun) near t.
+static double closestApproach(const EventSearch& es, uint8_t a, uint8_t b, bool flip, double t, double halfWidth) {
+    const double g = 0.6180339887498949;
+    double lo = t - halfWidth, hi = t + halfWidth;
+    Sky sky;
+    auto sep = [&](double tt) {
+        skyAt(es, tt, sky);
+        return separation(sky.v[a], sky.v[b], flip);
+    };
+    double x1 = hi - g * (hi - lo), x2 = lo + g * (hi - lo);
+    double f1 = sep(x1), f2 = sep(x2);
+    while (hi - lo > 1e-5) {
+        if (f1 < f2) { hi = x2; x2 = x1; f2 = f1; x1 = hi - g * (hi - lo); f1 = sep(x1); }
+        else { lo = x1; x1 = x2; f1 = f2; x2 = lo + g * (hi - lo); f2 = sep(x2); }
+    }
+    return 0.5 * (lo + hi);
+}
+
+// Turn a refined zero into an event; false when it is not one (a new or full
+// Moon without an eclipse).
+static bool classify(const EventSearch& es, const Track& k, double t, AstroEvent& e) {
+    Sky sky;
+    skyAt(es, t, sky);
+    e.type = k.type;
+    e.kind = EVENT_PARTIAL;
+    e.body = k.a;
+    e.other = k.b;
+    e.magnitude = 0.0f;
+    const double moonLat = std::asin(sky.v[EVENT_MOON][2] / length(sky.v[EVENT_MOON])) / DEG;
+
+    if (k.type == EVENT_SOLAR_ECLIPSE || k.type == EVENT_LUNAR_ECLIPSE) {
+        if (std::fabs(moonLat) > 1.7) return false;   // too far from a node
+        const bool lunar = k.type == EVENT_LUNAR_ECLIPSE;
+        t = closestApproach(es, EVENT_MOON, EVENT_SUN, lunar, t, 0.25);
+        skyAt(es, t, sky);
+        const double dm = length(sky.v[EVENT_MOON]) * AU_KM, ds = length(sky.v[EVENT_SUN]) * AU_KM;
+        const double sSun = std::asin(SUN_RADIUS_KM / ds), sMoon = std::asin(MOON_RADIUS_KM / dm);
+        const double pMoon = std::asin(EARTH_RADIUS_KM / dm), pSun = std::asin(EARTH_RADIUS_KM / ds);
+        const double sep = separation(sky.v[EVENT_MOON], sky.v[EVENT_SUN], lunar);
+        if (!lunar) {
+            // some point of the Earth sees the discs overlap / the shadow axis hits the Earth
+            const double limit = pMoon - pSun + sSun + sMoon;
+            if (sep >= limit) return false;
+            if (sep < pMoon - pSun) {
+                e.kind = sMoon > sSun ? EVENT_TOTAL : EVENT_ANNULAR;
+                e.magnitude = (float)(sMoon / sSun);
+            } else {
+                e.magnitude = (float)((limit - sep) / (2.0 * sSun));
+            }
+        } else {
+            // shadow radii at the Moon's distance, enlarged 2% for the atmosphere
+            const double umbra = 1.02 * (pMoon + pSun - sSun), penumbra = 1.02 * (pMoon + pSun + sSun);
+            if (sep >= penumbra + sMoon) return false;
+            if (sep < umbra - sMoon) e.kind = EVENT_TOTAL;
+            else if (sep < umbra + sMoon) e.kind = EVENT_PARTIAL;
+            else e.kind = EVENT_PENUMBRAL;
+            e.magnitude = (float)(((e.kind == EVENT_PENUMBRAL ? penumbra : umbra) + sMoon - sep) / (2.0 * sMoon));
+        }
+        e.time = ticksFromDays(t);
+        e.separationDeg = (float)(sep / DEG);
+        return true;
+    }
+
+    e.time = ticksFromDays(t);
+    e.separationDeg = (float)(separation(sky.v[k.a], sky.v[k.b], k.type == EVENT_OPPOSITION) / DEG);
+    return true;
+}
+
+// Mercury or Venus passing in front of the Sun at an inferior conjunction.
+static bool transit(const EventSearch& es, const Track& k, double t, AstroEvent& e) {
+    if (k.type != EVENT_CONJUNCTION || k.b != EVENT_SUN || k.a > 1) return false;
+    Sky sky;
+    skyAt(es, t, sky);
+    if (length(sky.v[k.a]) > length(sky.v[EVENT_SUN])) return false;   // superior conjunction
+    t = closestApproach(es, k.a, EVENT_SUN, false, t, 0.5);
+    skyAt(es, t, sky);
+    const double sep = separation(sky.v[k.a], sky.v[EVENT_SUN]);
+    const double sSun = std::asin(SUN_RADIUS_KM / (length(sky.v[EVENT_SUN]) * AU_KM));
+    if (sep >= sSun) return false;
+    e.time = ticksFromDays(t);
+    e.type = EVENT_TRANSIT;
+    e.kind = EVENT_PARTIAL;
+    e.body = k.a;
+    e.other = EVENT_SUN;
+    e.separationDeg = (float)(sep / DEG);
+    e.magnitude = (float)(1.0 - sep / sSun);   // 1 = central
+    return true;
+}
+
+// --- search ---
+// Sweep sample intervals [first, last) of the global grid; an event belongs
+// to the interval that brackets it, so adjacent slabs never report it twice.
+static void sweep(const EventSearch& es, const std::vector<Track>& tracks, double from, size_t first, size_t last,
+                  std::vector<AstroEvent>& out) {
+    Sky sky;
+    std::vector<double> prev(tracks.size()), cur(tracks.size());
+    double tPrev = from + first * es.stepDays;
+    skyAt(es, tPrev, sky);
+    for (size_t k = 0; k < tracks.size(); ++k) prev[k] = trackValue(tracks[k], sky);
+    for (size_t s = first + 1; s <= last; ++s) {
+        const double t = from + s * es.stepDays;
+        skyAt(es, t, sky);
+        for (size_t k = 0; k < tracks.size(); ++k) {
+            cur[k] = trackValue(tracks[k], sky);
+            // a sign change away from the +-180 wrap
+            if ((prev[k] < 0.0) != (cur[k] < 0.0) && std::fabs(prev[k]) < 90.0 && std::fabs(cur[k]) < 90.0) {
+                const double root = refineRoot(es, tracks[k], tPrev, prev[k], t, cur[k]);
+                AstroEvent e;
+                if (classify(es, tracks[k], root, e)) out.push_back(e);
+                if (transit(es, tracks[k], root, e)) out.push_back(e);
+            }
+        }
+        prev.swap(cur);
+        tPrev = t;
+    }
+}
+
+static bool earlier(const AstroEvent& a, const AstroEvent& b) {
+    if (a.time != b.time) return a.time < b.time;
+    return a.type < b.type;
+}
+
+std::vector<AstroEvent> EventSearch::search(double fromDays, double toDays, ThreadPool* pool) const {
+    std::vector<AstroEvent> result;
+    if (!(toDays > fromDays) || stepDays <= 0.0) return result;
+    static const std::vector<Track> tracks = buildTracks();
+
+    // a step of margin on both sides catches events refined across the ends
+    const double from = fromDays - stepDays;
+    const size_t samples = (size_t)std::ceil((toDays + stepDays - from) / stepDays);
+    const size_t perSlab = std::max<size_t>(1, (size_t)(slabDays / stepDays));
+    const size_t slabs = (samples + perSlab - 1) / perSlab;
+    std::vector<std::vector<AstroEvent>> found(slabs);
+    auto run = [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            sweep(*this, tracks, from, s * perSlab, std::min((s + 1) * perSlab, samples), found[s]);
+        }
+    };
+    // batches keep each pool call short; slabs go to whichever thread is free
+    const size_t batch = std::max<size_t>(slabsPerBatch, 1);
+    for (size_t b = 0; b < slabs; b += batch) {
+        const size_t n = std::min(batch, slabs - b);
+        if (pool) pool->parallelFor(n, 1, [&](size_t begin, size_t end) { run(b + begin, b + end); });
+        else run(b, b + n);
+    }
+
+    const SimTicks lo = ticksFromDays(fromDays), hi = ticksFromDays(toDays);
+    for (const auto& list : found) {
+        for (const AstroEvent& e : list) {
+            if (e.time >= lo && e.time < hi) result.push_back(e);
+        }
+    }
+    std::sort(result.begin(), result.end(), earlier);
+    return result;
+}
+
+// --- index ---
+void EventIndex::assign(std::vector<AstroEvent> events) {
+    list = std::move(events);
+    std::sort(list.begin(), list.end(), earlier);
+}
+
+size_t EventIndex::next(SimTicks t, uint32_t typeMask) const {
+    auto it = std::upper_bound(list.begin(), list.end(), t,
+                               [](SimTicks v, const AstroEvent& e) { return v < e.time; });
+    for (; it != list.end(); ++it) {
+        if (typeMask & (1u << it->type)) return (size_t)(it - list.begin());
+    }
+    return list.size();
+}
+
+size_t EventIndex::previous(SimTicks t, uint32_t typeMask) const {
+    auto it = std::lower_bound(list.begin(), list.end(), t,
+                               [](const AstroEvent& e, SimTicks v) { return e.time < v; });
+    while (it != list.begin()) {
+        --it;
+        if (typeMask & (1u << it->type)) return (size_t)(it - list.begin());
+    }
+    return list.size();
+}
+
+const char* eventTypeName(EventType type) {
+    switch (type) {
+    case EVENT_SOLAR_ECLIPSE: return "Solar eclipse";
+    case EVENT_LUNAR_ECLIPSE: return "Lunar eclipse";
+    case EVENT_CONJUNCTION: return "Conjunction";
+    case EVENT_OPPOSITION: return "Opposition";
+    case EVENT_TRANSIT: return "Transit";
+    default: return "?";
+    }
+}
+
+std::string describeEvent(const AstroEvent& e) {
+    static const char* const kinds[] = {"Partial", "Total", "Annular", "Penumbral"};
+    char buf[128];
+    switch (e.type) {
+    case EVENT_SOLAR_ECLIPSE:
+    case EVENT_LUNAR_ECLIPSE:
+        std::snprintf(buf, sizeof(buf), "%s %s, magnitude %.3f", kinds[e.kind],
+                      e.type == EVENT_SOLAR_ECLIPSE ? "solar eclipse" : "lunar eclipse", e.magnitude);
+        break;
+    case EVENT_TRANSIT:
+        std::snprintf(buf, sizeof(buf), "Transit of %s, %.3f deg from the Sun's centre", BODY_NAMES[e.body],
+                      e.separationDeg);
+        break;
+    case EVENT_OPPOSITION:
+        std::snprintf(buf, sizeof(buf), "Opposition of %s", BODY_NAMES[e.body]);
+        break;
+    default:
+        std::snprintf(buf, sizeof(buf), "Conjunction %s - %s, %.2f deg", BODY_NAMES[e.body], BODY_NAMES[e.other],
+                      e.separationDeg);
+        break;
+    }
+    return buf;
+}
@@ -0,0 +1,77 @@
+// src/sim/event_search.h
+// Search for eclipses, conjunctions, oppositions and transits over a time
+// range. Each event is a zero of a wrapped geocentric longitude difference
+// (Moon - Sun, planet - planet, planet - Sun, planet - Sun - 180 deg): a coarse
+// sweep brackets sign changes, regula falsi pins the zero, and for eclipses and
+// transits a golden-section search then moves to the closest approach and
+// classifies it from the apparent radii.
+// Positions come from a JPL DE file where it covers the epoch, else from the
+// J2000 Kepler elements and a truncated lunar series (ELP / Meeus ch. 47,
+// about an arcminute in longitude): eclipses land within minutes over several
+// centuries, planetary events within an hour or two. Times are TT.
+#pragma once
+
+#include "sim_time.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JplEphemeris;
+class ThreadPool;
+
+enum EventType : uint8_t {
+    EVENT_SOLAR_ECLIPSE,
+    EVENT_LUNAR_ECLIPSE,
+    EVENT_CONJUNCTION,     // two planets, or a planet and the Sun
+    EVENT_OPPOSITION,      // Mars..Neptune opposite the Sun
+    EVENT_TRANSIT,         // Mercury or Venus across the Sun
+    EVENT_TYPES
+};
+
+// Eclipse kinds; transits and the rest use EVENT_PARTIAL.
+enum EventKind : uint8_t { EVENT_PARTIAL, EVENT_TOTAL, EVENT_ANNULAR, EVENT_PENUMBRAL };
+
+// Body codes: 0..7 Mercury..Neptune (the order of createSolarSystem()).
+const uint8_t EVENT_SUN = 8;
+const uint8_t EVENT_MOON = 9;
+
+struct AstroEvent {
+    SimTicks time;
+    EventType type;
+    EventKind kind;
+    uint8_t body, other;
+    float separationDeg;   // geocentric, at the event
+    float magnitude;       // eclipses: fraction of the diameter covered
+};
+
+struct EventSearch {
+    const JplEphemeris* de = nullptr;   // optional, used where it has data
+    double stepDays = 1.0;              // sweep spacing; the Moon-Sun angle moves 12 deg/day
+    double slabDays = 64.0;             // sweep range handed to one task
+    size_t slabsPerBatch = 256;         // slabs per pool call, so other users of the pool interleave
+
+    // Every event with time in [fromDays, toDays), sorted by time.
+    std::vector<AstroEvent> search(double fromDays, double toDays, ThreadPool* pool = nullptr) const;
+};
+
+// Events sorted by time, for "next eclipse" style queries.
+class EventIndex {
+public:
+    void assign(std::vector<AstroEvent> list);
+    void clear() { list.clear(); }
+    const std::vector<AstroEvent>& events() const { return list; }
+
+    // First event after t / last before t whose type is in typeMask
+    // (bit 1 << EventType). Returns events().size() when there is none.
+    size_t next(SimTicks t, uint32_t typeMask = ~0u) const;
+    size_t previous(SimTicks t, uint32_t typeMask = ~0u) const;
+
+private:
+    std::vector<AstroEvent> list;
+};
+
+const char* eventTypeName(EventType type);
+// e.g. "Total solar eclipse", "Conjunction Jupiter - Saturn 1.10 deg".
+std::string describeEvent(const AstroEvent& e);
@@ -0,0 +1,233 @@
+// src/sim/gravity_assist.cpp
+#include "gravity_assist.h"
+#include "kepler.h"
+#include "lambert.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static double norm3(const double v[3]) {
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+// Powered flyby in the planet frame: the change in excess speed, plus a
+// rotation of the slower vector through whatever part of the turn the planet
+// cannot give with periapsis at rp.
+static double flybyDeltaV(const double vIn[3], const double vOut[3], double mu, double rp) {
+    const double a = norm3(vIn), b = norm3(vOut);
+    const double c = std::max(-1.0, std::min(1.0, (vIn[0] * vOut[0] + vIn[1] * vOut[1] + vIn[2] * vOut[2]) / (a * b)));
+    const double turn = std::acos(c);
+    const double maxTurn = 2.0 * std::asin(1.0 / (1.0 + rp * a * a / mu));
+    double dv = std::fabs(b - a);
+    if (turn > maxTurn) dv += 2.0 * std::min(a, b) * std::sin(0.5 * (turn - maxTurn));
+    return dv;
+}
+
+// --- one top-level task: a departure date and a first target ---
+struct SearchTask {
+    GravityAssistSearch& search;
+    const GravityAssistSpec& spec;
+    const std::vector<OrbitalElements>& els;
+    const std::vector<double>& masses;
+    const std::vector<double>& radii;       // km
+    const SimdLevel level;
+    std::vector<LambertSoA> soa;            // one batch per depth
+    GravityAssistPath path;                 // the branch being expanded
+    uint64_t legs = 0, pruned = 0;
+
+    struct Child {
+        int body;
+        double t, cost, step;
+        double vSc[3], vPlanet[3];          // spacecraft and planet velocity on arrival, AU/day
+    };
+
+    void planetState(int body, double t, double r[3], double v[3]) const {
+        keplerState(els[body], 1.0 + masses[body], t, r, v);
+    }
+
+    double hohmannDays(int a, int b) const {
+        const double s = 0.5 * (els[a].a + els[b].a);
+        return 0.5 * TWO_PI * std::sqrt(s * s * s) / GAUSS_K;
+    }
+
+    // Bodies the leg after `depth` legs may go to.
+    void targets(size_t depth, int body, std::vector<int>& out) const {
+        out.clear();
+        if (!spec.sequence.empty() || spec.maxFlybys <= 0) {
+            if (depth < spec.sequence.size()) out.push_back(spec.sequence[depth]);
+            else if (depth == spec.sequence.size()) out.push_back(spec.to);
+            return;
+        }
+        if ((int)depth < spec.maxFlybys) {
+            for (int b : spec.flybyBodies) {
+                if (b != body && b != spec.to) out.push_back(b);
+            }
+        }
+        if (body != spec.to) out.push_back(spec.to);
+    }
+
+    // Leaving `body` at t: vPlanet is the planet's velocity, vIn the
+    // spacecraft's arrival velocity (unused at launch), cost the partial sum.
+    void expand(size_t depth, int body, double t, const double vPlanet[3], const double vIn[3], double cost,
+                int onlyTarget) {
+        if (search.cancelled) return;
+        const double kms = AU_KM / 86400.0;
+        const double mu = GAUSS_K * GAUSS_K;
+        if (soa.size() <= depth) soa.resize(depth + 1);
+        LambertSoA& batch = soa[depth];
+        const size_t n = std::max<size_t>(spec.tofSteps, 1);
+
+        std::vector<int> next;
+        if (onlyTarget >= 0) next.push_back(onlyTarget);
+        else targets(depth, body, next);
+
+        double r1[3], dummy[3];
+        planetState(body, t, r1, dummy);
+        std::vector<Child> children;
+        for (int target : next) {
+            const double tH = hohmannDays(body, target);
+            batch.resize(n);
+            std::vector<double> vArrive(3 * n);
+            for (size_t k = 0; k < n; ++k) {
+                const double f = n > 1 ? (double)k / (double)(n - 1) : 0.0;
+                const double tof = tH * (spec.tofMin + f * (spec.tofMax - spec.tofMin));
+                double r2[3];
+                planetState(target, t + tof, r2, &vArrive[3 * k]);
+                batch.x1[k] = r1[0]; batch.y1[k] = r1[1]; batch.z1[k] = r1[2];
+                batch.x2[k] = r2[0]; batch.y2[k] = r2[1]; batch.z2[k] = r2[2];
+                batch.tof[k] = tof;
+            }
+            solveLambertBatch(batch, mu, level, 0, n);
+            legs += n;
+
+            for (size_t k = 0; k < n; ++k) {
+                const double tArrive = t + batch.tof[k];
+                if (std::isnan(batch.vx1[k]) || tArrive - path.days[0] > spec.maxDays) continue;
+                const double vOut[3] = {batch.vx1[k] - vPlanet[0], batch.vy1[k] - vPlanet[1], batch.vz1[k] - vPlanet[2]};
+                double step;
+                if (depth == 0) {
+                    step = norm3(vOut) * kms;
+                    if (step * step > spec.maxLaunchC3) continue;
+                } else {
+                    const double rp = spec.minFlybyRadius * radii[body] / AU_KM;
+                    step = flybyDeltaV(vIn, vOut, mu * masses[body], rp) * kms;
+                }
+                Child c;
+                c.body = target;
+                c.t = tArrive;
+                c.vSc[0] = batch.vx2[k]; c.vSc[1] = batch.vy2[k]; c.vSc[2] = batch.vz2[k];
+                for (int a = 0; a < 3; ++a) c.vPlanet[a] = vArrive[3 * k + a];
+                c.step = step;
+                c.cost = cost + step;
+                if (target == spec.to) {
+                    const double vInf[3] = {c.vSc[0] - c.vPlanet[0], c.vSc[1] - c.vPlanet[1], c.vSc[2] - c.vPlanet[2]};
+                    const double arrive = spec.rendezvous ? norm3(vInf) * kms : 0.0;
+                    if (c.cost + arrive < search.bound) {
+                        GravityAssistPath done = path;
+                        done.deltaV.push_back(step);
+                        done.bodies.push_back(target);
+                        done.days.push_back(tArrive);
+                        done.deltaV.push_back(arrive);
+                        done.total = c.cost + arrive;
+                        search.offer(done);
+                    } else {
+                        ++pruned;
+                    }
+                    continue;
+                }
+                if (c.cost < search.bound) children.push_back(c);
+                else ++pruned;
+            }
+        }
+
+        // cheapest first, so good bounds turn up early
+        std::sort(children.begin(), children.end(), [](const Child& a, const Child& b) { return a.cost < b.cost; });
+        for (const Child& c : children) {
+            if (search.cancelled) return;
+            if (c.cost >= search.bound) {
+                ++pruned;
+                continue;
+            }
+            const double vInRel[3] = {c.vSc[0] - c.vPlanet[0], c.vSc[1] - c.vPlanet[1], c.vSc[2] - c.vPlanet[2]};
+            path.deltaV.push_back(c.step);
+            path.bodies.push_back(c.body);
+            path.days.push_back(c.t);
+            expand(depth + 1, c.body, c.t, c.vPlanet, vInRel, c.cost, -1);
+            path.deltaV.pop_back();
+            path.bodies.pop_back();
+            path.days.pop_back();
+        }
+    }
+};
+
+// --- search ---
+void GravityAssistSearch::offer(const GravityAssistPath& path) {
+    std::lock_guard<std::mutex> lock(bestMutex);
+    if (path.total < bestPath.total) {
+        bestPath = path;
+        bound = path.total;
+    }
+}
+
+GravityAssistPath GravityAssistSearch::best() const {
+    std::lock_guard<std::mutex> lock(bestMutex);
+    return bestPath;
+}
+
+GravityAssistPath GravityAssistSearch::run(const GravityAssistSpec& spec, ThreadPool* pool) {
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(bestMutex);
+        bestPath = GravityAssistPath();
+    }
+    bound = 1e30;
+    cancelled = false;
+    done = total = 0;
+    legsSolved = pruned = 0;
+
+    const std::vector<OrbitalElements> els = planetElementsJ2000();
+    const std::vector<double> masses = planetMassesSolar();
+    const std::vector<double> radii = planetRadiiKm();
+    auto known = [&](int b) { return b >= 0 && b < (int)els.size(); };
+    bool ok = known(spec.from) && known(spec.to) && spec.from != spec.to && spec.departSteps > 0;
+    for (int b : spec.sequence) ok = ok && known(b);
+    for (int b : spec.flybyBodies) ok = ok && known(b);
+    if (!ok) return GravityAssistPath();
+
+    const SimdLevel level = detectSimdLevel();
+    std::vector<int> first;
+    SearchTask probe{*this, spec, els, masses, radii, level, {}, {}, 0, 0};
+    probe.targets(0, spec.from, first);
+    const size_t tasks = spec.departSteps * first.size();
+    total = tasks;
+
+    auto run = [&](size_t begin, size_t end) {
+        SearchTask task{*this, spec, els, masses, radii, level, {}, {}, 0, 0};
+        for (size_t k = begin; k < end && !cancelled; ++k) {
+            const size_t d = k / first.size();
+            const double f = spec.departSteps > 1 ? (double)d / (double)(spec.departSteps - 1) : 0.0;
+            const double t = spec.departStart + f * spec.departSpan;
+            double r[3], v[3];
+            task.planetState(spec.from, t, r, v);
+            task.path = GravityAssistPath();
+            task.path.bodies.push_back(spec.from);
+            task.path.days.push_back(t);
+            task.expand(0, spec.from, t, v, v, 0.0, first[k % first.size()]);
+            ++done;
+        }
+        legsSolved += task.legs;
+        pruned += task.pruned;
+    };
+    // short pool calls, so other users of the pool get a turn and cancel is seen
+    const size_t batch = pool ? 2 * (size_t)pool->size() : 1;
+    for (size_t b = 0; b < tasks && !cancelled; b += batch) {
+        const size_t n = std::min(batch, tasks - b);
+        if (pool) pool->parallelFor(n, 1, [&](size_t begin, size_t end) { run(b + begin, b + end); });
+        else run(b, b + n);
+    }
+
+    wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return best();
+}
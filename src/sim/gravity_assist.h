@@ -0,0 +1,79 @@
+// src/sim/gravity_assist.h
+// Multiple gravity-assist trajectory search (e.g. Earth-Venus-Earth-Jupiter).
+// A trajectory is a chain of Lambert legs between planets on the J2000 mean
+// elements. Its cost is the launch excess speed, plus a powered-flyby
+// Delta-v at every intermediate planet, plus the arrival excess speed if the
+// search is for a rendezvous. The flyby Delta-v is the change in excess speed
+// plus whatever part of the turn the planet cannot provide at the minimum
+// flyby radius.
+//
+// Branch and bound, depth first: a node is (planet, date, incoming velocity).
+// All the dates for the next leg are solved as one Lambert batch, and the
+// children are visited cheapest first. Every cost term is non-negative, so a
+// branch is dropped as soon as its partial cost reaches the best complete
+// trajectory found by any thread. The top-level tasks (departure date, first
+// target) are run on the pool in short batches. Between batches, and inside
+// every node, the search checks for cancellation and updates its progress.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class ThreadPool;
+
+struct GravityAssistSpec {
+    int from = 2, to = 4;                   // planetElementsJ2000() indices (2 = Earth, 4 = Jupiter)
+    std::vector<int> sequence;              // fixed flyby planets in order; empty = explore
+    std::vector<int> flybyBodies = {1, 2, 3};   // what exploring may fly by (Venus, Earth, Mars)
+    int maxFlybys = 3;                      // when exploring
+    double departStart = 0.0, departSpan = 730.0;   // days since J2000
+    size_t departSteps = 74;
+    // each leg's time of flight: tofSteps values between these multiples of
+    // the leg's Hohmann time
+    size_t tofSteps = 32;
+    double tofMin = 0.3, tofMax = 2.5;
+    double maxLaunchC3 = 40.0;              // km^2/s^2
+    double maxDays = 3652.5;                // launch to arrival
+    double minFlybyRadius = 1.1;            // planet radii
+    bool rendezvous = true;                 // count the arrival excess speed
+};
+
+struct GravityAssistPath {
+    std::vector<int> bodies;                // launch planet, flybys, target
+    std::vector<double> days;               // encounter dates, days since J2000
+    std::vector<double> deltaV;             // km/s: launch vInf, each flyby, arrival vInf (0 if not counted)
+    double total = 1e30;                    // km/s
+
+    bool valid() const { return !bodies.empty(); }
+};
+
+class GravityAssistSearch {
+public:
+    // Blocks until done or cancelled; returns the best trajectory found
+    // (invalid if none). Safe to call again once it has returned.
+    GravityAssistPath run(const GravityAssistSpec& spec, ThreadPool* pool = nullptr);
+
+    // From any thread while run() is going.
+    void cancel() { cancelled = true; }
+    bool wasCancelled() const { return cancelled; }
+    float progress() const { return total ? (float)done / (float)total : 0.0f; }
+    GravityAssistPath best() const;   // best so far
+
+    // statistics of the last (or current) run
+    std::atomic<uint64_t> legsSolved{0};     // Lambert solutions examined
+    std::atomic<uint64_t> pruned{0};         // branches cut by the bound
+    double wallSeconds = 0.0;
+
+private:
+    friend struct SearchTask;
+    void offer(const GravityAssistPath& path);
+
+    std::atomic<bool> cancelled{false};
+    std::atomic<size_t> done{0}, total{0};
+    std::atomic<double> bound{1e30};
+    mutable std::mutex bestMutex;
+    GravityAssistPath bestPath;
+};
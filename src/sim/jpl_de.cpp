@@ -0,0 +1,214 @@
+// src/sim/jpl_de.cpp
+#include "jpl_de.h"
+#include "kepler.h"
+#include "thread_pool.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+// --- record 1 layout ---
+static const size_t OFF_SS = 252 + 400 * 6;        // after 3 title lines and 400 constant names
+static const size_t OFF_NCON = OFF_SS + 24;
+static const size_t OFF_AU = OFF_NCON + 4;
+static const size_t OFF_EMRAT = OFF_AU + 8;
+static const size_t OFF_IPT = OFF_EMRAT + 8;       // 12 x 3 int32 (planets, Moon, Sun, nutations)
+static const size_t OFF_NUMDE = OFF_IPT + 12 * 12;
+static const size_t OFF_LPT = OFF_NUMDE + 4;       // librations
+static const size_t OFF_EXTRA_NAMES = OFF_LPT + 12; // DE430+: names beyond 400, then TT-TDB pointers
+
+// mean obliquity of J2000 (IAU 1976, as used with the DE frame tie)
+static const double EPS_J2000 = 84381.448 / 3600.0 * TWO_PI / 360.0;
+
+template <typename T>
+static T readAt(const char* base, size_t off) {
+    T v;
+    std::memcpy(&v, base + off, sizeof(T));
+    return v;
+}
+
+bool JplEphemeris::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    const char* h = file.data();
+    if (file.size() < OFF_EXTRA_NAMES) {
+        std::cerr << "DE file too small: " << path << "\n";
+        close();
+        return false;
+    }
+
+    deNumber = readAt<int32_t>(h, OFF_NUMDE);
+    if (deNumber < 100 || deNumber > 2000) {
+        // big-endian files would need swapping every coefficient, which
+        // defeats reading in place
+        std::cerr << "Unsupported DE file (wrong byte order?): " << path << "\n";
+        close();
+        return false;
+    }
+    jdStart = readAt<double>(h, OFF_SS);
+    jdEnd = readAt<double>(h, OFF_SS + 8);
+    jdStep = readAt<double>(h, OFF_SS + 16);
+    const int32_t ncon = readAt<int32_t>(h, OFF_NCON);
+    auKm = readAt<double>(h, OFF_AU);
+    emrat = readAt<double>(h, OFF_EMRAT);
+
+    int32_t all[15][3] = {};
+    for (int i = 0; i < 12; ++i) {
+        for (int k = 0; k < 3; ++k) all[i][k] = readAt<int32_t>(h, OFF_IPT + (i * 3 + k) * 4);
+    }
+    for (int k = 0; k < 3; ++k) all[12][k] = readAt<int32_t>(h, OFF_LPT + k * 4);
+    if (ncon > 400) {
+        size_t off = OFF_EXTRA_NAMES + (size_t)(ncon - 400) * 6;
+        if (off + 12 <= file.size()) {
+            for (int k = 0; k < 3; ++k) all[13][k] = readAt<int32_t>(h, off + k * 4);
+        }
+    }
+    std::memcpy(ipt, all, sizeof(ipt));
+
+    // record length: the furthest coefficient any series reaches
+    // (nutations have 2 components, TT-TDB 1, everything else 3)
+    size_t ncoeff = 0;
+    for (int i = 0; i < 14; ++i) {
+        if (all[i][0] <= 0 || all[i][1] <= 0 || all[i][2] <= 0) continue;
+        int comps = i == 11 ? 2 : (i == 13 ? 1 : 3);
+        size_t end = (size_t)all[i][0] - 1 + (size_t)all[i][1] * all[i][2] * comps;
+        if (end > ncoeff) ncoeff = end;
+    }
+    recordDoubles = ncoeff;
+    const size_t recBytes = ncoeff * sizeof(double);
+    if (ncoeff == 0 || jdStep <= 0.0 || file.size() < 3 * recBytes) {
+        std::cerr << "Malformed DE header: " << path << "\n";
+        close();
+        return false;
+    }
+    // records 0 and 1 are the header and the constants
+    recordCount = file.size() / recBytes - 2;
+    const size_t spanned = (size_t)std::llround((jdEnd - jdStart) / jdStep);
+    if (spanned < recordCount) recordCount = spanned;
+    jdEnd = jdStart + recordCount * jdStep;
+    return true;
+}
+
+void JplEphemeris::close() {
+    file.close();
+    recordCount = 0;
+    recordDoubles = 0;
+    deNumber = 0;
+}
+
+const double* JplEphemeris::record(double jd, double& recStart) const {
+    if (!valid() || !(jd >= jdStart && jd <= jdEnd)) return nullptr;
+    size_t r = (size_t)((jd - jdStart) / jdStep);
+    if (r >= recordCount) r = recordCount - 1;    // jd == end
+    const double* rec = (const double*)file.data() + (2 + r) * recordDoubles;
+    recStart = rec[0];
+    return rec;
+}
+
+bool JplEphemeris::state(DeBody body, double tDays, double pos[3], double vel[3]) const {
+    double recStart;
+    const double* rec = record(JD_J2000 + tDays, recStart);
+    if (!rec) return false;
+    // (J2000 - recStart) + t keeps the sub-day part of tDays intact
+    return stateIn((int)body, rec, (JD_J2000 - recStart) + tDays, pos, vel);
+}
+
+bool JplEphemeris::stateTicks(DeBody body, SimTicks t, double pos[3], double vel[3]) const {
+    if (!valid()) return false;
+    // record boundaries are whole (or half) days, exact in ticks
+    const SimTicks step = ticksFromDays(jdStep);
+    const SimTicks off = t - ticksFromDays(jdStart - JD_J2000);
+    if (step <= 0 || off < 0 || off > step * (SimTicks)recordCount) return false;
+    size_t r = (size_t)(off / step);
+    if (r >= recordCount) r = recordCount - 1;    // t == end
+    const double* rec = (const double*)file.data() + (2 + r) * recordDoubles;
+    return stateIn((int)body, rec, ticksToDays(off - (SimTicks)r * step), pos, vel);
+}
+
+bool JplEphemeris::stateIn(int b, const double* rec, double dt, double pos[3], double vel[3]) const {
+    const size_t nc = (size_t)ipt[b][1], ns = (size_t)ipt[b][2];
+    if (nc == 0 || ns == 0) return false;
+    const double sub = jdStep / (double)ns;
+    size_t s = (size_t)(dt / sub);
+    if (s >= ns) s = ns - 1;
+    const double x = 2.0 * (dt - s * sub) / sub - 1.0;
+    const double* c = rec + (ipt[b][0] - 1) + s * 3 * nc;
+
+    for (int ax = 0; ax < 3; ++ax) {
+        const double* a = c + ax * nc;
+        double t0 = 1.0, t1 = x, d0 = 0.0, d1 = 1.0;
+        double p = a[0] + (nc > 1 ? a[1] * x : 0.0);
+        double v = nc > 1 ? a[1] : 0.0;
+        for (size_t k = 2; k < nc; ++k) {
+            double t2 = 2.0 * x * t1 - t0;
+            double d2 = 2.0 * t1 + 2.0 * x * d1 - d0;
+            p += a[k] * t2;
+            v += a[k] * d2;
+            t0 = t1; t1 = t2; d0 = d1; d1 = d2;
+        }
+        pos[ax] = p;
+        if (vel) vel[ax] = v * 2.0 / sub;
+    }
+    return true;
+}
+
+// ICRF (equatorial) km -> ecliptic J2000 AU
+static void toEcliptic(const double in[3], double au, double out[3]) {
+    const double ce = std::cos(EPS_J2000), se = std::sin(EPS_J2000);
+    out[0] = in[0] / au;
+    out[1] = (ce * in[1] + se * in[2]) / au;
+    out[2] = (-se * in[1] + ce * in[2]) / au;
+}
+
+template <class State> bool JplEphemeris::planetsAt(State state, double* out) const {
+    double sun[3], moonGeo[3];
+    if (!state(DeBody::Sun, sun) || !state(DeBody::Moon, moonGeo)) return false;
+    const DeBody order[8] = {DeBody::Mercury, DeBody::Venus, DeBody::EMB, DeBody::Mars,
+                             DeBody::Jupiter, DeBody::Saturn, DeBody::Uranus, DeBody::Neptune};
+    for (int i = 0; i < 8; ++i) {
+        double p[3];
+        if (!state(order[i], p)) return false;
+        if (order[i] == DeBody::EMB) {
+            // Earth = EMB - Moon / (1 + EMRAT)
+            for (int k = 0; k < 3; ++k) p[k] -= moonGeo[k] / (1.0 + emrat);
+        }
+        for (int k = 0; k < 3; ++k) p[k] -= sun[k];
+        toEcliptic(p, auKm, out + 3 * i);
+    }
+    return true;
+}
+
+bool JplEphemeris::planets(double tDays, double* out) const {
+    return planetsAt([&](DeBody b, double* p) { return state(b, tDays, p); }, out);
+}
+
+bool JplEphemeris::planetsTicks(SimTicks t, double* out) const {
+    return planetsAt([&](DeBody b, double* p) { return stateTicks(b, t, p); }, out);
+}
+
+void JplEphemeris::planetsBatch(const double* epochs, size_t count, double* out, ThreadPool* pool) const {
+    auto range = [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; ++e) {
+            if (!planets(epochs[e], out + e * 24)) {
+                for (int k = 0; k < 24; ++k) out[e * 24 + k] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+    };
+    if (pool) pool->parallelFor(count, 256, range);
+    else range(0, count);
+}
+
+bool JplEphemeris::moon(double tDays, double pos[3]) const {
+    double p[3];
+    if (!state(DeBody::Moon, tDays, p)) return false;
+    toEcliptic(p, auKm, pos);
+    return true;
+}
+
+bool JplEphemeris::moonTicks(SimTicks t, double pos[3]) const {
+    double p[3];
+    if (!stateTicks(DeBody::Moon, t, p)) return false;
+    toEcliptic(p, auKm, pos);
+    return true;
+}
@@ -0,0 +1,66 @@
+// src/sim/jpl_de.h
+// Reader for JPL DE binary ephemerides (DE405..DE441 "linux_*" / "*.bin"
+// files). The file is memory-mapped and the Chebyshev records are evaluated
+// where they lie: nothing is parsed beyond the header, nothing is copied.
+// DE native frame/units are ICRF, km, TDB Julian days; the helpers below
+// convert to this project's heliocentric ecliptic J2000 AU and days since J2000.
+#pragma once
+
+#include "mapped_file.h"
+#include "sim_time.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ThreadPool;
+
+// Series stored in a DE file, in file order.
+enum class DeBody { Mercury = 0, Venus, EMB, Mars, Jupiter, Saturn, Uranus, Neptune, Pluto, Moon, Sun };
+
+class JplEphemeris {
+public:
+    bool open(const std::string& path);
+    void close();
+    bool valid() const { return recordCount > 0; }
+
+    int version() const { return deNumber; }
+    double startDays() const { return jdStart - JD_J2000; }
+    double endDays() const { return jdEnd - JD_J2000; }
+    double au() const { return auKm; }
+    double earthMoonRatio() const { return emrat; }
+
+    // Raw series: km and km/day, ICRF. The Moon is geocentric, everything
+    // else barycentric. vel may be nullptr. False outside the file's span.
+    bool state(DeBody body, double tDays, double pos[3], double vel[3] = nullptr) const;
+    // On the simulation clock: record and offset from integer ticks.
+    bool stateTicks(DeBody body, SimTicks t, double pos[3], double vel[3] = nullptr) const;
+
+    // Heliocentric ecliptic J2000 positions (AU) of Mercury..Neptune, Earth
+    // itself rather than the Earth-Moon barycentre. out = 24 doubles.
+    bool planets(double tDays, double* out) const;
+    bool planetsTicks(SimTicks t, double* out) const;
+    // Batched: out[(e * 8 + planet) * 3 + axis] for every epoch (days since
+    // J2000). Epochs outside the span yield NaN. Splits across the pool.
+    void planetsBatch(const double* epochs, size_t count, double* out, ThreadPool* pool = nullptr) const;
+    // Geocentric Moon, ecliptic J2000, AU.
+    bool moon(double tDays, double pos[3]) const;
+    bool moonTicks(SimTicks t, double pos[3]) const;
+
+private:
+    static constexpr double JD_J2000 = 2451545.0;
+
+    const double* record(double jd, double& recStart) const;
+    // Series of `body` at dt days into record rec.
+    bool stateIn(int body, const double* rec, double dt, double pos[3], double vel[3]) const;
+    // state(t, ...) or stateTicks(t, ...), bound to one time
+    template <class State> bool planetsAt(State state, double* out) const;
+
+    MappedFile file;
+    int deNumber = 0;
+    double jdStart = 0.0, jdEnd = 0.0, jdStep = 0.0;
+    double auKm = 0.0, emrat = 0.0;
+    int32_t ipt[11][3] = {};      // 1-based offset, coefficients, sub-intervals
+    size_t recordDoubles = 0;
+    size_t recordCount = 0;
+};
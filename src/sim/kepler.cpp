@@ -0,0 +1,254 @@
+// src/sim/kepler.cpp
+#include "kepler.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const size_t KEPLER_PAD = 8;   // widest pack (AVX2)
+
+SimdLevel detectSimdLevel() {
+#if defined(SOLAR_X86_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE41: return "SSE4.1";
+        default: return "scalar";
+    }
+}
+
+KeplerPropagator::KeplerPropagator() : level(detectSimdLevel()) {}
+
+void KeplerPropagator::resizePadded(size_t n) {
+    size_t padded = (n + KEPLER_PAD - 1) / KEPLER_PAD * KEPLER_PAD;
+    // inert padding: a = b = 0 keeps the output at the origin
+    soa.meanMotion.resize(padded, 0.0); soa.meanAnomaly0.resize(padded, 0.0); soa.epoch.resize(padded, 0.0);
+    soa.e.resize(padded, 0.0f); soa.a.resize(padded, 0.0f); soa.b.resize(padded, 0.0f);
+    soa.px.resize(padded, 0.0f); soa.py.resize(padded, 0.0f); soa.pz.resize(padded, 0.0f);
+    soa.qx.resize(padded, 0.0f); soa.qy.resize(padded, 0.0f); soa.qz.resize(padded, 0.0f);
+    soa.M.resize(padded, 0.0f);
+    soa.x.resize(padded, 0.0f); soa.y.resize(padded, 0.0f); soa.z.resize(padded, 0.0f);
+}
+
+size_t KeplerPropagator::add(const OrbitalElements& el, double mu) {
+    size_t k = soa.count;
+    resizePadded(k + 1);
+    soa.count = k + 1;
+
+    double cO = cos(el.raan), sO = sin(el.raan);
+    double cw = cos(el.argPeri), sw = sin(el.argPeri);
+    double ci = cos(el.i), si = sin(el.i);
+
+    soa.meanMotion[k] = GAUSS_K * sqrt(mu / (el.a * el.a * el.a));
+    soa.meanAnomaly0[k] = el.M0;
+    soa.epoch[k] = el.epoch;
+    soa.e[k] = (float)el.e;
+    soa.a[k] = (float)el.a;
+    soa.b[k] = (float)(el.a * sqrt(1.0 - el.e * el.e));
+    soa.px[k] = (float)(cw * cO - sw * sO * ci);
+    soa.py[k] = (float)(cw * sO + sw * cO * ci);
+    soa.pz[k] = (float)(sw * si);
+    soa.qx[k] = (float)(-sw * cO - cw * sO * ci);
+    soa.qy[k] = (float)(-sw * sO + cw * cO * ci);
+    soa.qz[k] = (float)(cw * si);
+    return k;
+}
+
+void KeplerPropagator::clear() {
+    soa = KeplerSoA();
+}
+
+void KeplerPropagator::propagate(double tDays) {
+    const size_t n = soa.M.size();
+    const size_t chunk = 8192;   // multiple of every pack width
+    if (pool && n > chunk) {
+        pool->parallelFor(n, chunk, [&](size_t b, size_t e) { propagateRange(tDays, b, e); });
+    } else {
+        propagateRange(tDays, 0, n);
+    }
+}
+
+void KeplerPropagator::propagateRange(double tDays, size_t begin, size_t end) {
+    // Mean anomaly in double, reduced to [-pi, pi) so the float kernel never
+    // sees a large argument.
+    for (size_t k = begin; k < end; ++k) {
+        double M = soa.meanAnomaly0[k] + soa.meanMotion[k] * (tDays - soa.epoch[k]);
+        M -= TWO_PI * std::floor(M / TWO_PI + 0.5);
+        soa.M[k] = (float)M;
+    }
+
+    switch (level) {
+#if defined(SOLAR_X86_KERNELS)
+        case SimdLevel::AVX2: simd_avx2::keplerKernel(soa, begin, end, newtonIterations); break;
+        case SimdLevel::SSE41: simd_sse41::keplerKernel(soa, begin, end, newtonIterations); break;
+#endif
+        default: simd_scalar::keplerKernel(soa, begin, end, newtonIterations); break;
+    }
+}
+
+double solveKepler(double M, double e) {
+    double E = M + e * sin(M);
+    for (int it = 0; it < 50; ++it) {
+        double dE = (E - e * sin(E) - M) / (1.0 - e * cos(E));
+        E -= dE;
+        if (std::fabs(dE) < 1e-14) break;
+    }
+    return E;
+}
+
+void keplerState(const OrbitalElements& el, double mu, double tDays, double pos[3], double vel[3]) {
+    double n = GAUSS_K * sqrt(mu / (el.a * el.a * el.a));
+    double M = std::fmod(el.M0 + n * (tDays - el.epoch), TWO_PI);
+    double E = solveKepler(M, el.e);
+    double cE = cos(E), sE = sin(E);
+    double b = el.a * sqrt(1.0 - el.e * el.e);
+    double u = el.a * (cE - el.e);
+    double w = b * sE;
+    double Edot = n / (1.0 - el.e * cE);
+    double du = -el.a * sE * Edot;
+    double dw = b * cE * Edot;
+
+    double cO = cos(el.raan), sO = sin(el.raan);
+    double cw = cos(el.argPeri), sw = sin(el.argPeri);
+    double ci = cos(el.i), si = sin(el.i);
+    double P[3] = {cw * cO - sw * sO * ci, cw * sO + sw * cO * ci, sw * si};
+    double Q[3] = {-sw * cO - cw * sO * ci, -sw * sO + cw * cO * ci, cw * si};
+    for (int k = 0; k < 3; ++k) {
+        pos[k] = u * P[k] + w * Q[k];
+        vel[k] = du * P[k] + dw * Q[k];
+    }
+}
+
+void stumpff(double z, double& C, double& S) {
+    if (z > 1e-6) {
+        const double s = std::sqrt(z);
+        C = (1.0 - std::cos(s)) / z;
+        S = (s - std::sin(s)) / (s * z);
+    } else if (z < -1e-6) {
+        const double s = std::sqrt(-z);
+        C = (std::cosh(s) - 1.0) / -z;
+        S = (std::sinh(s) - s) / (s * -z);
+    } else {
+        C = 0.5 - z / 24.0 + z * z / 720.0;
+        S = 1.0 / 6.0 - z / 120.0 + z * z / 5040.0;
+    }
+}
+
+void propagateConic(const double r0[3], const double v0[3], double mu, double dtDays, double r[3], double v[3]) {
+    const double r0n = std::sqrt(r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2]);
+    const double v0sq = v0[0] * v0[0] + v0[1] * v0[1] + v0[2] * v0[2];
+    const double rv = r0[0] * v0[0] + r0[1] * v0[1] + r0[2] * v0[2];
+    const double sqrtMu = std::sqrt(mu);
+    const double alpha = 2.0 / r0n - v0sq / mu;   // 1/a
+    double dt = dtDays;
+    if (alpha > 1e-12) {
+        // whole revolutions change nothing
+        const double period = TWO_PI / (sqrtMu * alpha * std::sqrt(alpha));
+        dt -= period * std::round(dt / period);
+    }
+
+    if (dt == 0.0) {
+        for (int k = 0; k < 3; ++k) {
+            r[k] = r0[k];
+            v[k] = v0[k];
+        }
+        return;
+    }
+
+    // starting guess (Vallado), then Laguerre-Conway on the universal Kepler
+    // equation F(x) = 0. F rises with x, so every evaluation narrows a bracket
+    // and steps leaving it fall back to bisection (or doubling while one side is open).
+    const double inf = std::numeric_limits<double>::infinity();
+    double lo = dt < 0.0 ? -inf : 0.0, hi = dt < 0.0 ? 0.0 : inf;
+    double x;
+    if (alpha > 1e-12) {
+        x = sqrtMu * dt * alpha;
+    } else if (alpha < -1e-12) {
+        const double a = 1.0 / alpha, sgn = dt < 0.0 ? -1.0 : 1.0;
+        const double arg = -2.0 * mu * alpha * dt / (rv + sgn * std::sqrt(-mu * a) * (1.0 - r0n * alpha));
+        x = arg > 0.0 ? sgn * std::sqrt(-a) * std::log(arg) : sqrtMu * dt / r0n;
+    } else {
+        x = sqrtMu * dt / r0n;
+    }
+    if (!(x > lo && x < hi)) x = sqrtMu * dt / r0n;
+    const double sigma = rv / sqrtMu;
+    double C = 0.5, S = 1.0 / 6.0, z = 0.0;
+    for (int it = 0; it < 200; ++it) {
+        z = alpha * x * x;
+        stumpff(z, C, S);
+        const double F = sigma * x * x * C + (1.0 - alpha * r0n) * x * x * x * S + r0n * x - sqrtMu * dt;
+        const double dF = sigma * x * (1.0 - z * S) + (1.0 - alpha * r0n) * x * x * C + r0n;
+        const double ddF = sigma * (1.0 - z * C) + (1.0 - alpha * r0n) * x * (1.0 - z * S);
+        if (F < 0.0) lo = x;
+        else hi = x;   // including NaN: only a far overshoot overflows
+        const double disc = std::sqrt(std::fabs(16.0 * dF * dF - 20.0 * F * ddF));
+        double next = x - 5.0 * F / (dF + (dF < 0.0 ? -disc : disc));
+        if (!(next > lo && next < hi)) {
+            if (hi == inf) next = 2.0 * lo;
+            else if (lo == -inf) next = 2.0 * hi;
+            else next = 0.5 * (lo + hi);
+        }
+        const bool done = std::fabs(next - x) <= 1e-13 * std::max(1.0, std::fabs(x));
+        x = next;
+        if (done) break;
+    }
+    z = alpha * x * x;
+    stumpff(z, C, S);
+
+    const double f = 1.0 - x * x / r0n * C;
+    const double g = dt - x * x * x * S / sqrtMu;
+    for (int k = 0; k < 3; ++k) r[k] = f * r0[k] + g * v0[k];
+    const double rn = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    const double fdot = sqrtMu / (rn * r0n) * (z * S - 1.0) * x;
+    const double gdot = 1.0 - x * x / rn * C;
+    for (int k = 0; k < 3; ++k) v[k] = fdot * r0[k] + gdot * v0[k];
+}
+
+void keplerPosition(const OrbitalElements& el, double mu, double tDays, double out[3]) {
+    double vel[3];
+    keplerState(el, mu, tDays, out, vel);
+}
+
+std::vector<OrbitalElements> planetElementsJ2000() {
+    // a, e, I, L, long.peri, long.node (Standish, JPL approximate elements)
+    const double tbl[8][6] = {
+        { 0.38709927, 0.20563593,  7.00497902, 252.25032350,  77.45779628,  48.33076593},
+        { 0.72333566, 0.00677672,  3.39467605, 181.97909950, 131.60246718,  76.67984255},
+        { 1.00000261, 0.01671123, -0.00001531, 100.46457166, 102.93768193,   0.0},
+        { 1.52371034, 0.09339410,  1.84969142,  -4.55343205, -23.94362959,  49.55953891},
+        { 5.20288700, 0.04838624,  1.30439695,  34.39644051,  14.72847983, 100.47390909},
+        { 9.53667594, 0.05386179,  2.48599187,  49.95424423,  92.59887831, 113.66242448},
+        {19.18916464, 0.04725744,  0.77263783, 313.23810451, 170.95427630,  74.01692503},
+        {30.06992276, 0.00859048,  1.77004347, -55.12002969,  44.96476227, 131.78422574}
+    };
+    const double d2r = TWO_PI / 360.0;
+    std::vector<OrbitalElements> out;
+    for (const auto &r : tbl) {
+        OrbitalElements el;
+        el.a = r[0];
+        el.e = r[1];
+        el.i = r[2] * d2r;
+        el.raan = r[5] * d2r;
+        el.argPeri = (r[4] - r[5]) * d2r;
+        el.M0 = (r[3] - r[4]) * d2r;
+        el.epoch = 0.0;
+        out.push_back(el);
+    }
+    return out;
+}
+
+std::vector<double> planetMassesSolar() {
+    return {1.6601e-7, 2.4478e-6, 3.0404e-6, 3.2272e-7, 9.5479e-4, 2.8589e-4, 4.3662e-5, 5.1514e-5};
+}
+
+std::vector<double> planetRadiiKm() {
+    return {2439.7, 6051.8, 6371.0, 3389.5, 69911.0, 58232.0, 25362.0, 24622.0};
+}
@@ -0,0 +1,92 @@
+// src/sim/kepler.h
+// Keplerian two-body propagation over structure-of-arrays storage.
+// Units: AU, days, radians; heliocentric ecliptic J2000 frame (z = ecliptic north).
+// Simulated time 0 is the J2000.0 epoch (JD 2451545.0).
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+const double GAUSS_K = 0.01720209895;      // rad/day, sqrt(GM_sun) in AU^1.5/day
+const double AU_KM = 149597870.7;
+const double TWO_PI = 6.283185307179586;
+
+struct OrbitalElements {
+    double a;          // semi-major axis
+    double e;          // eccentricity (< 1)
+    double i;          // inclination
+    double raan;       // longitude of ascending node (Omega)
+    double argPeri;    // argument of periapsis (omega)
+    double M0;         // mean anomaly at epoch
+    double epoch;      // days since J2000
+};
+
+enum class SimdLevel { Scalar, SSE41, AVX2 };
+
+SimdLevel detectSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// Per-body data the kernels read, one array per field. Arrays are padded to a
+// multiple of the widest pack with inert bodies so kernels never need a tail loop.
+struct KeplerSoA {
+    size_t count = 0;
+    std::vector<double> meanMotion, meanAnomaly0, epoch;
+    std::vector<float> e, a, b;                  // b = a*sqrt(1-e^2)
+    std::vector<float> px, py, pz, qx, qy, qz;   // perifocal basis in ecliptic frame
+    std::vector<float> M;                        // scratch: reduced mean anomaly
+    std::vector<float> x, y, z;                  // output positions
+};
+
+class KeplerPropagator {
+public:
+    KeplerPropagator();
+
+    // mu is the central mass in solar masses (1 for heliocentric orbits).
+    size_t add(const OrbitalElements& el, double mu = 1.0);
+    void clear();
+    size_t size() const { return soa.count; }
+
+    // Solve Kepler's equation for every body at tDays and refresh x()/y()/z().
+    void propagate(double tDays);
+
+    const float* x() const { return soa.x.data(); }
+    const float* y() const { return soa.y.data(); }
+    const float* z() const { return soa.z.data(); }
+
+    SimdLevel level;           // defaults to the best the CPU supports
+    int newtonIterations = 6;  // enough for e < ~0.9 from the e*sin(M) starter
+    ThreadPool* pool = nullptr; // split large populations across threads
+
+private:
+    void resizePadded(size_t n);
+    void propagateRange(double tDays, size_t begin, size_t end);
+    KeplerSoA soa;
+};
+
+// Double-precision single-body helpers for callers that need exact state vectors.
+void keplerPosition(const OrbitalElements& el, double mu, double tDays, double out[3]);
+void keplerState(const OrbitalElements& el, double mu, double tDays, double pos[3], double vel[3]);
+double solveKepler(double M, double e);
+// Stumpff functions C(z) = (1 - cos sqrt z) / z and S(z) = (sqrt z - sin sqrt z) / z^1.5, either sign of z.
+void stumpff(double z, double& C, double& S);
+// Two-body state dtDays after (r0, v0) on any conic (universal variables); mu in AU^3/day^2.
+// Unlike keplerDrift (nbody.h) it starts hyperbolas from the logarithmic guess and
+// iterates with Laguerre-Conway, so drifts of many periapsis times still converge.
+void propagateConic(const double r0[3], const double v0[3], double mu, double dtDays, double r[3], double v[3]);
+
+// J2000 mean elements for Mercury..Neptune (Earth = Earth-Moon barycentre),
+// same order as createSolarSystem().
+std::vector<OrbitalElements> planetElementsJ2000();
+// Planet masses in solar masses, same order.
+std::vector<double> planetMassesSolar();
+// Mean planet radii in km, same order.
+std::vector<double> planetRadiiKm();
+
+// --- kernels, one build per ISA ---
+namespace simd_scalar { void keplerKernel(KeplerSoA& soa, size_t begin, size_t end, int iterations); }
+#if defined(SOLAR_X86_KERNELS)
+namespace simd_sse41 { void keplerKernel(KeplerSoA& soa, size_t begin, size_t end, int iterations); }
+namespace simd_avx2 { void keplerKernel(KeplerSoA& soa, size_t begin, size_t end, int iterations); }
+#endif
@@ -0,0 +1,3 @@
+// src/sim/kepler_avx2.cpp
+// AVX2/FMA build of the Kepler kernel (compiled with -mavx2 -mfma).
+#include "kepler_kernel.inl"
@@ -0,0 +1,37 @@
+// src/sim/kepler_kernel.inl
+// Kepler solve + perifocal rotation, written once against PackF. Included by
+// kepler_{scalar,sse,avx2}.cpp, each compiled with its own ISA flags.
+#include "kepler.h"
+#include "simd_pack.h"
+
+namespace SIMD_NS {
+
+void keplerKernel(KeplerSoA& soa, size_t begin, size_t end, int iterations) {
+    const int W = PackF::width;
+    for (size_t k = begin; k < end; k += W) {
+        const PackF M = PackF::load(&soa.M[k]);
+        const PackF e = PackF::load(&soa.e[k]);
+
+        PackF sM, cM;
+        sincos(M, sM, cM);
+        PackF E = fmadd(e, sM, M);
+        for (int it = 0; it < iterations; ++it) {
+            PackF sE, cE;
+            sincos(E, sE, cE);
+            const PackF f = E - fmadd(e, sE, M);
+            const PackF fp = PackF(1.0f) - e * cE;
+            E = E - f / fp;
+        }
+
+        PackF sE, cE;
+        sincos(E, sE, cE);
+        const PackF u = PackF::load(&soa.a[k]) * (cE - e);
+        const PackF w = PackF::load(&soa.b[k]) * sE;
+
+        fmadd(u, PackF::load(&soa.px[k]), w * PackF::load(&soa.qx[k])).store(&soa.x[k]);
+        fmadd(u, PackF::load(&soa.py[k]), w * PackF::load(&soa.qy[k])).store(&soa.y[k]);
+        fmadd(u, PackF::load(&soa.pz[k]), w * PackF::load(&soa.qz[k])).store(&soa.z[k]);
+    }
+}
+
+} // namespace SIMD_NS
@@ -0,0 +1,4 @@
+// src/sim/kepler_scalar.cpp
+// Baseline build of the Kepler kernel; the fallback on every platform.
+#define SIMD_FORCE_SCALAR
+#include "kepler_kernel.inl"
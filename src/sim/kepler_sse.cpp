@@ -0,0 +1,4 @@
+// src/sim/kepler_sse.cpp
+// SSE4.1 build of the Kepler kernel (compiled with -msse4.1).
+#define SIMD_FORCE_SSE41
+#include "kepler_kernel.inl"
@@ -0,0 +1,68 @@
+// src/sim/lambert.cpp
+#include "lambert.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LambertSoA::resize(size_t n) {
+    count = n;
+    const size_t padded = (n + 7) / 8 * 8;
+    for (std::vector<double>* v : {&x1, &y1, &z1, &x2, &y2, &z2, &tof, &vx1, &vy1, &vz1, &vx2, &vy2, &vz2}) {
+        v->resize(padded);
+    }
+}
+
+// --- reference ---
+bool solveLambert(const double r1v[3], const double r2v[3], double tofDays, double mu, double v1[3], double v2[3]) {
+    if (!(tofDays > 0.0)) return false;
+    const double r1 = std::sqrt(r1v[0] * r1v[0] + r1v[1] * r1v[1] + r1v[2] * r1v[2]);
+    const double r2 = std::sqrt(r2v[0] * r2v[0] + r2v[1] * r2v[1] + r2v[2] * r2v[2]);
+    const double cosNu = (r1v[0] * r2v[0] + r1v[1] * r2v[1] + r1v[2] * r2v[2]) / (r1 * r2);
+    const bool longWay = r1v[0] * r2v[1] - r1v[1] * r2v[0] < 0.0;
+    const double A = (longWay ? -1.0 : 1.0) * std::sqrt(r1 * r2 * (1.0 + cosNu));
+    if (A == 0.0) return false;   // 180 degree transfer: the plane is undefined
+    const double target = std::sqrt(mu) * tofDays;
+
+    auto yOf = [&](double z) {
+        double C, S;
+        stumpff(z, C, S);
+        return r1 + r2 + A * (z * S - 1.0) / std::sqrt(C);
+    };
+    auto F = [&](double z, double& y) {
+        double C, S;
+        stumpff(z, C, S);
+        y = r1 + r2 + A * (z * S - 1.0) / std::sqrt(C);
+        if (y < 0.0) return -1.0;
+        const double q = y / C;
+        return q * std::sqrt(q) * S + A * std::sqrt(y) - target;
+    };
+
+    double lo = LAMBERT_Z_MIN, hi = LAMBERT_Z_MAX, y;
+    if (F(lo, y) > 0.0) return false;
+    while (hi - lo > 1e-14 * std::max(1.0, std::fabs(lo))) {
+        const double z = 0.5 * (lo + hi);
+        if (z == lo || z == hi) break;
+        if (F(z, y) < 0.0) lo = z;
+        else hi = z;
+    }
+    y = yOf(0.5 * (lo + hi));
+    if (y < 0.0) return false;
+    const double f = 1.0 - y / r1, gdot = 1.0 - y / r2, g = A * std::sqrt(y / mu);
+    for (int k = 0; k < 3; ++k) {
+        v1[k] = (r2v[k] - f * r1v[k]) / g;
+        v2[k] = (gdot * r2v[k] - r1v[k]) / g;
+    }
+    return true;
+}
+
+// --- batches ---
+void solveLambertBatch(LambertSoA& soa, double mu, SimdLevel level, size_t begin, size_t end) {
+    end = std::min((end + 7) / 8 * 8, soa.x1.size());   // whole packs; the padding is there for this
+    switch (level) {
+#if defined(SOLAR_X86_KERNELS)
+        case SimdLevel::AVX2: simd_avx2::lambertKernel(soa, mu, begin, end); break;
+        case SimdLevel::SSE41: simd_sse41::lambertKernel(soa, mu, begin, end); break;
+#endif
+        default: simd_scalar::lambertKernel(soa, mu, begin, end); break;
+    }
+}
@@ -0,0 +1,42 @@
+// src/sim/lambert.h
+// Lambert's problem: the two-body arc from r1 to r2 in a given time of
+// flight, in the universal-variable form (Bate, Mueller & White ch. 5).
+// Time of flight grows monotonically with z = (universal anomaly)^2 / a, so
+// bisection on z always finds the single zero-revolution solution. Only the
+// prograde arc (angular momentum towards ecliptic north) is solved.
+// Units: AU, days; mu in AU^3/day^2 (GAUSS_K^2 for the Sun).
+#pragma once
+
+#include "kepler.h"
+
+#include <cstddef>
+#include <vector>
+
+// Range of z searched: hyperbolas down to z = -160, ellipses up to a full revolution.
+const double LAMBERT_Z_MIN = -160.0;
+const double LAMBERT_Z_MAX = 39.47841760435743;   // (2 pi)^2
+
+// One transfer per entry. Arrays are padded to a multiple of the widest pack;
+// the padding lanes compute garbage nobody reads.
+struct LambertSoA {
+    size_t count = 0;
+    std::vector<double> x1, y1, z1, x2, y2, z2, tof;        // inputs
+    std::vector<double> vx1, vy1, vz1, vx2, vy2, vz2;       // outputs, NaN if unsolved
+
+    void resize(size_t n);
+};
+
+// Double-precision reference solve; false if there is no prograde
+// zero-revolution arc (tof <= 0 or a hyperbola beyond the search range).
+bool solveLambert(const double r1[3], const double r2[3], double tofDays, double mu, double v1[3], double v2[3]);
+
+// Solve entries [begin, end) of a batch with the kernel for `level`.
+// begin must be a multiple of 4.
+void solveLambertBatch(LambertSoA& soa, double mu, SimdLevel level, size_t begin, size_t end);
+
+// --- kernels, one build per ISA ---
+namespace simd_scalar { void lambertKernel(LambertSoA& soa, double mu, size_t begin, size_t end); }
+#if defined(SOLAR_X86_KERNELS)
+namespace simd_sse41 { void lambertKernel(LambertSoA& soa, double mu, size_t begin, size_t end); }
+namespace simd_avx2 { void lambertKernel(LambertSoA& soa, double mu, size_t begin, size_t end); }
+#endif
@@ -0,0 +1,3 @@
+// src/sim/lambert_avx2.cpp
+// AVX2/FMA build of the Lambert kernel (compiled with -mavx2 -mfma).
+#include "lambert_kernel.inl"
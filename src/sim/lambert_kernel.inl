@@ -0,0 +1,95 @@
+// src/sim/lambert_kernel.inl
+// Universal-variable Lambert solve written once against PackD. Included by
+// lambert_{scalar,sse,avx2}.cpp, each compiled with its own ISA flags.
+// Every lane runs the same fixed bisection, so there are no divergent loops.
+#include "lambert.h"
+#include "simd_pack.h"
+
+#include <limits>
+
+namespace SIMD_NS {
+
+static const int BISECTIONS = 52;   // (Z_MAX - Z_MIN) / 2^52 ~ 4e-14
+static const int DOUBLINGS = 6;     // z shrunk by 4^6 before the series
+
+// Stumpff functions C(z), S(z) without trig: series for c0..c3 at z / 4^6,
+// then the doubling identities c(4x) from c(x) six times. Covers both signs.
+static inline void stumpff(PackD z, PackD& C, PackD& S) {
+    const PackD x = z * PackD(1.0 / 4096.0);
+    // c2 = sum (-x)^k / (2k+2)!, c3 = sum (-x)^k / (2k+3)!, |x| < 0.04
+    PackD c2 = fmadd(x, PackD(1.0 / 3628800.0), PackD(-1.0 / 40320.0));
+    c2 = fmadd(c2, x, PackD(1.0 / 720.0));
+    c2 = fmadd(c2, x, PackD(-1.0 / 24.0));
+    c2 = fmadd(c2, x, PackD(0.5));
+    PackD c3 = fmadd(x, PackD(1.0 / 39916800.0), PackD(-1.0 / 362880.0));
+    c3 = fmadd(c3, x, PackD(1.0 / 5040.0));
+    c3 = fmadd(c3, x, PackD(-1.0 / 120.0));
+    c3 = fmadd(c3, x, PackD(1.0 / 6.0));
+    PackD c0 = PackD(1.0) - x * c2;
+    PackD c1 = PackD(1.0) - x * c3;
+    for (int k = 0; k < DOUBLINGS; ++k) {
+        const PackD n3 = fmadd(c0, c3, c2) * PackD(0.25);
+        const PackD n2 = c1 * c1 * PackD(0.5);
+        c1 = c0 * c1;
+        c0 = fmadd(PackD(2.0) * c0, c0, PackD(-1.0));
+        c2 = n2;
+        c3 = n3;
+    }
+    C = c2;
+    S = c3;
+}
+
+void lambertKernel(LambertSoA& soa, double mu, size_t begin, size_t end) {
+    const int W = PackD::width;
+    const PackD zero(0.0), one(1.0), half(0.5);
+    const PackD nan(std::numeric_limits<double>::quiet_NaN());
+    const PackD sqrtMu(std::sqrt(mu));
+    for (size_t k = begin; k < end; k += W) {
+        const PackD x1 = PackD::load(&soa.x1[k]), y1 = PackD::load(&soa.y1[k]), z1 = PackD::load(&soa.z1[k]);
+        const PackD x2 = PackD::load(&soa.x2[k]), y2 = PackD::load(&soa.y2[k]), z2 = PackD::load(&soa.z2[k]);
+        const PackD r1 = sqrt(x1 * x1 + y1 * y1 + z1 * z1);
+        const PackD r2 = sqrt(x2 * x2 + y2 * y2 + z2 * z2);
+        const PackD cosNu = (x1 * x2 + y1 * y2 + z1 * z2) / (r1 * r2);
+        // short way when the arc is prograde, long way otherwise
+        const PackD longWay = cmpLt(x1 * y2 - y1 * x2, zero);
+        const PackD Aabs = sqrt(r1 * r2 * (one + cosNu));
+        const PackD A = select(longWay, Aabs, -Aabs);
+        const PackD target = sqrtMu * PackD::load(&soa.tof[k]);
+        const PackD rSum = r1 + r2;
+
+        auto yOf = [&](PackD z, PackD& C, PackD& S) {
+            stumpff(z, C, S);
+            return fmadd(A, fmadd(z, S, -one) / sqrt(C), rSum);
+        };
+
+        PackD lo(LAMBERT_Z_MIN), hi(LAMBERT_Z_MAX);
+        for (int it = 0; it < BISECTIONS; ++it) {
+            const PackD z = (lo + hi) * half;
+            PackD C, S;
+            const PackD y = yOf(z, C, S);
+            const PackD yPos = max(y, zero);
+            const PackD q = yPos / C;
+            const PackD F = fmadd(q * sqrt(q), S, A * sqrt(yPos)) - target;
+            // y < 0 only happens below the root (short way, z too small)
+            const PackD below = maskOr(cmpLt(y, zero), cmpLt(F, zero));
+            lo = select(below, lo, z);
+            hi = select(below, z, hi);
+        }
+
+        PackD C, S;
+        const PackD y = yOf((lo + hi) * half, C, S);
+        // lo never moved: the time of flight is shorter than the range allows
+        const PackD failed = maskOr(cmpEq(lo, PackD(LAMBERT_Z_MIN)), cmpLt(y, zero));
+        const PackD f = one - y / r1;
+        const PackD gdot = one - y / r2;
+        const PackD gInv = one / (A * sqrt(y) / sqrtMu);
+        select(failed, (x2 - f * x1) * gInv, nan).store(&soa.vx1[k]);
+        select(failed, (y2 - f * y1) * gInv, nan).store(&soa.vy1[k]);
+        select(failed, (z2 - f * z1) * gInv, nan).store(&soa.vz1[k]);
+        select(failed, (gdot * x2 - x1) * gInv, nan).store(&soa.vx2[k]);
+        select(failed, (gdot * y2 - y1) * gInv, nan).store(&soa.vy2[k]);
+        select(failed, (gdot * z2 - z1) * gInv, nan).store(&soa.vz2[k]);
+    }
+}
+
+} // namespace SIMD_NS
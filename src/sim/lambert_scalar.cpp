@@ -0,0 +1,4 @@
+// src/sim/lambert_scalar.cpp
+// Baseline build of the Lambert kernel; the fallback on every platform.
+#define SIMD_FORCE_SCALAR
+#include "lambert_kernel.inl"
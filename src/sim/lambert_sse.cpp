@@ -0,0 +1,4 @@
+// src/sim/lambert_sse.cpp
+// SSE4.1 build of the Lambert kernel (compiled with -msse4.1).
+#define SIMD_FORCE_SSE41
+#include "lambert_kernel.inl"
@@ -0,0 +1,29 @@
+// src/sim/mapped_file.h
+// Read-only memory mapping of a whole file (mmap / MapViewOfFile).
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const { return (const char*)view; }
+    size_t size() const { return bytes; }
+    bool valid() const { return view != nullptr; }
+
+private:
+    void* view = nullptr;
+    size_t bytes = 0;
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#endif
+};
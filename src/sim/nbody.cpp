@@ -0,0 +1,342 @@
+// src/sim/nbody.cpp
+#include "nbody.h"
+#include "kepler.h"
+#include "solar_sim.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+const char* integratorName(Integrator integrator) {
+    switch (integrator) {
+        case Integrator::Leapfrog: return "Leapfrog";
+        case Integrator::Yoshida4: return "Yoshida 4";
+        case Integrator::DOP853: return "DOP853";
+        default: return "Wisdom-Holman";
+    }
+}
+
+void NBodyState::add(const std::string& name, double gmBody, const double pos[3], const double vel[3]) {
+    names.push_back(name);
+    gm.push_back(gmBody);
+    x.push_back(pos[0]); y.push_back(pos[1]); z.push_back(pos[2]);
+    vx.push_back(vel[0]); vy.push_back(vel[1]); vz.push_back(vel[2]);
+}
+
+void NBodyState::toBarycentric() {
+    double m = 0.0, c[6] = {0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i < size(); ++i) {
+        m += gm[i];
+        c[0] += gm[i] * x[i]; c[1] += gm[i] * y[i]; c[2] += gm[i] * z[i];
+        c[3] += gm[i] * vx[i]; c[4] += gm[i] * vy[i]; c[5] += gm[i] * vz[i];
+    }
+    if (m <= 0.0) return;
+    for (auto &v : c) v /= m;
+    for (size_t i = 0; i < size(); ++i) {
+        x[i] -= c[0]; y[i] -= c[1]; z[i] -= c[2];
+        vx[i] -= c[3]; vy[i] -= c[4]; vz[i] -= c[5];
+    }
+}
+
+NBodySim::NBodySim(ThreadPool* pool) : pool(pool) {}
+
+void NBodySim::setState(const NBodyState& s, double tDays) {
+    st = s;
+    time = tDays;
+    steps = 0;
+    forceEvaluations = 0;
+    rejectedSteps = 0;
+    accValid = false;
+    dop.fsal = false;
+    dop.denseReady = false;
+    dop.h = 0.0;
+    massive.clear();
+    for (size_t i = 0; i < st.size(); ++i) {
+        if (st.gm[i] > 0.0) massive.push_back(i);
+    }
+    const size_t n = st.size();
+    ax.assign(n, 0.0); ay.assign(n, 0.0); az.assign(n, 0.0);
+    hx.assign(n, 0.0); hy.assign(n, 0.0); hz.assign(n, 0.0);
+    energy0 = energy();
+}
+
+void NBodySim::saveState(std::vector<double>& out) const {
+    const size_t n = st.size();
+    out.resize(3 + 6 * n);
+    out[0] = time;
+    out[1] = energy0;
+    out[2] = dop.h;
+    const std::vector<double>* comps[6] = {&st.x, &st.y, &st.z, &st.vx, &st.vy, &st.vz};
+    for (int c = 0; c < 6; ++c) std::copy(comps[c]->begin(), comps[c]->end(), out.begin() + 3 + c * n);
+}
+
+bool NBodySim::restoreState(const std::vector<double>& in) {
+    const size_t n = st.size();
+    if (in.size() != 3 + 6 * n) return false;
+    time = in[0];
+    energy0 = in[1];
+    dop.h = in[2];
+    std::vector<double>* comps[6] = {&st.x, &st.y, &st.z, &st.vx, &st.vy, &st.vz};
+    for (int c = 0; c < 6; ++c) std::copy(in.begin() + 3 + c * n, in.begin() + 3 + (c + 1) * n, comps[c]->begin());
+    // forces and stages are recomputed from the restored positions
+    accValid = false;
+    dop.fsal = false;
+    dop.denseReady = false;
+    return true;
+}
+
+void NBodySim::accelerations(const std::vector<double>& px, const std::vector<double>& py,
+                             const std::vector<double>& pz, size_t firstSource) {
+    ++forceEvaluations;
+    const size_t n = st.size();
+    if (forceMethod == ForceMethod::BarnesHut) {
+        sources.clear();
+        for (size_t j : massive) {
+            if (j >= firstSource) sources.push_back(j);
+        }
+        tree.build(px.data(), py.data(), pz.data(), st.gm.data(), sources, pool);
+        tree.accelerations(px.data(), py.data(), pz.data(), n, ax.data(), ay.data(), az.data(), pool);
+        return;
+    }
+
+    auto range = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            double sx = 0.0, sy = 0.0, sz = 0.0;
+            const double xi = px[i], yi = py[i], zi = pz[i];
+            for (size_t j : massive) {
+                if (j == i || j < firstSource) continue;
+                double dx = px[j] - xi, dy = py[j] - yi, dz = pz[j] - zi;
+                double r2 = dx*dx + dy*dy + dz*dz;
+                double inv = st.gm[j] / (r2 * sqrt(r2));
+                sx += dx * inv; sy += dy * inv; sz += dz * inv;
+            }
+            ax[i] = sx; ay[i] = sy; az[i] = sz;
+        }
+    };
+    if (pool && n >= 256) pool->parallelFor(n, 64, range);
+    else range(0, n);
+}
+
+void NBodySim::leapfrog(double dt) {
+    const size_t n = st.size();
+    if (!accValid) accelerations(st.x, st.y, st.z, 0);
+    const double h = 0.5 * dt;
+    for (size_t i = 0; i < n; ++i) {
+        st.vx[i] += h * ax[i]; st.vy[i] += h * ay[i]; st.vz[i] += h * az[i];
+        st.x[i] += dt * st.vx[i]; st.y[i] += dt * st.vy[i]; st.z[i] += dt * st.vz[i];
+    }
+    accelerations(st.x, st.y, st.z, 0);
+    for (size_t i = 0; i < n; ++i) {
+        st.vx[i] += h * ax[i]; st.vy[i] += h * ay[i]; st.vz[i] += h * az[i];
+    }
+    accValid = true;
+}
+
+// Democratic-heliocentric Wisdom-Holman (kick-drift-kick), as in WHFast:
+// heliocentric positions, barycentric velocities, Kepler drift about the Sun,
+// planet-planet interaction kicks and the linear "jump" of the Sun's momentum.
+void NBodySim::wisdomHolman(double dt) {
+    const size_t n = st.size();
+    const double gm0 = st.gm[0];
+    const double h = 0.5 * dt;
+
+    for (size_t i = 1; i < n; ++i) {
+        hx[i] = st.x[i] - st.x[0]; hy[i] = st.y[i] - st.y[0]; hz[i] = st.z[i] - st.z[0];
+    }
+
+    auto jump = [&](double tau) {
+        double px = 0.0, py = 0.0, pz = 0.0;
+        for (size_t j : massive) {
+            if (j == 0) continue;
+            px += st.gm[j] * st.vx[j]; py += st.gm[j] * st.vy[j]; pz += st.gm[j] * st.vz[j];
+        }
+        px *= tau / gm0; py *= tau / gm0; pz *= tau / gm0;
+        for (size_t i = 1; i < n; ++i) { hx[i] += px; hy[i] += py; hz[i] += pz; }
+    };
+    auto kick = [&]() {
+        for (size_t i = 1; i < n; ++i) {
+            st.vx[i] += h * ax[i]; st.vy[i] += h * ay[i]; st.vz[i] += h * az[i];
+        }
+    };
+
+    if (!accValid) accelerations(hx, hy, hz, 1);
+    kick();
+    jump(h);
+    auto drift = [&](size_t begin, size_t end) {
+        for (size_t i = std::max<size_t>(begin, 1); i < end; ++i) {
+            double r[3] = {hx[i], hy[i], hz[i]};
+            double v[3] = {st.vx[i], st.vy[i], st.vz[i]};
+            keplerDrift(gm0, r, v, dt);
+            hx[i] = r[0]; hy[i] = r[1]; hz[i] = r[2];
+            st.vx[i] = v[0]; st.vy[i] = v[1]; st.vz[i] = v[2];
+        }
+    };
+    if (pool && n >= 256) pool->parallelFor(n, 64, drift);
+    else drift(0, n);
+    jump(h);
+    accelerations(hx, hy, hz, 1);
+    kick();
+    accValid = true;
+
+    // back to barycentric positions and the Sun's velocity
+    double mt = gm0, sx = 0.0, sy = 0.0, sz = 0.0, svx = 0.0, svy = 0.0, svz = 0.0;
+    for (size_t j : massive) {
+        if (j == 0) continue;
+        mt += st.gm[j];
+        sx += st.gm[j] * hx[j]; sy += st.gm[j] * hy[j]; sz += st.gm[j] * hz[j];
+        svx += st.gm[j] * st.vx[j]; svy += st.gm[j] * st.vy[j]; svz += st.gm[j] * st.vz[j];
+    }
+    st.x[0] = -sx / mt; st.y[0] = -sy / mt; st.z[0] = -sz / mt;
+    st.vx[0] = -svx / gm0; st.vy[0] = -svy / gm0; st.vz[0] = -svz / gm0;
+    for (size_t i = 1; i < n; ++i) {
+        st.x[i] = hx[i] + st.x[0]; st.y[i] = hy[i] + st.y[0]; st.z[i] = hz[i] + st.z[0];
+    }
+}
+
+void NBodySim::step(double dt) {
+    if (integrator != accIntegrator) {
+        accValid = false;   // cached forces differ per scheme
+        dop.fsal = false;
+    }
+    accIntegrator = integrator;
+
+    switch (integrator) {
+        case Integrator::DOP853:
+            dt = dop853Step(dt);
+            break;
+        case Integrator::Leapfrog:
+            leapfrog(dt);
+            break;
+        case Integrator::Yoshida4: {
+            const double cbrt2 = std::cbrt(2.0);
+            const double w1 = 1.0 / (2.0 - cbrt2);
+            const double w0 = -cbrt2 / (2.0 - cbrt2);
+            leapfrog(w1 * dt);
+            leapfrog(w0 * dt);
+            leapfrog(w1 * dt);
+            break;
+        }
+        default:
+            wisdomHolman(dt);
+            break;
+    }
+    time += dt;
+    ++steps;
+}
+
+int NBodySim::advanceTo(double tEnd, double dtMax, int maxSteps,
+                        const std::function<void(double t0, double t1)>& onStep) {
+    int taken = 0;
+    while (time < tEnd && taken < maxSteps) {
+        const double t0 = time;
+        if (integrator == Integrator::DOP853) {
+            step(dtMax);   // no clipping to tEnd: the dense output covers it
+        } else {
+            double remaining = tEnd - time;
+            int n = (int)std::ceil(remaining / dtMax);
+            step(remaining / (n > 0 ? n : 1));
+        }
+        ++taken;
+        if (onStep) onStep(t0, time);
+    }
+    return taken;
+}
+
+double NBodySim::energy() const {
+    double e = 0.0;
+    const size_t n = st.size();
+    for (size_t i = 0; i < n; ++i) {
+        e += 0.5 * st.gm[i] * (st.vx[i]*st.vx[i] + st.vy[i]*st.vy[i] + st.vz[i]*st.vz[i]);
+    }
+    for (size_t a = 0; a < massive.size(); ++a) {
+        for (size_t b = a + 1; b < massive.size(); ++b) {
+            size_t i = massive[a], j = massive[b];
+            double dx = st.x[i] - st.x[j], dy = st.y[i] - st.y[j], dz = st.z[i] - st.z[j];
+            e -= st.gm[i] * st.gm[j] / sqrt(dx*dx + dy*dy + dz*dz);
+        }
+    }
+    return e;
+}
+
+double NBodySim::energyDrift() const {
+    if (energy0 == 0.0) return 0.0;
+    return std::fabs((energy() - energy0) / energy0);
+}
+
+void NBodySim::heliocentric(size_t i, double out[3]) const {
+    out[0] = st.x[i] - st.x[0];
+    out[1] = st.y[i] - st.y[0];
+    out[2] = st.z[i] - st.z[0];
+}
+
+bool NBodySim::heliocentricAt(size_t i, double t, double out[3]) {
+    if (integrator == Integrator::DOP853 && dop.fsal && accIntegrator == Integrator::DOP853) {
+        if (t < dop.t0 || t > time) return false;
+        if (!dop.denseReady) dop853Dense();
+        double p[3], sun[3];
+        dop853Position(i, t, p);
+        dop853Position(0, t, sun);
+        for (int k = 0; k < 3; ++k) out[k] = p[k] - sun[k];
+        return true;
+    }
+    heliocentric(i, out);
+    return t == time;
+}
+
+// --- universal-variable Kepler drift ---
+void keplerDrift(double mu, double r[3], double v[3], double dt) {
+    const double r0 = sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+    const double v2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+    const double rv = r[0]*v[0] + r[1]*v[1] + r[2]*v[2];
+    const double alpha = 2.0 / r0 - v2 / mu;
+    const double sqmu = sqrt(mu);
+
+    // whole revolutions of a bound orbit change nothing
+    if (alpha > 0.0) {
+        double period = TWO_PI / sqrt(mu * alpha * alpha * alpha);
+        dt = std::fmod(dt, period);
+    }
+
+    double chi = alpha > 0.0 ? sqmu * dt * alpha : sqmu * dt / r0;
+    double c2 = 0.5, c3 = 1.0 / 6.0, psi = 0.0, rr = r0;
+    for (int it = 0; it < 50; ++it) {
+        psi = chi * chi * alpha;
+        stumpff(psi, c2, c3);
+        double chi2 = chi * chi;
+        rr = chi2 * c2 + rv / sqmu * chi * (1.0 - psi * c3) + r0 * (1.0 - psi * c2);
+        double f = rv / sqmu * chi2 * c2 + (1.0 - alpha * r0) * chi2 * chi * c3 + r0 * chi - sqmu * dt;
+        double dchi = f / rr;
+        chi -= dchi;
+        if (std::fabs(dchi) < 1e-13 * (1.0 + std::fabs(chi))) break;
+    }
+    psi = chi * chi * alpha;
+    stumpff(psi, c2, c3);
+    const double chi2 = chi * chi;
+    const double f = 1.0 - chi2 / r0 * c2;
+    const double g = dt - chi2 * chi / sqmu * c3;
+    double nr[3];
+    for (int k = 0; k < 3; ++k) nr[k] = f * r[k] + g * v[k];
+    const double rn = sqrt(nr[0]*nr[0] + nr[1]*nr[1] + nr[2]*nr[2]);
+    const double fdot = sqmu / (rn * r0) * chi * (psi * c3 - 1.0);
+    const double gdot = 1.0 - chi2 / rn * c2;
+    for (int k = 0; k < 3; ++k) {
+        v[k] = fdot * r[k] + gdot * v[k];
+        r[k] = nr[k];
+    }
+}
+
+NBodyState createSolarSystemNBody(double tDays) {
+    NBodyState s;
+    const double zero[3] = {0.0, 0.0, 0.0};
+    s.add("Sun", GM_SUN, zero, zero);
+
+    std::vector<OrbitalElements> els = planetElementsJ2000();
+    std::vector<double> masses = planetMassesSolar();
+    for (size_t i = 0; i < els.size(); ++i) {
+        double pos[3], vel[3];
+        keplerState(els[i], 1.0 + masses[i], tDays, pos, vel);
+        s.add(PLANET_NAMES[i], GM_SUN * masses[i], pos, vel);
+    }
+    s.toBarycentric();
+    return s;
+}
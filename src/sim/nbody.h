@@ -0,0 +1,118 @@
+// src/sim/nbody.h
+// N-body integration: symplectic (leapfrog, Yoshida 4th order, Wisdom-Holman)
+// or adaptive DOP853 with dense output.
+// Units: AU, days; masses are stored as GM in AU^3/day^2. Body 0 is the
+// central body (the Sun) that Wisdom-Holman splits the Kepler motion around.
+#pragma once
+
+#include "barnes_hut.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+const double GM_SUN = 0.01720209895 * 0.01720209895;
+
+enum class Integrator { Leapfrog, Yoshida4, WisdomHolman, DOP853 };
+enum class ForceMethod { Direct, BarnesHut };
+
+const char* integratorName(Integrator integrator);
+
+// Barycentric positions and velocities, one array per component.
+struct NBodyState {
+    std::vector<double> x, y, z;
+    std::vector<double> vx, vy, vz;
+    std::vector<double> gm;
+    std::vector<std::string> names;
+
+    size_t size() const { return x.size(); }
+    void add(const std::string& name, double gmBody, const double pos[3], const double vel[3]);
+    void toBarycentric();
+};
+
+class NBodySim {
+public:
+    explicit NBodySim(ThreadPool* pool = nullptr);
+
+    void setState(const NBodyState& s, double tDays);
+    const NBodyState& state() const { return st; }
+    // Flat copy of the integrator state for checkpoints: time, energy
+    // reference, DOP853 step proposal, then x, y, z, vx, vy, vz per body.
+    // Masses and names are not included.
+    void saveState(std::vector<double>& out) const;
+    // Counters are kept; false if the layout does not match the current bodies.
+    bool restoreState(const std::vector<double>& in);
+
+    // One step of dt; DOP853 takes one accepted step of at most dt.
+    void step(double dt);
+    // Integrate to tEnd with steps no larger than dtMax; stops early once
+    // maxSteps is reached so a frame can bound its cost. Returns steps taken.
+    // DOP853 sizes its own steps and may stop past tEnd: positions in between
+    // come from heliocentricAt(). onStep(t0, t1) runs after every step.
+    int advanceTo(double tEnd, double dtMax, int maxSteps = 1 << 30,
+                  const std::function<void(double t0, double t1)>& onStep = nullptr);
+
+    // Total energy (times G) and its drift relative to setState().
+    double energy() const;
+    double energyDrift() const;
+
+    // Heliocentric position of body i (relative to body 0).
+    void heliocentric(size_t i, double out[3]) const;
+    // Heliocentric position at t within the last step: interpolated from the
+    // DOP853 dense output, or the current state if t == time for the
+    // fixed-step schemes. False if t is not covered.
+    bool heliocentricAt(size_t i, double t, double out[3]);
+    // Earliest time heliocentricAt() can serve.
+    double stepBegin() const { return integrator == Integrator::DOP853 && dop.fsal ? dop.t0 : time; }
+
+    Integrator integrator = Integrator::WisdomHolman;
+    ForceMethod forceMethod = ForceMethod::Direct;
+    BarnesHutTree tree;        // used when forceMethod == BarnesHut; tune tree.theta
+    double time = 0.0;
+    long long steps = 0;
+    long long forceEvaluations = 0;
+    long long rejectedSteps = 0;   // DOP853 steps retried with a smaller h
+    double rtol = 1e-11, atol = 1e-14;  // DOP853 tolerances (AU, AU/day)
+
+private:
+    void leapfrog(double dt);
+    void wisdomHolman(double dt);
+    double dop853Step(double hMax);     // returns the step taken (dop853.cpp)
+    void dop853Dense();
+    void dop853Position(size_t i, double t, double out[3]) const;
+    void dopDerivative(const double* y, double* f);
+    // a[i] = sum over massive j >= firstSource of gm_j (p_j - p_i) / |p_j - p_i|^3
+    void accelerations(const std::vector<double>& px, const std::vector<double>& py,
+                       const std::vector<double>& pz, size_t firstSource);
+
+    NBodyState st;
+    ThreadPool* pool;
+    std::vector<size_t> massive;           // indices with gm > 0
+    std::vector<size_t> sources;           // scratch: massive indices >= firstSource
+    std::vector<double> ax, ay, az;
+    std::vector<double> hx, hy, hz;        // heliocentric scratch for Wisdom-Holman
+    bool accValid = false;
+    Integrator accIntegrator = Integrator::WisdomHolman;
+    double energy0 = 0.0;
+
+    // DOP853 state; y = [x | y | z | vx | vy | vz]
+    struct Dop853State {
+        std::vector<double> k;             // 16 stages of 6n
+        std::vector<double> y0, y1, tmp;   // step start, step end, scratch
+        std::vector<double> px, py, pz;
+        std::vector<double> dense;         // 7 rows of 3n, built on first sample
+        double h = 0.0;                    // next step proposal
+        double t0 = 0.0, hTaken = 0.0;     // last accepted step
+        bool fsal = false;                 // k[12] holds f(current state)
+        bool denseReady = false;
+    } dop;
+};
+
+// Advance a two-body orbit (relative position/velocity about mass mu) by dt
+// using universal variables; handles elliptic and hyperbolic motion.
+void keplerDrift(double mu, double r[3], double v[3], double dt);
+
+// Sun plus Mercury..Neptune at tDays from the J2000 elements, barycentric.
+NBodyState createSolarSystemNBody(double tDays);
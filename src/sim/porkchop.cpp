@@ -0,0 +1,139 @@
+// src/sim/porkchop.cpp
+#include "porkchop.h"
+#include "lambert.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static double gridStep(double span, size_t steps) {
+    return steps > 1 ? span / (double)(steps - 1) : 0.0;
+}
+
+double PorkchopSpec::departDay(size_t i) const {
+    return departStart + (double)i * gridStep(departSpan, departSteps);
+}
+
+double PorkchopSpec::arriveDay(size_t j) const {
+    return arriveStart + (double)j * gridStep(arriveSpan, arriveSteps);
+}
+
+PorkchopSpec porkchopWindow(int from, int to, double departStart, double departSpan, size_t steps) {
+    const std::vector<OrbitalElements> els = planetElementsJ2000();
+    const double a = 0.5 * (els[from].a + els[to].a);
+    const double hohmann = 0.5 * TWO_PI * std::sqrt(a * a * a) / GAUSS_K;
+    PorkchopSpec spec;
+    spec.from = from;
+    spec.to = to;
+    spec.departStart = departStart;
+    spec.departSpan = departSpan;
+    spec.arriveStart = departStart + 0.4 * hohmann;
+    spec.arriveSpan = departSpan + 1.2 * hohmann;
+    spec.departSteps = spec.arriveSteps = steps;
+    return spec;
+}
+
+size_t PorkchopGrid::minimum(const std::vector<float>& map) const {
+    size_t best = map.size();
+    for (size_t k = 0; k < map.size(); ++k) {
+        if (!std::isnan(map[k]) && (best == map.size() || map[k] < map[best])) best = k;
+    }
+    return best;
+}
+
+bool PorkchopGrid::save(const std::string& path) const {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) {
+        std::cerr << "Cannot write porkchop: " << path << "\n";
+        return false;
+    }
+    char magic[8];
+    std::memcpy(magic, "PORKCHP1", 8);
+    const int32_t bodies[2] = {spec.from, spec.to};
+    const uint32_t steps[2] = {(uint32_t)spec.departSteps, (uint32_t)spec.arriveSteps};
+    const double axes[4] = {spec.departStart, gridStep(spec.departSpan, spec.departSteps), spec.arriveStart,
+                            gridStep(spec.arriveSpan, spec.arriveSteps)};
+    f.write(magic, 8);
+    f.write((const char*)bodies, sizeof(bodies));
+    f.write((const char*)steps, sizeof(steps));
+    f.write((const char*)axes, sizeof(axes));
+    for (const std::vector<float>* map : {&c3, &vInfArrive, &deltaV}) {
+        f.write((const char*)map->data(), (std::streamsize)(map->size() * sizeof(float)));
+    }
+    return (bool)f;
+}
+
+// --- grid ---
+PorkchopGrid computePorkchop(const PorkchopSpec& spec, ThreadPool* pool, SimdLevel level) {
+    auto t0 = std::chrono::steady_clock::now();
+    PorkchopGrid grid;
+    grid.spec = spec;
+    const size_t nd = spec.departSteps, na = spec.arriveSteps;
+    const std::vector<OrbitalElements> els = planetElementsJ2000();
+    const std::vector<double> masses = planetMassesSolar();
+    if (nd == 0 || na == 0 || spec.from < 0 || spec.to < 0 || spec.from >= (int)els.size()
+        || spec.to >= (int)els.size() || spec.from == spec.to) {
+        return grid;
+    }
+    grid.c3.assign(nd * na, 0.0f);
+    grid.vInfArrive.assign(nd * na, 0.0f);
+    grid.deltaV.assign(nd * na, 0.0f);
+
+    // arrival states are shared by every row
+    std::vector<double> arrive(6 * na);
+    for (size_t j = 0; j < na; ++j) {
+        keplerState(els[spec.to], 1.0 + masses[spec.to], spec.arriveDay(j), &arrive[6 * j], &arrive[6 * j + 3]);
+    }
+    const double mu = GAUSS_K * GAUSS_K;
+    const double kms = AU_KM / 86400.0;
+
+    auto rows = [&](size_t begin, size_t end) {
+        LambertSoA soa;   // one batch per chunk, refilled per row
+        soa.resize(na);
+        for (size_t j = 0; j < na; ++j) {
+            soa.x2[j] = arrive[6 * j];
+            soa.y2[j] = arrive[6 * j + 1];
+            soa.z2[j] = arrive[6 * j + 2];
+        }
+        for (size_t i = begin; i < end; ++i) {
+            const double tDep = spec.departDay(i);
+            double r1[3], v1[3];
+            keplerState(els[spec.from], 1.0 + masses[spec.from], tDep, r1, v1);
+            std::fill(soa.x1.begin(), soa.x1.end(), r1[0]);
+            std::fill(soa.y1.begin(), soa.y1.end(), r1[1]);
+            std::fill(soa.z1.begin(), soa.z1.end(), r1[2]);
+            for (size_t j = 0; j < na; ++j) soa.tof[j] = spec.arriveDay(j) - tDep;
+            solveLambertBatch(soa, mu, level, 0, na);
+
+            float* c3 = &grid.c3[i * na];
+            float* vArr = &grid.vInfArrive[i * na];
+            float* dv = &grid.deltaV[i * na];
+            for (size_t j = 0; j < na; ++j) {
+                const double* va = &arrive[6 * j + 3];
+                const double d1[3] = {soa.vx1[j] - v1[0], soa.vy1[j] - v1[1], soa.vz1[j] - v1[2]};
+                const double d2[3] = {soa.vx2[j] - va[0], soa.vy2[j] - va[1], soa.vz2[j] - va[2]};
+                const double vInf1 = std::sqrt(d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2]) * kms;
+                const double vInf2 = std::sqrt(d2[0] * d2[0] + d2[1] * d2[1] + d2[2] * d2[2]) * kms;
+                c3[j] = (float)(vInf1 * vInf1);   // NaN propagates from unsolved cells
+                vArr[j] = (float)vInf2;
+                dv[j] = (float)(vInf1 + vInf2);
+            }
+        }
+    };
+    // short pool calls of a couple of rows per worker, so the sim thread's
+    // per-tick pool work is never queued behind the whole grid
+    const size_t batch = pool ? 2 * (size_t)pool->size() : nd;
+    for (size_t b = 0; b < nd; b += batch) {
+        const size_t n = std::min(batch, nd - b);
+        if (pool) pool->parallelFor(n, 1, [&](size_t begin, size_t end) { rows(b + begin, b + end); });
+        else rows(b, b + n);
+    }
+
+    grid.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return grid;
+}
@@ -0,0 +1,56 @@
+// src/sim/porkchop.h
+// Porkchop plots: the heliocentric Lambert transfer between two planets for
+// every cell of a departure-date x arrival-date grid. Planet states come from
+// the J2000 mean elements; each departure row is one Lambert batch and rows
+// run in parallel, a few per worker per pool call so other pool users keep
+// their turn.
+//
+// Binary file (little-endian, what save() writes):
+//   char magic[8] = "PORKCHP1"
+//   int32 from, to                        planetElementsJ2000() indices
+//   uint32 departSteps, arriveSteps
+//   float64 departStart, departStep, arriveStart, arriveStep   days since J2000
+//   float32 c3[departSteps][arriveSteps]            km^2/s^2
+//   float32 vInfArrive[departSteps][arriveSteps]    km/s
+//   float32 deltaV[departSteps][arriveSteps]        km/s
+// Cells without a transfer hold NaN.
+#pragma once
+
+#include "kepler.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+struct PorkchopSpec {
+    int from = 2, to = 3;                    // planetElementsJ2000() indices (2 = Earth)
+    double departStart = 7300.0, departSpan = 365.25;   // days since J2000
+    double arriveStart = 7400.0, arriveSpan = 730.0;
+    size_t departSteps = 1000, arriveSteps = 1000;
+
+    double departDay(size_t i) const;
+    double arriveDay(size_t j) const;
+};
+
+// A grid around the Hohmann transfer: departures over [departStart,
+// departStart + departSpan], arrivals from 0.4 to 1.6 Hohmann times later.
+PorkchopSpec porkchopWindow(int from, int to, double departStart, double departSpan, size_t steps);
+
+struct PorkchopGrid {
+    PorkchopSpec spec;
+    // row = departure, column = arrival
+    std::vector<float> c3;           // departure C3 = vInf^2
+    std::vector<float> vInfArrive;   // arrival hyperbolic excess speed
+    std::vector<float> deltaV;       // departure plus arrival excess speed
+    double wallSeconds = 0.0;
+
+    float at(const std::vector<float>& map, size_t i, size_t j) const { return map[i * spec.arriveSteps + j]; }
+    // index of the smallest non-NaN cell of a map, or map.size() if there is none
+    size_t minimum(const std::vector<float>& map) const;
+    bool save(const std::string& path) const;
+};
+
+PorkchopGrid computePorkchop(const PorkchopSpec& spec, ThreadPool* pool = nullptr,
+                             SimdLevel level = detectSimdLevel());
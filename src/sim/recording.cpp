@@ -0,0 +1,208 @@
+// src/sim/recording.cpp
+#include "recording.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static const char REC_MAGIC[8] = {'S', 'O', 'L', 'R', 'E', 'C', '0', '1'};
+static const char CHUNK_MAGIC[4] = {'C', 'H', 'N', 'K'};
+
+// --- value coding ---
+static void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static bool getVarint(const uint8_t* data, size_t size, size_t& pos, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && pos < size; shift += 7) {
+        const uint8_t b = data[pos++];
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+// Linear prediction from the two previous frames of the chunk (none for the
+// first frame, a repeat for the second), in wrapping integer arithmetic.
+static uint32_t predict(uint32_t frame, uint32_t p1, uint32_t p2) {
+    return frame == 0 ? 0u : frame == 1 ? p1 : 2u * p1 - p2;
+}
+
+static int64_t predictTime(uint32_t frame, int64_t t1, int64_t t2) {
+    return frame == 0 ? 0 : frame == 1 ? t1 : 2 * t1 - t2;
+}
+
+// --- recorder ---
+StateRecorder::~StateRecorder() {
+    close();
+}
+
+bool StateRecorder::open(const std::string& path, size_t bodyCount, size_t framesPerChunk) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Cannot write recording: " << path << "\n";
+        return false;
+    }
+    bodies = bodyCount;
+    chunkFrames = std::max<size_t>(framesPerChunk, 1);
+    RecordingHeader h;
+    std::memcpy(h.magic, REC_MAGIC, 8);
+    h.bodyCount = (uint32_t)bodies;
+    h.chunkFrames = (uint32_t)chunkFrames;
+    file.write((const char*)&h, sizeof(h));
+    written = sizeof(h);
+    frameCount = 0;
+    inChunk = 0;
+    payload.clear();
+    prev.assign(4 * bodies, 0);
+    prev2.assign(4 * bodies, 0);
+    return (bool)file;
+}
+
+void StateRecorder::close() {
+    if (!file.is_open()) return;
+    flushChunk();
+    file.close();
+}
+
+void StateRecorder::add(SimTicks t, const float* x, const float* y, const float* z, const float* rot) {
+    if (!file.is_open()) return;
+    if (inChunk == 0) chunkFirst = t;
+    putVarint(payload, zigzag(t - predictTime(inChunk, time1, time2)));
+    time2 = time1;
+    time1 = t;
+    const float* channels[4] = {x, y, z, rot};
+    for (int c = 0; c < 4; ++c) {
+        for (size_t i = 0; i < bodies; ++i) {
+            const size_t k = c * bodies + i;
+            uint32_t bits;
+            std::memcpy(&bits, &channels[c][i], 4);
+            const int32_t residual = (int32_t)(bits - predict(inChunk, prev[k], prev2[k]));
+            putVarint(payload, zigzag(residual));
+            prev2[k] = prev[k];
+            prev[k] = bits;
+        }
+    }
+    ++frameCount;
+    if (++inChunk == chunkFrames) flushChunk();
+}
+
+void StateRecorder::flushChunk() {
+    if (inChunk == 0) return;
+    RecordingChunk c;
+    std::memcpy(c.magic, CHUNK_MAGIC, 4);
+    c.frames = inChunk;
+    c.payloadBytes = payload.size();
+    c.firstTime = chunkFirst;
+    c.lastTime = time1;
+    file.write((const char*)&c, sizeof(c));
+    file.write((const char*)payload.data(), (std::streamsize)payload.size());
+    file.flush();   // a replay can follow the file while it grows
+    written += sizeof(c) + payload.size();
+    payload.clear();
+    inChunk = 0;
+}
+
+double StateRecorder::ratio() const {
+    const size_t raw = frameCount * (4 * bodies * sizeof(float) + sizeof(int64_t));
+    return bytes() > sizeof(RecordingHeader) ? (double)raw / (double)(bytes() - sizeof(RecordingHeader)) : 1.0;
+}
+
+// --- replay ---
+bool StateReplay::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    const uint8_t* base = (const uint8_t*)file.data();
+    const size_t size = file.size();
+    const RecordingHeader* h = (const RecordingHeader*)base;
+    if (size < sizeof(RecordingHeader) || std::memcmp(h->magic, REC_MAGIC, 8) != 0) {
+        std::cerr << "Not a recording: " << path << "\n";
+        close();
+        return false;
+    }
+    bodies = h->bodyCount;
+    // index the complete chunks; a torn tail is ignored
+    size_t off = sizeof(RecordingHeader);
+    while (off + sizeof(RecordingChunk) <= size) {
+        RecordingChunk c;
+        std::memcpy(&c, base + off, sizeof(c));
+        if (std::memcmp(c.magic, CHUNK_MAGIC, 4) != 0 || c.frames == 0) break;
+        if (c.payloadBytes > size - off - sizeof(c)) break;
+        chunks.push_back({base + off + sizeof(c), c.frames, (size_t)c.payloadBytes, c.firstTime, c.lastTime});
+        totalFrames += c.frames;
+        off += sizeof(c) + (size_t)c.payloadBytes;
+    }
+    if (chunks.empty()) {
+        std::cerr << "Recording has no complete chunk: " << path << "\n";
+        close();
+        return false;
+    }
+    cur.assign(4 * bodies, 0);
+    seekChunk(0);
+    return true;
+}
+
+void StateReplay::close() {
+    file.close();
+    chunks.clear();
+    bodies = totalFrames = 0;
+}
+
+void StateReplay::seekChunk(size_t c) {
+    chunk = c;
+    frame = 0;
+    pos = 0;
+    prev.assign(4 * bodies, 0);
+    prev2.assign(4 * bodies, 0);
+    time1 = time2 = 0;
+}
+
+// Decode the next frame of the current chunk unless its time is past limit.
+bool StateReplay::decodeFrame(SimTicks limit) {
+    const ChunkInfo& c = chunks[chunk];
+    if (frame >= c.frames) return false;
+    size_t p = pos;
+    uint64_t v;
+    if (!getVarint(c.data, c.bytes, p, v)) return false;
+    const int64_t t = predictTime(frame, time1, time2) + unzigzag(v);
+    if (frame > 0 && t > limit) return false;
+    for (size_t k = 0; k < 4 * bodies; ++k) {
+        if (!getVarint(c.data, c.bytes, p, v)) return false;
+        cur[k] = predict(frame, prev[k], prev2[k]) + (uint32_t)unzigzag(v);
+        prev2[k] = prev[k];
+        prev[k] = cur[k];
+    }
+    time2 = time1;
+    time1 = t;
+    pos = p;
+    ++frame;
+    return true;
+}
+
+SimTicks StateReplay::frameAt(SimTicks t, float* x, float* y, float* z, float* rot) {
+    if (chunks.empty()) return 0;
+    // chunk holding t: the last one starting at or before it
+    size_t lo = 0, hi = chunks.size();
+    while (hi - lo > 1) {
+        const size_t mid = (lo + hi) / 2;
+        if (chunks[mid].firstTime <= t) lo = mid;
+        else hi = mid;
+    }
+    if (lo != chunk || frame == 0 || time1 > t) seekChunk(lo);
+    while (decodeFrame(t)) {}
+
+    float* channels[4] = {x, y, z, rot};
+    for (int ch = 0; ch < 4; ++ch) {
+        std::memcpy(channels[ch], &cur[ch * bodies], bodies * sizeof(float));
+    }
+    return time1;
+}
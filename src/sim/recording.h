@@ -0,0 +1,104 @@
+// src/sim/recording.h
+// Record/replay of per-tick body states. A recording is a header followed by
+// self-contained chunks, so a file still being written (or cut short) replays
+// up to its last complete chunk and any chunk can be decoded on its own.
+//
+// File layout (little endian):
+//   RecordingHeader
+//   chunks: RecordingChunk, then `frames` frames of
+//           time residual, then x, y, z, rotation residuals per body
+// Every value is predicted linearly from the two frames before it, working
+// on the float bit patterns as integers so prediction is exact on any
+// compiler; the residual is zigzag + LEB128 coded. Smooth motion leaves
+// residuals of a byte or two. Lossless.
+#pragma once
+
+#include "mapped_file.h"
+#include "sim_time.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct RecordingHeader {
+    char magic[8];             // "SOLREC01"
+    uint32_t bodyCount;
+    uint32_t chunkFrames;      // frames per full chunk
+};
+
+struct RecordingChunk {
+    char magic[4];             // "CHNK"
+    uint32_t frames;
+    uint64_t payloadBytes;
+    int64_t firstTime, lastTime;   // SimTicks
+};
+
+class StateRecorder {
+public:
+    ~StateRecorder();
+
+    bool open(const std::string& path, size_t bodyCount, size_t chunkFrames = 256);
+    // Writes the open chunk; the file stays valid.
+    void close();
+    bool recording() const { return file.is_open(); }
+
+    // One frame: bodyCount floats per channel; rot is the spin angle in degrees.
+    void add(SimTicks t, const float* x, const float* y, const float* z, const float* rot);
+
+    size_t frames() const { return frameCount; }
+    size_t bytes() const { return written + payload.size(); }
+    // Raw float size over encoded size.
+    double ratio() const;
+
+private:
+    void flushChunk();
+
+    std::ofstream file;
+    size_t bodies = 0, chunkFrames = 0;
+    std::vector<uint8_t> payload;
+    std::vector<uint32_t> prev, prev2;   // bit patterns of the last two frames
+    int64_t time1 = 0, time2 = 0;
+    uint32_t inChunk = 0;
+    int64_t chunkFirst = 0;
+    size_t frameCount = 0, written = 0;
+};
+
+class StateReplay {
+public:
+    // Memory-map a recording and index its complete chunks.
+    bool open(const std::string& path);
+    void close();
+    bool valid() const { return !chunks.empty(); }
+
+    size_t bodyCount() const { return bodies; }
+    size_t frameCount() const { return totalFrames; }
+    SimTicks startTime() const { return chunks.empty() ? 0 : chunks.front().firstTime; }
+    SimTicks endTime() const { return chunks.empty() ? 0 : chunks.back().lastTime; }
+
+    // Last frame at or before t (clamped to the recording) into bodyCount()
+    // floats per channel. Playing forwards decodes one frame per new frame;
+    // seeking decodes from the start of the chunk. Returns the frame's time.
+    SimTicks frameAt(SimTicks t, float* x, float* y, float* z, float* rot);
+
+private:
+    struct ChunkInfo {
+        const uint8_t* data;
+        uint32_t frames;
+        size_t bytes;
+        int64_t firstTime, lastTime;
+    };
+    void seekChunk(size_t c);
+    bool decodeFrame(SimTicks limit);
+
+    MappedFile file;
+    size_t bodies = 0, totalFrames = 0;
+    std::vector<ChunkInfo> chunks;
+    // decoder position
+    size_t chunk = 0;
+    uint32_t frame = 0;                  // frames decoded in this chunk
+    size_t pos = 0;
+    std::vector<uint32_t> cur, prev, prev2;
+    int64_t time1 = 0, time2 = 0;
+};
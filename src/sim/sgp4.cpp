@@ -0,0 +1,1001 @@
+// src/sim/sgp4.cpp
+#include "sgp4.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const double PI = 3.14159265358979323846;
+static const double DEG = PI / 180.0;
+static const double X2O3 = 2.0 / 3.0;
+static const double J3OJ2 = SGP4_J3 / SGP4_J2;
+
+// --- two-line elements ---
+static int tleChecksum(const std::string& line) {
+    int sum = 0;
+    for (size_t k = 0; k < 68 && k < line.size(); ++k) {
+        const char c = line[k];
+        if (c >= '0' && c <= '9') sum += c - '0';
+        else if (c == '-') sum += 1;
+    }
+    return sum % 10;
+}
+
+// Columns [first, last], 1-based as in the format description.
+static std::string field(const std::string& line, size_t first, size_t last) {
+    return line.substr(first - 1, last - first + 1);
+}
+
+static bool parseNumber(const std::string& s, double& out) {
+    const char* p = s.c_str();
+    char* end = nullptr;
+    out = std::strtod(p, &end);
+    if (end == p) return false;
+    while (*end == ' ') ++end;
+    return *end == '\0';
+}
+
+// " 12345-3" = 0.12345e-3, sign and exponent optional
+static bool parseExponent(const std::string& s, double& out) {
+    std::string t;
+    for (char c : s) {
+        if (c != ' ') t += c;
+    }
+    if (t.empty()) {
+        out = 0.0;
+        return true;
+    }
+    double sign = 1.0;
+    if (t[0] == '-' || t[0] == '+') {
+        if (t[0] == '-') sign = -1.0;
+        t.erase(0, 1);
+    }
+    const size_t e = t.find_first_of("+-");
+    double mantissa, exponent = 0.0;
+    if (!parseNumber("0." + t.substr(0, e), mantissa)) return false;
+    if (e != std::string::npos && !parseNumber(t.substr(e), exponent)) return false;
+    out = sign * mantissa * std::pow(10.0, exponent);
+    return true;
+}
+
+// Five characters; a leading letter is the Alpha-5 extension (A = 10, I and O skipped).
+static bool parseCatalogNumber(const std::string& s, int& out) {
+    std::string t = s;
+    int high = 0;
+    const size_t first = t.find_first_not_of(' ');
+    if (first == std::string::npos) return false;
+    const char c = t[first];
+    if (c >= 'A' && c <= 'Z') {
+        if (c == 'I' || c == 'O') return false;
+        high = 10 + (c - 'A') - (c > 'I') - (c > 'O');
+        t[first] = '0';
+    }
+    double rest;
+    if (!parseNumber(t, rest)) return false;
+    out = high * 10000 + (int)rest;
+    return true;
+}
+
+// Julian date of Jan 1, 0h UT of a Gregorian year (1901..2099).
+static double januaryFirst(int year) {
+    return 367.0 * year - std::floor(1.75 * year) + 31.0 + 1721013.5;
+}
+
+bool parseTle(const std::string& line1, const std::string& line2, TwoLineElements& out) {
+    if (line1.size() < 68 || line2.size() < 68 || line1[0] != '1' || line2[0] != '2') return false;
+    for (const std::string* l : {&line1, &line2}) {
+        if (l->size() >= 69 && (*l)[68] >= '0' && (*l)[68] <= '9' && tleChecksum(*l) != (*l)[68] - '0') return false;
+    }
+    int num1, num2;
+    if (!parseCatalogNumber(field(line1, 3, 7), num1) || !parseCatalogNumber(field(line2, 3, 7), num2) ||
+        num1 != num2) {
+        return false;
+    }
+
+    double yy, day, bstar, incl, raan, argp, M, n, ecc;
+    if (!parseNumber(field(line1, 19, 20), yy) || !parseNumber(field(line1, 21, 32), day) ||
+        !parseExponent(field(line1, 54, 61), bstar) || !parseNumber(field(line2, 9, 16), incl) ||
+        !parseNumber(field(line2, 18, 25), raan) || !parseNumber("0." + field(line2, 27, 33), ecc) ||
+        !parseNumber(field(line2, 35, 42), argp) || !parseNumber(field(line2, 44, 51), M) ||
+        !parseNumber(field(line2, 53, 63), n)) {
+        return false;
+    }
+    if (!(n > 0.0) || !(ecc < 1.0)) return false;
+
+    // two-digit years 57..99 are 1957..1999
+    const int year = (int)yy < 57 ? 2000 + (int)yy : 1900 + (int)yy;
+    out.catalogNumber = num1;
+    out.epochDays = januaryFirst(year) + (day - 1.0) - 2451545.0;
+    out.bstar = bstar;
+    out.inclination = incl * DEG;
+    out.raan = raan * DEG;
+    out.eccentricity = ecc;
+    out.argPerigee = argp * DEG;
+    out.meanAnomaly = M * DEG;
+    out.meanMotion = n;
+    return true;
+}
+
+std::vector<TwoLineElements> parseTleText(const std::string& text, size_t* rejected) {
+    std::vector<TwoLineElements> out;
+    size_t bad = 0;
+    std::istringstream in(text);
+    std::string line, title, pending;
+    bool havePending = false;
+    while (havePending || std::getline(in, line)) {
+        if (havePending) {
+            line = pending;
+            havePending = false;
+        }
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        if (line.empty()) continue;
+        if (line[0] != '1' || line.size() < 2 || line[1] != ' ') {
+            // a title line; "0 NAME" in the three-line format
+            title = line.compare(0, 2, "0 ") == 0 ? line.substr(2) : line;
+            continue;
+        }
+        std::string line2;
+        if (!std::getline(in, line2)) {
+            ++bad;
+            break;
+        }
+        while (!line2.empty() && (line2.back() == '\r' || line2.back() == ' ')) line2.pop_back();
+        TwoLineElements tle;
+        if (line2.compare(0, 2, "2 ") != 0) {
+            // a line 1 without its line 2; look at what came instead afresh
+            ++bad;
+            pending = line2;
+            havePending = true;
+            title.clear();
+            continue;
+        }
+        if (parseTle(line, line2, tle)) {
+            tle.name = title;
+            out.push_back(tle);
+        } else {
+            ++bad;
+        }
+        title.clear();
+    }
+    if (rejected) *rejected = bad;
+    return out;
+}
+
+bool loadTleFile(const std::string& path, std::vector<TwoLineElements>& out, size_t* rejected) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream text;
+    text << in.rdbuf();
+    out = parseTleText(text.str(), rejected);
+    return true;
+}
+
+void formatTle(const TwoLineElements& tle, std::string& line1, std::string& line2) {
+    const double jd = tle.epochDays + 2451545.0;
+    int year = 2000 + (int)std::floor(tle.epochDays / 365.25);
+    while (januaryFirst(year) > jd) --year;
+    while (januaryFirst(year + 1) <= jd) ++year;
+    const double day = jd - januaryFirst(year) + 1.0;
+
+    char bstar[32];
+    if (tle.bstar == 0.0) {
+        std::snprintf(bstar, sizeof bstar, " 00000+0");
+    } else {
+        int e = (int)std::floor(std::log10(std::fabs(tle.bstar))) + 1;
+        long m = std::lround(std::fabs(tle.bstar) / std::pow(10.0, e) * 1e5);
+        if (m >= 100000) {
+            m /= 10;
+            ++e;
+        }
+        if (e < -9 || e > 9) {
+            // one exponent digit: refit the mantissa, which saturates at the top and fades to zero below
+            e = std::max(-9, std::min(9, e));
+            m = std::min(99999L, std::lround(std::fabs(tle.bstar) / std::pow(10.0, e) * 1e5));
+        }
+        std::snprintf(bstar, sizeof bstar, "%c%05d%c%d", tle.bstar < 0.0 ? '-' : ' ', (int)m, e < 0 ? '-' : '+', std::abs(e));
+    }
+    auto degrees = [](double rad) {
+        double d = std::fmod(rad / DEG, 360.0);
+        return d < 0.0 ? d + 360.0 : d;
+    };
+    const int num = tle.catalogNumber % 100000;
+    const long ecc = std::min(9999999L, std::lround(tle.eccentricity * 1e7));
+
+    char buf[96];
+    std::snprintf(buf, sizeof buf, "1 %05dU          %02d%012.8f  .00000000  00000-0 %s 0  999", num, year % 100,
+                  day, bstar);
+    line1 = buf;
+    std::snprintf(buf, sizeof buf, "2 %05d %8.4f %8.4f %07ld %8.4f %8.4f %11.8f    0", num,
+                  std::fmin(tle.inclination / DEG, 180.0), degrees(tle.raan), ecc, degrees(tle.argPerigee),
+                  degrees(tle.meanAnomaly), tle.meanMotion);
+    line2 = buf;
+    line1 += (char)('0' + tleChecksum(line1));
+    line2 += (char)('0' + tleChecksum(line2));
+}
+
+// --- deep space (Vallado's dscom, dsinit, dpper, dspace) ---
+// What dscom hands on to dsinit.
+struct DeepCommon {
+    double sinim, cosim, emsq;
+    double s1, s2, s3, s4, s5, ss1, ss2, ss3, ss4, ss5;
+    double sz1, sz3, sz11, sz13, sz21, sz23, sz31, sz33;
+    double z1, z3, z11, z13, z21, z23, z31, z33;
+};
+
+// Greenwich mean sidereal angle (IAU 1982) at a UT1 Julian date.
+static double gstime(double jdut1) {
+    const double tut1 = (jdut1 - 2451545.0) / 36525.0;
+    double temp = -6.2e-6 * tut1 * tut1 * tut1 + 0.093104 * tut1 * tut1 +
+                  (876600.0 * 3600.0 + 8640184.812866) * tut1 + 67310.54841;   // seconds
+    temp = std::fmod(temp * DEG / 240.0, 2.0 * PI);
+    return temp < 0.0 ? temp + 2.0 * PI : temp;
+}
+
+// Lunar-solar coefficients at epoch; epoch1950 is in days since 1950 Jan 0.
+static void dscom(double epoch1950, Sgp4Orbit& o, DeepCommon& dc) {
+    const double zes = 0.01675, zel = 0.05490, c1ss = 2.9864797e-6, c1l = 4.7968065e-7;
+    const double zsinis = 0.39785416, zcosis = 0.91744867, zcosgs = 0.1945905, zsings = -0.98088458;
+
+    const double nm = o.no, em = o.ecco;
+    const double snodm = std::sin(o.nodeo), cnodm = std::cos(o.nodeo);
+    const double sinomm = std::sin(o.argpo), cosomm = std::cos(o.argpo);
+    dc.sinim = std::sin(o.inclo);
+    dc.cosim = std::cos(o.inclo);
+    dc.emsq = em * em;
+    const double betasq = 1.0 - dc.emsq;
+    const double rtemsq = std::sqrt(betasq);
+
+    // the Moon's node and the Sun's and Moon's mean longitudes at epoch
+    const double day = epoch1950 + 18261.5;
+    const double xnodce = std::fmod(4.5236020 - 9.2422029e-4 * day, 2.0 * PI);
+    const double stem = std::sin(xnodce), ctem = std::cos(xnodce);
+    const double zcosil = 0.91375164 - 0.03568096 * ctem;
+    const double zsinil = std::sqrt(1.0 - zcosil * zcosil);
+    const double zsinhl = 0.089683511 * stem / zsinil;
+    const double zcoshl = std::sqrt(1.0 - zsinhl * zsinhl);
+    const double gam = 5.8351514 + 0.0019443680 * day;
+    double zx = 0.39785416 * stem / zsinil;
+    const double zy = zcoshl * ctem + 0.91744867 * zsinhl * stem;
+    zx = gam + std::atan2(zx, zy) - xnodce;
+    const double zcosgl = std::cos(zx), zsingl = std::sin(zx);
+
+    // first the Sun, then the Moon
+    double zcosg = zcosgs, zsing = zsings, zcosi = zcosis, zsini = zsinis, zcosh = cnodm, zsinh = snodm;
+    double cc = c1ss;
+    const double xnoi = 1.0 / nm;
+    double s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    double z1 = 0, z2 = 0, z3 = 0, z11 = 0, z12 = 0, z13 = 0, z21 = 0, z22 = 0, z23 = 0, z31 = 0, z32 = 0, z33 = 0;
+    double ss1 = 0, ss2 = 0, ss3 = 0, ss4 = 0, ss6 = 0, ss7 = 0;
+    double sz2 = 0, sz12 = 0, sz22 = 0, sz32 = 0;
+    for (int lsflg = 1; lsflg <= 2; ++lsflg) {
+        const double a1 = zcosg * zcosh + zsing * zcosi * zsinh;
+        const double a3 = -zsing * zcosh + zcosg * zcosi * zsinh;
+        const double a7 = -zcosg * zsinh + zsing * zcosi * zcosh;
+        const double a8 = zsing * zsini;
+        const double a9 = zsing * zsinh + zcosg * zcosi * zcosh;
+        const double a10 = zcosg * zsini;
+        const double a2 = dc.cosim * a7 + dc.sinim * a8;
+        const double a4 = dc.cosim * a9 + dc.sinim * a10;
+        const double a5 = -dc.sinim * a7 + dc.cosim * a8;
+        const double a6 = -dc.sinim * a9 + dc.cosim * a10;
+
+        const double x1 = a1 * cosomm + a2 * sinomm;
+        const double x2 = a3 * cosomm + a4 * sinomm;
+        const double x3 = -a1 * sinomm + a2 * cosomm;
+        const double x4 = -a3 * sinomm + a4 * cosomm;
+        const double x5 = a5 * sinomm;
+        const double x6 = a6 * sinomm;
+        const double x7 = a5 * cosomm;
+        const double x8 = a6 * cosomm;
+
+        z31 = 12.0 * x1 * x1 - 3.0 * x3 * x3;
+        z32 = 24.0 * x1 * x2 - 6.0 * x3 * x4;
+        z33 = 12.0 * x2 * x2 - 3.0 * x4 * x4;
+        z1 = 3.0 * (a1 * a1 + a2 * a2) + z31 * dc.emsq;
+        z2 = 6.0 * (a1 * a3 + a2 * a4) + z32 * dc.emsq;
+        z3 = 3.0 * (a3 * a3 + a4 * a4) + z33 * dc.emsq;
+        z11 = -6.0 * a1 * a5 + dc.emsq * (-24.0 * x1 * x7 - 6.0 * x3 * x5);
+        z12 = -6.0 * (a1 * a6 + a3 * a5) + dc.emsq * (-24.0 * (x2 * x7 + x1 * x8) - 6.0 * (x3 * x6 + x4 * x5));
+        z13 = -6.0 * a3 * a6 + dc.emsq * (-24.0 * x2 * x8 - 6.0 * x4 * x6);
+        z21 = 6.0 * a2 * a5 + dc.emsq * (24.0 * x1 * x5 - 6.0 * x3 * x7);
+        z22 = 6.0 * (a4 * a5 + a2 * a6) + dc.emsq * (24.0 * (x2 * x5 + x1 * x6) - 6.0 * (x4 * x7 + x3 * x8));
+        z23 = 6.0 * a4 * a6 + dc.emsq * (24.0 * x2 * x6 - 6.0 * x4 * x8);
+        z1 = z1 + z1 + betasq * z31;
+        z2 = z2 + z2 + betasq * z32;
+        z3 = z3 + z3 + betasq * z33;
+        s3 = cc * xnoi;
+        s2 = -0.5 * s3 / rtemsq;
+        s4 = s3 * rtemsq;
+        s1 = -15.0 * em * s4;
+        s5 = x1 * x3 + x2 * x4;
+        s6 = x2 * x3 + x1 * x4;
+        s7 = x2 * x4 - x1 * x3;
+
+        if (lsflg == 1) {
+            ss1 = s1; ss2 = s2; ss3 = s3; ss4 = s4; dc.ss5 = s5; ss6 = s6; ss7 = s7;
+            dc.sz1 = z1; sz2 = z2; dc.sz3 = z3; dc.sz11 = z11; sz12 = z12; dc.sz13 = z13;
+            dc.sz21 = z21; sz22 = z22; dc.sz23 = z23; dc.sz31 = z31; sz32 = z32; dc.sz33 = z33;
+            zcosg = zcosgl; zsing = zsingl; zcosi = zcosil; zsini = zsinil;
+            zcosh = zcoshl * cnodm + zsinhl * snodm;
+            zsinh = snodm * zcoshl - cnodm * zsinhl;
+            cc = c1l;
+        }
+    }
+    dc.ss1 = ss1; dc.ss2 = ss2; dc.ss3 = ss3; dc.ss4 = ss4;
+    dc.s1 = s1; dc.s2 = s2; dc.s3 = s3; dc.s4 = s4; dc.s5 = s5;
+    dc.z1 = z1; dc.z3 = z3; dc.z11 = z11; dc.z13 = z13; dc.z21 = z21; dc.z23 = z23; dc.z31 = z31; dc.z33 = z33;
+
+    o.zmol = std::fmod(4.7199672 + 0.22997150 * day - gam, 2.0 * PI);
+    o.zmos = std::fmod(6.2565837 + 0.017201977 * day, 2.0 * PI);
+
+    // solar terms
+    o.se2 = 2.0 * ss1 * ss6;
+    o.se3 = 2.0 * ss1 * ss7;
+    o.si2 = 2.0 * ss2 * sz12;
+    o.si3 = 2.0 * ss2 * (dc.sz13 - dc.sz11);
+    o.sl2 = -2.0 * ss3 * sz2;
+    o.sl3 = -2.0 * ss3 * (dc.sz3 - dc.sz1);
+    o.sl4 = -2.0 * ss3 * (-21.0 - 9.0 * dc.emsq) * zes;
+    o.sgh2 = 2.0 * ss4 * sz32;
+    o.sgh3 = 2.0 * ss4 * (dc.sz33 - dc.sz31);
+    o.sgh4 = -18.0 * ss4 * zes;
+    o.sh2 = -2.0 * ss2 * sz22;
+    o.sh3 = -2.0 * ss2 * (dc.sz23 - dc.sz21);
+    // lunar terms
+    o.ee2 = 2.0 * s1 * s6;
+    o.e3 = 2.0 * s1 * s7;
+    o.xi2 = 2.0 * s2 * z12;
+    o.xi3 = 2.0 * s2 * (z13 - z11);
+    o.xl2 = -2.0 * s3 * z2;
+    o.xl3 = -2.0 * s3 * (z3 - z1);
+    o.xl4 = -2.0 * s3 * (-21.0 - 9.0 * dc.emsq) * zel;
+    o.xgh2 = 2.0 * s4 * z32;
+    o.xgh3 = 2.0 * s4 * (z33 - z31);
+    o.xgh4 = -18.0 * s4 * zel;
+    o.xh2 = -2.0 * s2 * z22;
+    o.xh3 = -2.0 * s2 * (z23 - z21);
+}
+
+// Secular lunar-solar rates and the resonance set-up.
+static void dsinit(Sgp4Orbit& o, const DeepCommon& dc, double xpidot) {
+    const double q22 = 1.7891679e-6, q31 = 2.1460748e-6, q33 = 2.2123015e-7;
+    const double root22 = 1.7891679e-6, root44 = 7.3636953e-9, root54 = 2.1765803e-9;
+    const double rptim = 4.37526908801129966e-3;   // Earth rotation, rad/min
+    const double root32 = 3.7393792e-7, root52 = 1.1428639e-7;
+    const double znl = 1.5835218e-4, zns = 1.19459e-5;
+
+    const double nm = o.no, em = o.ecco, emsq = dc.emsq, inclm = o.inclo;
+    const double sinim = dc.sinim, cosim = dc.cosim;
+    o.irez = 0;
+    if (nm < 0.0052359877 && nm > 0.0034906585) o.irez = 1;
+    if (nm >= 8.26e-3 && nm <= 9.24e-3 && em >= 0.5) o.irez = 2;
+
+    const bool equatorial = inclm < 5.2359877e-2 || inclm > PI - 5.2359877e-2;
+    // solar terms
+    const double ses = dc.ss1 * zns * dc.ss5;
+    const double sis = dc.ss2 * zns * (dc.sz11 + dc.sz13);
+    const double sls = -zns * dc.ss3 * (dc.sz1 + dc.sz3 - 14.0 - 6.0 * emsq);
+    const double sghs = dc.ss4 * zns * (dc.sz31 + dc.sz33 - 6.0);
+    double shs = -zns * dc.ss2 * (dc.sz21 + dc.sz23);
+    if (equatorial) shs = 0.0;
+    if (sinim != 0.0) shs /= sinim;
+    const double sgs = sghs - cosim * shs;
+    // lunar terms
+    o.dedt = ses + dc.s1 * znl * dc.s5;
+    o.didt = sis + dc.s2 * znl * (dc.z11 + dc.z13);
+    o.dmdt = sls - znl * dc.s3 * (dc.z1 + dc.z3 - 14.0 - 6.0 * emsq);
+    const double sghl = dc.s4 * znl * (dc.z31 + dc.z33 - 6.0);
+    double shll = -znl * dc.s2 * (dc.z21 + dc.z23);
+    if (equatorial) shll = 0.0;
+    o.domdt = sgs + sghl;
+    o.dnodt = shs;
+    if (sinim != 0.0) {
+        o.domdt -= cosim / sinim * shll;
+        o.dnodt += shll / sinim;
+    }
+
+    if (o.irez == 0) return;
+    const double theta = o.gsto;
+    const double aonv = std::pow(nm / SGP4_XKE, X2O3);
+
+    if (o.irez == 2) {
+        // half-day resonance (e.g. Molniya)
+        const double cosisq = cosim * cosim;
+        const double e = o.ecco, esq = e * e, eoc = e * esq;
+        const double g201 = -0.306 - (e - 0.64) * 0.440;
+        double g211, g310, g322, g410, g422, g520, g521, g532, g533;
+        if (e <= 0.65) {
+            g211 = 3.616 - 13.2470 * e + 16.2900 * esq;
+            g310 = -19.302 + 117.3900 * e - 228.4190 * esq + 156.5910 * eoc;
+            g322 = -18.9068 + 109.7927 * e - 214.6334 * esq + 146.5816 * eoc;
+            g410 = -41.122 + 242.6940 * e - 471.0940 * esq + 313.9530 * eoc;
+            g422 = -146.407 + 841.8800 * e - 1629.014 * esq + 1083.4350 * eoc;
+            g520 = -532.114 + 3017.977 * e - 5740.032 * esq + 3708.2760 * eoc;
+        } else {
+            g211 = -72.099 + 331.819 * e - 508.738 * esq + 266.724 * eoc;
+            g310 = -346.844 + 1582.851 * e - 2415.925 * esq + 1246.113 * eoc;
+            g322 = -342.585 + 1554.908 * e - 2366.899 * esq + 1215.972 * eoc;
+            g410 = -1052.797 + 4758.686 * e - 7193.992 * esq + 3651.957 * eoc;
+            g422 = -3581.690 + 16178.110 * e - 24462.770 * esq + 12422.520 * eoc;
+            if (e > 0.715) g520 = -5149.66 + 29936.92 * e - 54087.36 * esq + 31324.56 * eoc;
+            else g520 = 1464.74 - 4664.75 * e + 3763.64 * esq;
+        }
+        if (e < 0.7) {
+            g533 = -919.22770 + 4988.6100 * e - 9064.7700 * esq + 5542.21 * eoc;
+            g521 = -822.71072 + 4568.6173 * e - 8491.4146 * esq + 5337.524 * eoc;
+            g532 = -853.66600 + 4690.2500 * e - 8624.7700 * esq + 5341.4 * eoc;
+        } else {
+            g533 = -37995.780 + 161616.52 * e - 229838.20 * esq + 109377.94 * eoc;
+            g521 = -51752.104 + 218913.95 * e - 309468.16 * esq + 146349.42 * eoc;
+            g532 = -40023.880 + 170470.89 * e - 242699.48 * esq + 115605.82 * eoc;
+        }
+        const double sini2 = sinim * sinim;
+        const double f220 = 0.75 * (1.0 + 2.0 * cosim + cosisq);
+        const double f221 = 1.5 * sini2;
+        const double f321 = 1.875 * sinim * (1.0 - 2.0 * cosim - 3.0 * cosisq);
+        const double f322 = -1.875 * sinim * (1.0 + 2.0 * cosim - 3.0 * cosisq);
+        const double f441 = 35.0 * sini2 * f220;
+        const double f442 = 39.3750 * sini2 * sini2;
+        const double f522 = 9.84375 * sinim *
+                            (sini2 * (1.0 - 2.0 * cosim - 5.0 * cosisq) + 0.33333333 * (-2.0 + 4.0 * cosim + 6.0 * cosisq));
+        const double f523 = sinim * (4.92187512 * sini2 * (-2.0 - 4.0 * cosim + 10.0 * cosisq) +
+                                     6.56250012 * (1.0 + 2.0 * cosim - 3.0 * cosisq));
+        const double f542 = 29.53125 * sinim * (2.0 - 8.0 * cosim + cosisq * (-12.0 + 8.0 * cosim + 10.0 * cosisq));
+        const double f543 = 29.53125 * sinim * (-2.0 - 8.0 * cosim + cosisq * (12.0 + 8.0 * cosim - 10.0 * cosisq));
+        const double xno2 = nm * nm, ainv2 = aonv * aonv;
+        double temp1 = 3.0 * xno2 * ainv2;
+        double temp = temp1 * root22;
+        o.d2201 = temp * f220 * g201;
+        o.d2211 = temp * f221 * g211;
+        temp1 *= aonv;
+        temp = temp1 * root32;
+        o.d3210 = temp * f321 * g310;
+        o.d3222 = temp * f322 * g322;
+        temp1 *= aonv;
+        temp = 2.0 * temp1 * root44;
+        o.d4410 = temp * f441 * g410;
+        o.d4422 = temp * f442 * g422;
+        temp1 *= aonv;
+        temp = temp1 * root52;
+        o.d5220 = temp * f522 * g520;
+        o.d5232 = temp * f523 * g532;
+        temp = 2.0 * temp1 * root54;
+        o.d5421 = temp * f542 * g521;
+        o.d5433 = temp * f543 * g533;
+        o.xlamo = std::fmod(o.mo + o.nodeo + o.nodeo - theta - theta, 2.0 * PI);
+        o.xfact = o.mdot + o.dmdt + 2.0 * (o.nodedot + o.dnodt - rptim) - o.no;
+    } else {
+        // synchronous resonance (geostationary)
+        const double g200 = 1.0 + emsq * (-2.5 + 0.8125 * emsq);
+        const double g310 = 1.0 + 2.0 * emsq;
+        const double g300 = 1.0 + emsq * (-6.0 + 6.60937 * emsq);
+        const double f220 = 0.75 * (1.0 + cosim) * (1.0 + cosim);
+        const double f311 = 0.9375 * sinim * sinim * (1.0 + 3.0 * cosim) - 0.75 * (1.0 + cosim);
+        double f330 = 1.0 + cosim;
+        f330 = 1.875 * f330 * f330 * f330;
+        const double del1 = 3.0 * nm * nm * aonv * aonv;
+        o.del2 = 2.0 * del1 * f220 * g200 * q22;
+        o.del3 = 3.0 * del1 * f330 * g300 * q33 * aonv;
+        o.del1 = del1 * f311 * g310 * q31 * aonv;
+        o.xlamo = std::fmod(o.mo + o.nodeo + o.argpo - theta, 2.0 * PI);
+        o.xfact = o.mdot + xpidot - rptim + o.dmdt + o.domdt + o.dnodt - o.no;
+    }
+    o.xli = o.xlamo;
+    o.xni = o.no;
+    o.atime = 0.0;
+}
+
+// Secular lunar-solar terms and the resonance integration (720-minute steps
+// from the last point reached, or from epoch when t goes back past it).
+static void dspace(Sgp4Orbit& o, double t, double& em, double& argpm, double& inclm, double& mm, double& nodem,
+                   double& nm) {
+    const double fasx2 = 0.13130908, fasx4 = 2.8843198, fasx6 = 0.37448087;
+    const double g22 = 5.7686396, g32 = 0.95240898, g44 = 1.8014998, g52 = 1.0508330, g54 = 4.4108898;
+    const double rptim = 4.37526908801129966e-3;
+    const double stepp = 720.0, stepn = -720.0, step2 = 259200.0;
+
+    const double theta = std::fmod(o.gsto + t * rptim, 2.0 * PI);
+    em += o.dedt * t;
+    inclm += o.didt * t;
+    argpm += o.domdt * t;
+    nodem += o.dnodt * t;
+    mm += o.dmdt * t;
+    if (o.irez == 0) return;
+
+    if (o.atime == 0.0 || t * o.atime <= 0.0 || std::fabs(t) < std::fabs(o.atime)) {
+        o.atime = 0.0;
+        o.xni = o.no;
+        o.xli = o.xlamo;
+    }
+    const double delt = t > 0.0 ? stepp : stepn;
+    double xndt, xldot, xnddt, ft = 0.0;
+    for (;;) {
+        if (o.irez != 2) {
+            xndt = o.del1 * std::sin(o.xli - fasx2) + o.del2 * std::sin(2.0 * (o.xli - fasx4)) +
+                   o.del3 * std::sin(3.0 * (o.xli - fasx6));
+            xldot = o.xni + o.xfact;
+            xnddt = o.del1 * std::cos(o.xli - fasx2) + 2.0 * o.del2 * std::cos(2.0 * (o.xli - fasx4)) +
+                    3.0 * o.del3 * std::cos(3.0 * (o.xli - fasx6));
+            xnddt *= xldot;
+        } else {
+            const double xomi = o.argpo + o.argpdot * o.atime;
+            const double x2omi = xomi + xomi, x2li = o.xli + o.xli;
+            xndt = o.d2201 * std::sin(x2omi + o.xli - g22) + o.d2211 * std::sin(o.xli - g22) +
+                   o.d3210 * std::sin(xomi + o.xli - g32) + o.d3222 * std::sin(-xomi + o.xli - g32) +
+                   o.d4410 * std::sin(x2omi + x2li - g44) + o.d4422 * std::sin(x2li - g44) +
+                   o.d5220 * std::sin(xomi + o.xli - g52) + o.d5232 * std::sin(-xomi + o.xli - g52) +
+                   o.d5421 * std::sin(xomi + x2li - g54) + o.d5433 * std::sin(-xomi + x2li - g54);
+            xldot = o.xni + o.xfact;
+            xnddt = o.d2201 * std::cos(x2omi + o.xli - g22) + o.d2211 * std::cos(o.xli - g22) +
+                    o.d3210 * std::cos(xomi + o.xli - g32) + o.d3222 * std::cos(-xomi + o.xli - g32) +
+                    o.d5220 * std::cos(xomi + o.xli - g52) + o.d5232 * std::cos(-xomi + o.xli - g52) +
+                    2.0 * (o.d4410 * std::cos(x2omi + x2li - g44) + o.d4422 * std::cos(x2li - g44) +
+                           o.d5421 * std::cos(xomi + x2li - g54) + o.d5433 * std::cos(-xomi + x2li - g54));
+            xnddt *= xldot;
+        }
+        if (std::fabs(t - o.atime) < stepp) {
+            ft = t - o.atime;
+            break;
+        }
+        o.xli += xldot * delt + xndt * step2;
+        o.xni += xndt * delt + xnddt * step2;
+        o.atime += delt;
+    }
+    nm = o.xni + xndt * ft + xnddt * ft * ft * 0.5;
+    const double xl = o.xli + xldot * ft + xndt * ft * ft * 0.5;
+    if (o.irez != 1) mm = xl - 2.0 * nodem + 2.0 * theta;
+    else mm = xl - nodem - argpm + theta;
+}
+
+// Lunar-solar periodics, applied to the mean elements at t.
+static void dpper(const Sgp4Orbit& o, double t, double& ep, double& inclp, double& nodep, double& argpp, double& mp) {
+    const double zns = 1.19459e-5, zes = 0.01675, znl = 1.5835218e-4, zel = 0.05490;
+
+    double zm = o.zmos + zns * t;
+    double zf = zm + 2.0 * zes * std::sin(zm);
+    double sinzf = std::sin(zf);
+    double f2 = 0.5 * sinzf * sinzf - 0.25;
+    double f3 = -0.5 * sinzf * std::cos(zf);
+    const double ses = o.se2 * f2 + o.se3 * f3;
+    const double sis = o.si2 * f2 + o.si3 * f3;
+    const double sls = o.sl2 * f2 + o.sl3 * f3 + o.sl4 * sinzf;
+    const double sghs = o.sgh2 * f2 + o.sgh3 * f3 + o.sgh4 * sinzf;
+    const double shs = o.sh2 * f2 + o.sh3 * f3;
+
+    zm = o.zmol + znl * t;
+    zf = zm + 2.0 * zel * std::sin(zm);
+    sinzf = std::sin(zf);
+    f2 = 0.5 * sinzf * sinzf - 0.25;
+    f3 = -0.5 * sinzf * std::cos(zf);
+    const double sel = o.ee2 * f2 + o.e3 * f3;
+    const double sil = o.xi2 * f2 + o.xi3 * f3;
+    const double sll = o.xl2 * f2 + o.xl3 * f3 + o.xl4 * sinzf;
+    const double sghl = o.xgh2 * f2 + o.xgh3 * f3 + o.xgh4 * sinzf;
+    const double shll = o.xh2 * f2 + o.xh3 * f3;
+
+    const double pe = ses + sel, pinc = sis + sil, pl = sls + sll;
+    double pgh = sghs + sghl, ph = shs + shll;
+    inclp += pinc;
+    ep += pe;
+    const double sinip = std::sin(inclp), cosip = std::cos(inclp);
+    if (inclp >= 0.2) {
+        ph /= sinip;
+        pgh -= cosip * ph;
+        argpp += pgh;
+        nodep += ph;
+        mp += pl;
+    } else {
+        // Lyddane's modification for low inclinations
+        const double sinop = std::sin(nodep), cosop = std::cos(nodep);
+        double alfdp = sinip * sinop, betdp = sinip * cosop;
+        alfdp += ph * cosop + pinc * cosip * sinop;
+        betdp += -ph * sinop + pinc * cosip * cosop;
+        nodep = std::fmod(nodep, 2.0 * PI);
+        double xls = mp + argpp + cosip * nodep;
+        xls += pl + pgh - pinc * nodep * sinip;
+        const double xnoh = nodep;
+        nodep = std::atan2(alfdp, betdp);
+        if (std::fabs(xnoh - nodep) > PI) nodep += nodep < xnoh ? 2.0 * PI : -2.0 * PI;
+        mp += pl;
+        argpp = xls - mp - cosip * nodep;
+    }
+}
+
+// --- reference propagator ---
+bool sgp4Init(const TwoLineElements& tle, Sgp4Orbit& o) {
+    o = Sgp4Orbit();
+    o.epochDays = tle.epochDays;
+    o.bstar = tle.bstar;
+    o.ecco = tle.eccentricity;
+    o.inclo = tle.inclination;
+    o.nodeo = tle.raan;
+    o.argpo = tle.argPerigee;
+    o.mo = tle.meanAnomaly;
+    const double noKozai = tle.meanMotion * 2.0 * PI / MIN_PER_DAY;
+    if (!(noKozai > 0.0) || !(o.ecco >= 0.0 && o.ecco < 1.0)) return false;
+
+    // initl: recover the original mean motion and semi-major axis
+    const double eccsq = o.ecco * o.ecco, omeosq = 1.0 - eccsq, rteosq = std::sqrt(omeosq);
+    const double cosio = std::cos(o.inclo), cosio2 = cosio * cosio, sinio = std::sin(o.inclo);
+    const double ak = std::pow(SGP4_XKE / noKozai, X2O3);
+    const double d1 = 0.75 * SGP4_J2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+    double del = d1 / (ak * ak);
+    const double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+    del = d1 / (adel * adel);
+    o.no = noKozai / (1.0 + del);
+    o.ao = std::pow(SGP4_XKE / o.no, X2O3);
+    const double po = o.ao * omeosq;
+    const double con42 = 1.0 - 5.0 * cosio2;
+    const double con41 = -con42 - cosio2 - cosio2;
+    const double posq = po * po;
+    const double rp = o.ao * (1.0 - o.ecco);
+    const double jd = o.epochDays + 2451545.0;
+    o.gsto = gstime(jd);
+
+    // below 220 km perigee the drag series is cut short
+    o.isimp = rp < 220.0 / SGP4_EARTH_RADIUS_KM + 1.0;
+    double sfour = 78.0 / SGP4_EARTH_RADIUS_KM + 1.0;
+    double qzms24 = std::pow((120.0 - 78.0) / SGP4_EARTH_RADIUS_KM, 4.0);
+    const double perige = (rp - 1.0) * SGP4_EARTH_RADIUS_KM;
+    if (perige < 156.0) {
+        sfour = perige < 98.0 ? 20.0 : perige - 78.0;
+        qzms24 = std::pow((120.0 - sfour) / SGP4_EARTH_RADIUS_KM, 4.0);
+        sfour = sfour / SGP4_EARTH_RADIUS_KM + 1.0;
+    }
+    const double pinvsq = 1.0 / posq;
+    const double tsi = 1.0 / (o.ao - sfour);
+    o.eta = o.ao * o.ecco * tsi;
+    const double etasq = o.eta * o.eta, eeta = o.ecco * o.eta;
+    const double psisq = std::fabs(1.0 - etasq);
+    const double coef = qzms24 * std::pow(tsi, 4.0);
+    const double coef1 = coef / std::pow(psisq, 3.5);
+    const double cc2 = coef1 * o.no *
+                       (o.ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) +
+                        0.375 * SGP4_J2 * tsi / psisq * con41 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+    o.cc1 = o.bstar * cc2;
+    const double cc3 = o.ecco > 1e-4 ? -2.0 * coef * tsi * J3OJ2 * o.no * sinio / o.ecco : 0.0;
+    const double x1mth2 = 1.0 - cosio2;
+    o.cc4 = 2.0 * o.no * coef1 * o.ao * omeosq *
+            (o.eta * (2.0 + 0.5 * etasq) + o.ecco * (0.5 + 2.0 * etasq) -
+             SGP4_J2 * tsi / (o.ao * psisq) *
+                 (-3.0 * con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+                  0.75 * x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * std::cos(2.0 * o.argpo)));
+    o.cc5 = 2.0 * coef1 * o.ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+    const double cosio4 = cosio2 * cosio2;
+    const double temp1 = 1.5 * SGP4_J2 * pinvsq * o.no;
+    const double temp2 = 0.5 * temp1 * SGP4_J2 * pinvsq;
+    const double temp3 = -0.46875 * SGP4_J4 * pinvsq * pinvsq * o.no;
+    o.mdot = o.no + 0.5 * temp1 * rteosq * con41 + 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+    o.argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) +
+                temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+    const double xhdot1 = -temp1 * cosio;
+    o.nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+    const double xpidot = o.argpdot + o.nodedot;
+    o.omgcof = o.bstar * cc3 * std::cos(o.argpo);
+    o.xmcof = o.ecco > 1e-4 ? -X2O3 * coef * o.bstar / eeta : 0.0;
+    o.nodecf = 3.5 * omeosq * xhdot1 * o.cc1;
+    o.t2cof = 1.5 * o.cc1;
+    o.delmo = std::pow(1.0 + o.eta * std::cos(o.mo), 3.0);
+    o.sinmao = std::sin(o.mo);
+
+    if (2.0 * PI / o.no >= 225.0) {
+        o.deepSpace = true;
+        o.isimp = true;
+        DeepCommon dc{};   // dsinit reads terms only dscom's lunar pass sets
+        dscom(jd - 2433281.5, o, dc);
+        dsinit(o, dc, xpidot);
+    }
+    if (!o.isimp) {
+        const double cc1sq = o.cc1 * o.cc1;
+        o.d2 = 4.0 * o.ao * tsi * cc1sq;
+        const double temp = o.d2 * tsi * o.cc1 / 3.0;
+        o.d3 = (17.0 * o.ao + sfour) * temp;
+        o.d4 = 0.5 * temp * o.ao * tsi * (221.0 * o.ao + 31.0 * sfour) * o.cc1;
+        o.t3cof = o.d2 + 2.0 * cc1sq;
+        o.t4cof = 0.25 * (3.0 * o.d3 + o.cc1 * (12.0 * o.d2 + 10.0 * cc1sq));
+        o.t5cof = 0.2 * (3.0 * o.d4 + 12.0 * o.cc1 * o.d3 + 6.0 * o.d2 * o.d2 + 15.0 * cc1sq * (2.0 * o.d2 + cc1sq));
+    }
+    return true;
+}
+
+bool sgp4Mean(Sgp4Orbit& o, double t, Sgp4Mean& out) {
+    // secular gravity and drag
+    const double xmdf = o.mo + o.mdot * t;
+    const double argpdf = o.argpo + o.argpdot * t;
+    const double nodedf = o.nodeo + o.nodedot * t;
+    double argpm = argpdf, mm = xmdf;
+    const double t2 = t * t;
+    double nodem = nodedf + o.nodecf * t2;
+    double tempa = 1.0 - o.cc1 * t;
+    double tempe = o.bstar * o.cc4 * t;
+    double templ = o.t2cof * t2;
+    if (!o.isimp) {
+        const double delomg = o.omgcof * t;
+        const double delmtemp = 1.0 + o.eta * std::cos(xmdf);
+        const double delm = o.xmcof * (delmtemp * delmtemp * delmtemp - o.delmo);
+        mm = xmdf + delomg + delm;
+        argpm = argpdf - delomg - delm;
+        const double t3 = t2 * t, t4 = t3 * t;
+        tempa -= o.d2 * t2 + o.d3 * t3 + o.d4 * t4;
+        tempe += o.bstar * o.cc5 * (std::sin(mm) - o.sinmao);
+        templ += o.t3cof * t3 + t4 * (o.t4cof + t * o.t5cof);
+    }
+    double nm = o.no, em = o.ecco, inclm = o.inclo;
+    if (o.deepSpace) dspace(o, t, em, argpm, inclm, mm, nodem, nm);
+    if (nm <= 0.0 || tempa <= 0.0) return false;
+
+    const double am = std::pow(SGP4_XKE / nm, X2O3) * tempa * tempa;
+    nm = SGP4_XKE / std::pow(am, 1.5);
+    em -= tempe;
+    if (em >= 1.0 || em < -0.001) return false;
+    if (em < 1e-6) em = 1e-6;
+    mm += o.no * templ;
+    const double xlm = std::fmod(mm + argpm + nodem, 2.0 * PI);
+    nodem = std::fmod(nodem, 2.0 * PI);
+    argpm = std::fmod(argpm, 2.0 * PI);
+    mm = std::fmod(xlm - argpm - nodem, 2.0 * PI);
+
+    if (o.deepSpace) {
+        dpper(o, t, em, inclm, nodem, argpm, mm);
+        if (inclm < 0.0) {
+            inclm = -inclm;
+            nodem += PI;
+            argpm -= PI;
+        }
+        if (em < 0.0 || em > 1.0) return false;
+    }
+    out = {am, nm, em, inclm, nodem, argpm, mm};
+    return true;
+}
+
+bool sgp4(Sgp4Orbit& o, double t, double r[3], double v[3]) {
+    Sgp4Mean m;
+    if (!sgp4Mean(o, t, m)) return false;
+
+    // long-period periodics
+    const double sinip = std::sin(m.inc), cosip = std::cos(m.inc);
+    const double aycof = -0.5 * J3OJ2 * sinip;
+    const double xlcof = -0.25 * J3OJ2 * sinip * (3.0 + 5.0 * cosip) / std::max(1.0 + cosip, 1.5e-12);
+    const double axnl = m.e * std::cos(m.argp);
+    double temp = 1.0 / (m.a * (1.0 - m.e * m.e));
+    const double aynl = m.e * std::sin(m.argp) + temp * aycof;
+    const double xl = m.M + m.argp + m.node + temp * xlcof * axnl;
+
+    // Kepler's equation in the modified form
+    const double u = std::fmod(xl - m.node, 2.0 * PI);
+    double eo1 = u, tem5 = 9999.9, sineo1 = 0.0, coseo1 = 0.0;
+    for (int ktr = 1; std::fabs(tem5) >= 1e-12 && ktr <= 10; ++ktr) {
+        sineo1 = std::sin(eo1);
+        coseo1 = std::cos(eo1);
+        tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / (1.0 - coseo1 * axnl - sineo1 * aynl);
+        tem5 = std::max(-0.95, std::min(0.95, tem5));
+        eo1 += tem5;
+    }
+
+    // short-period periodics
+    const double ecose = axnl * coseo1 + aynl * sineo1;
+    const double esine = axnl * sineo1 - aynl * coseo1;
+    const double el2 = axnl * axnl + aynl * aynl;
+    const double pl = m.a * (1.0 - el2);
+    if (pl < 0.0) return false;
+    const double rl = m.a * (1.0 - ecose);
+    const double rdotl = std::sqrt(m.a) * esine / rl;
+    const double rvdotl = std::sqrt(pl) / rl;
+    const double betal = std::sqrt(1.0 - el2);
+    temp = esine / (1.0 + betal);
+    const double sinu = m.a / rl * (sineo1 - aynl - axnl * temp);
+    const double cosu = m.a / rl * (coseo1 - axnl + aynl * temp);
+    double su = std::atan2(sinu, cosu);
+    const double sin2u = (cosu + cosu) * sinu;
+    const double cos2u = 1.0 - 2.0 * sinu * sinu;
+    temp = 1.0 / pl;
+    const double temp1 = 0.5 * SGP4_J2 * temp;
+    const double temp2 = temp1 * temp;
+    const double cosisq = cosip * cosip;
+    const double con41 = 3.0 * cosisq - 1.0, x1mth2 = 1.0 - cosisq, x7thm1 = 7.0 * cosisq - 1.0;
+
+    const double mrt = rl * (1.0 - 1.5 * temp2 * betal * con41) + 0.5 * temp1 * x1mth2 * cos2u;
+    su -= 0.25 * temp2 * x7thm1 * sin2u;
+    const double xnode = m.node + 1.5 * temp2 * cosip * sin2u;
+    const double xinc = m.inc + 1.5 * temp2 * cosip * sinip * cos2u;
+    const double mvt = rdotl - m.n * temp1 * x1mth2 * sin2u / SGP4_XKE;
+    const double rvdot = rvdotl + m.n * temp1 * (x1mth2 * cos2u + 1.5 * con41) / SGP4_XKE;
+
+    // orientation
+    const double sinsu = std::sin(su), cossu = std::cos(su);
+    const double snod = std::sin(xnode), cnod = std::cos(xnode);
+    const double sini = std::sin(xinc), cosi = std::cos(xinc);
+    const double xmx = -snod * cosi, xmy = cnod * cosi;
+    const double ux = xmx * sinsu + cnod * cossu, uy = xmy * sinsu + snod * cossu, uz = sini * sinsu;
+    const double vx = xmx * cossu - cnod * sinsu, vy = xmy * cossu - snod * sinsu, vz = sini * cossu;
+    const double vkmps = SGP4_EARTH_RADIUS_KM * SGP4_XKE / 60.0;
+    r[0] = mrt * ux * SGP4_EARTH_RADIUS_KM;
+    r[1] = mrt * uy * SGP4_EARTH_RADIUS_KM;
+    r[2] = mrt * uz * SGP4_EARTH_RADIUS_KM;
+    v[0] = (mvt * ux + rvdot * vx) * vkmps;
+    v[1] = (mvt * uy + rvdot * vy) * vkmps;
+    v[2] = (mvt * uz + rvdot * vz) * vkmps;
+    return mrt >= 1.0;   // below the surface: decayed
+}
+
+// --- catalogue ---
+static const size_t SGP4_PAD = 8;   // widest PackF
+
+SatelliteCatalog::SatelliteCatalog(ThreadPool* p) : level(detectSimdLevel()), pool(p) {}
+
+void SatelliteCatalog::resizePadded(size_t n) {
+    const size_t padded = (n + SGP4_PAD - 1) / SGP4_PAD * SGP4_PAD;
+    for (std::vector<double>* v : {&soa.epoch, &soa.mo, &soa.mdot, &soa.argpo, &soa.argpdot, &soa.nodeo, &soa.nodedot,
+                                   &soa.nodecf, &soa.cc1, &soa.bcc4, &soa.bcc5, &soa.d2, &soa.d3, &soa.d4, &soa.t2cof,
+                                   &soa.t3cof, &soa.t4cof, &soa.t5cof, &soa.omgcof, &soa.xmcof, &soa.eta, &soa.delmo,
+                                   &soa.sinmao, &soa.no, &soa.ao, &soa.ecco, &soa.inclo}) {
+        v->assign(n, 0.0);
+    }
+    // padding: a circular equatorial orbit at one earth radius, scale 0
+    soa.a.assign(padded, 1.0f);
+    for (std::vector<float>* v : {&soa.e, &soa.inc, &soa.node, &soa.argp, &soa.M, &soa.scale, &soa.x, &soa.y, &soa.z}) {
+        v->assign(padded, 0.0f);
+    }
+}
+
+void SatelliteCatalog::clear() {
+    soa.count = soa.nearCount = 0;
+    resizePadded(0);
+    deep.clear();
+    objectNames.clear();
+    rejected = lost = 0;
+}
+
+void SatelliteCatalog::assign(const std::vector<TwoLineElements>& sets) {
+    std::vector<Sgp4Orbit> nearOrbits;
+    std::vector<std::string> nearNames, deepNames;
+    deep.clear();
+    rejected = 0;
+    for (const TwoLineElements& tle : sets) {
+        Sgp4Orbit o;
+        if (!sgp4Init(tle, o)) {
+            ++rejected;
+            continue;
+        }
+        const std::string name = tle.name.empty() ? std::to_string(tle.catalogNumber) : tle.name;
+        if (o.deepSpace) {
+            deep.push_back(o);
+            deepNames.push_back(name);
+        } else {
+            nearOrbits.push_back(o);
+            nearNames.push_back(name);
+        }
+    }
+
+    soa.nearCount = nearOrbits.size();
+    soa.count = soa.nearCount + deep.size();
+    resizePadded(soa.count);
+    for (size_t k = 0; k < nearOrbits.size(); ++k) {
+        const Sgp4Orbit& o = nearOrbits[k];
+        soa.epoch[k] = o.epochDays;
+        soa.mo[k] = o.mo; soa.mdot[k] = o.mdot;
+        soa.argpo[k] = o.argpo; soa.argpdot[k] = o.argpdot;
+        soa.nodeo[k] = o.nodeo; soa.nodedot[k] = o.nodedot; soa.nodecf[k] = o.nodecf;
+        soa.cc1[k] = o.cc1; soa.bcc4[k] = o.bstar * o.cc4;
+        soa.t2cof[k] = o.t2cof;
+        soa.no[k] = o.no; soa.ao[k] = o.ao; soa.ecco[k] = o.ecco; soa.inclo[k] = o.inclo;
+        if (!o.isimp) {
+            // zero in the simplified case, which then needs no branch of its own
+            soa.bcc5[k] = o.bstar * o.cc5;
+            soa.d2[k] = o.d2; soa.d3[k] = o.d3; soa.d4[k] = o.d4;
+            soa.t3cof[k] = o.t3cof; soa.t4cof[k] = o.t4cof; soa.t5cof[k] = o.t5cof;
+            soa.omgcof[k] = o.omgcof; soa.xmcof[k] = o.xmcof;
+            soa.eta[k] = o.eta; soa.delmo[k] = o.delmo; soa.sinmao[k] = o.sinmao;
+        }
+    }
+    objectNames = std::move(nearNames);
+    objectNames.insert(objectNames.end(), deepNames.begin(), deepNames.end());
+    lost = 0;
+}
+
+bool SatelliteCatalog::load(const std::string& path) {
+    std::vector<TwoLineElements> sets;
+    size_t bad = 0;
+    if (!loadTleFile(path, sets, &bad)) return false;
+    assign(sets);
+    rejected += bad;
+    if (sets.empty()) std::cerr << "No two-line element sets in " << path << "\n";
+    return !sets.empty();
+}
+
+void SatelliteCatalog::propagate(double tDays) {
+    auto t0 = std::chrono::steady_clock::now();
+    const size_t n = soa.a.size();
+    const size_t chunk = 4096;   // multiple of every pack width
+    if (pool && n > chunk) {
+        std::atomic<size_t> lostCount{0};
+        pool->parallelFor(n, chunk, [&](size_t b, size_t e) { lostCount += propagateRange(tDays, b, e); });
+        lost = lostCount;
+    } else {
+        lost = propagateRange(tDays, 0, n);
+    }
+    lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+size_t SatelliteCatalog::propagateRange(double tDays, size_t begin, size_t end) {
+    const size_t lostHere = secularRange(tDays, begin, end);
+    switch (level) {
+#if defined(SOLAR_X86_KERNELS)
+        case SimdLevel::AVX2: simd_avx2::sgp4Kernel(soa, begin, end, keplerIterations); break;
+        case SimdLevel::SSE41: simd_sse41::sgp4Kernel(soa, begin, end, keplerIterations); break;
+#endif
+        default: simd_scalar::sgp4Kernel(soa, begin, end, keplerIterations); break;
+    }
+    return lostHere;
+}
+
+// Angles go to the float arrays in [-pi, pi), so the kernel never sees a large argument.
+static float reduced(double x) {
+    return (float)(x - 2.0 * PI * std::floor(x / (2.0 * PI) + 0.5));
+}
+
+size_t SatelliteCatalog::secularRange(double tDays, size_t begin, size_t end) {
+    const float km = (float)SGP4_EARTH_RADIUS_KM;
+    size_t lostHere = 0;
+    auto loseObject = [&](size_t k) {
+        soa.a[k] = 1.0f;
+        soa.e[k] = soa.inc[k] = soa.node[k] = soa.argp[k] = soa.M[k] = soa.scale[k] = 0.0f;
+        ++lostHere;
+    };
+
+    // near-Earth objects, straight from the SoA arrays (sgp4Mean without the deep-space terms)
+    for (size_t k = begin; k < std::min(end, soa.nearCount); ++k) {
+        const double t = (tDays - soa.epoch[k]) * MIN_PER_DAY;
+        const double t2 = t * t, t3 = t2 * t, t4 = t3 * t;
+        const double xmdf = soa.mo[k] + soa.mdot[k] * t;
+        double mm = xmdf, delm = 0.0;
+        if (soa.xmcof[k] != 0.0) {
+            const double delmtemp = 1.0 + soa.eta[k] * std::cos(xmdf);
+            delm = soa.xmcof[k] * (delmtemp * delmtemp * delmtemp - soa.delmo[k]);
+        }
+        const double temp = soa.omgcof[k] * t + delm;
+        mm += temp;
+        const double argpm = soa.argpo[k] + soa.argpdot[k] * t - temp;
+        const double nodem = soa.nodeo[k] + soa.nodedot[k] * t + soa.nodecf[k] * t2;
+        const double tempa = 1.0 - soa.cc1[k] * t - soa.d2[k] * t2 - soa.d3[k] * t3 - soa.d4[k] * t4;
+        double tempe = soa.bcc4[k] * t;
+        if (soa.bcc5[k] != 0.0) tempe += soa.bcc5[k] * (std::sin(mm) - soa.sinmao[k]);
+        const double templ = soa.t2cof[k] * t2 + soa.t3cof[k] * t3 + t4 * (soa.t4cof[k] + t * soa.t5cof[k]);
+        double em = soa.ecco[k] - tempe;
+        if (tempa <= 0.0 || em >= 1.0 || em < -0.001) {
+            loseObject(k);
+            continue;
+        }
+        soa.a[k] = (float)(soa.ao[k] * tempa * tempa);
+        soa.e[k] = (float)std::max(em, 1e-6);
+        soa.M[k] = reduced(mm + soa.no[k] * templ);
+        soa.argp[k] = reduced(argpm);
+        soa.node[k] = reduced(nodem);
+        soa.inc[k] = (float)soa.inclo[k];
+        soa.scale[k] = km;
+    }
+    // deep-space objects through the reference
+    for (size_t k = std::max(begin, soa.nearCount); k < std::min(end, soa.count); ++k) {
+        Sgp4Mean m;
+        if (!sgp4Mean(deep[k - soa.nearCount], (tDays - deep[k - soa.nearCount].epochDays) * MIN_PER_DAY, m)) {
+            loseObject(k);
+            continue;
+        }
+        soa.a[k] = (float)m.a;
+        soa.e[k] = (float)m.e;
+        soa.inc[k] = reduced(m.inc);
+        soa.node[k] = reduced(m.node);
+        soa.argp[k] = reduced(m.argp);
+        soa.M[k] = reduced(m.M);
+        soa.scale[k] = km;
+    }
+    return lostHere;
+}
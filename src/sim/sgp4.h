@@ -0,0 +1,167 @@
+// src/sim/sgp4.h
+// Earth satellites from two-line element sets (TLEs), propagated with SGP4
+// (and its deep-space extension SDP4, for periods of 225 minutes and over) as
+// in Vallado, Crawford, Hujsak & Kelso, "Revisiting Spacetrack Report #3"
+// (AIAA 2006-6753): WGS-72 constants, 'improved' operation mode. Output is
+// in the TEME frame (true equator, mean equinox of date), km and km/s.
+//
+// sgp4() is the double-precision reference. SatelliteCatalog propagates a
+// whole catalogue in two passes. The secular pass (drag, J2-J4 secular
+// rates, and for deep-space objects the lunar-solar terms and resonance
+// integration) runs in double per object, from SoA arrays for near-Earth
+// objects. It leaves the mean elements at the requested time, reduced to
+// small angles, in float arrays. The periodic pass (long- and short-period
+// J2/J3 terms, the Kepler solve and the orientation) is a per-ISA float
+// kernel over those arrays, as for the Kepler propagator.
+#pragma once
+
+#include "kepler.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// WGS-72, as SGP4 expects
+const double SGP4_EARTH_RADIUS_KM = 6378.135;
+const double SGP4_XKE = 0.07436691613317342;    // sqrt(GM) in earth radii^1.5 / minute
+const double SGP4_J2 = 0.001082616;
+const double SGP4_J3 = -0.00000253881;
+const double SGP4_J4 = -0.00000165597;
+const double MIN_PER_DAY = 1440.0;
+
+struct TwoLineElements {
+    std::string name;              // from the title line, if any
+    int catalogNumber = 0;
+    double epochDays = 0.0;        // days since J2000 (UTC)
+    double bstar = 0.0;            // drag term, 1 / earth radii
+    double inclination = 0.0;      // rad
+    double raan = 0.0;             // rad
+    double eccentricity = 0.0;
+    double argPerigee = 0.0;       // rad
+    double meanAnomaly = 0.0;      // rad
+    double meanMotion = 0.0;       // rev/day (Kozai mean motion, as in the TLE)
+};
+
+// Parse one element set. Checksums are verified where present.
+bool parseTle(const std::string& line1, const std::string& line2, TwoLineElements& out);
+// Every set in a text of two- or three-line sets; malformed ones are skipped
+// and counted in *rejected.
+std::vector<TwoLineElements> parseTleText(const std::string& text, size_t* rejected = nullptr);
+// The same for a file; false if it cannot be read.
+bool loadTleFile(const std::string& path, std::vector<TwoLineElements>& out, size_t* rejected = nullptr);
+// Format an element set as TLE lines 1 and 2 (with checksums).
+void formatTle(const TwoLineElements& tle, std::string& line1, std::string& line2);
+
+// --- reference propagator ---
+// Everything sgp4Init works out once per object. Deep-space objects also
+// carry the resonance integrator's state, which sgp4() moves along.
+struct Sgp4Orbit {
+    double epochDays = 0.0;
+    double bstar = 0.0, ecco = 0.0, inclo = 0.0, nodeo = 0.0, argpo = 0.0, mo = 0.0;
+    double no = 0.0;               // un-Kozai'd mean motion, rad/min
+    double ao = 0.0;               // semi-major axis at epoch, earth radii
+    bool isimp = false;            // perigee under 220 km: the drag terms are cut short
+    bool deepSpace = false;
+
+    // near-Earth secular terms
+    double mdot = 0.0, argpdot = 0.0, nodedot = 0.0, nodecf = 0.0;
+    double cc1 = 0.0, cc4 = 0.0, cc5 = 0.0, d2 = 0.0, d3 = 0.0, d4 = 0.0;
+    double t2cof = 0.0, t3cof = 0.0, t4cof = 0.0, t5cof = 0.0;
+    double omgcof = 0.0, xmcof = 0.0, eta = 0.0, delmo = 0.0, sinmao = 0.0;
+
+    // deep space: lunar-solar periodics (dpper)
+    double e3 = 0.0, ee2 = 0.0, se2 = 0.0, se3 = 0.0, sgh2 = 0.0, sgh3 = 0.0, sgh4 = 0.0;
+    double sh2 = 0.0, sh3 = 0.0, si2 = 0.0, si3 = 0.0, sl2 = 0.0, sl3 = 0.0, sl4 = 0.0;
+    double xgh2 = 0.0, xgh3 = 0.0, xgh4 = 0.0, xh2 = 0.0, xh3 = 0.0, xi2 = 0.0, xi3 = 0.0;
+    double xl2 = 0.0, xl3 = 0.0, xl4 = 0.0, zmol = 0.0, zmos = 0.0;
+    // deep space: secular rates and resonances (dspace)
+    int irez = 0;                  // 0 none, 1 synchronous, 2 half-day
+    double gsto = 0.0;             // Greenwich sidereal angle at epoch
+    double dedt = 0.0, didt = 0.0, dmdt = 0.0, dnodt = 0.0, domdt = 0.0;
+    double d2201 = 0.0, d2211 = 0.0, d3210 = 0.0, d3222 = 0.0, d4410 = 0.0;
+    double d4422 = 0.0, d5220 = 0.0, d5232 = 0.0, d5421 = 0.0, d5433 = 0.0;
+    double del1 = 0.0, del2 = 0.0, del3 = 0.0, xfact = 0.0, xlamo = 0.0;
+    double atime = 0.0, xli = 0.0, xni = 0.0;   // integrator state
+};
+
+// Mean elements at one time, after the secular and lunar-solar terms:
+// what the periodic pass starts from.
+struct Sgp4Mean {
+    double a;                      // earth radii
+    double n;                      // rad/min
+    double e, inc, node, argp, M;  // rad
+};
+
+// false if the elements are unusable (e.g. e >= 1 or a negative mean motion).
+bool sgp4Init(const TwoLineElements& tle, Sgp4Orbit& orb);
+// tMin: minutes since the element epoch. false once the orbit has decayed
+// or the elements have left their valid range.
+bool sgp4Mean(Sgp4Orbit& orb, double tMin, Sgp4Mean& out);
+bool sgp4(Sgp4Orbit& orb, double tMin, double r[3], double v[3]);
+
+// --- catalogue ---
+// Per-object data the passes read, one array per field, padded to a multiple
+// of the widest pack with a harmless circular orbit that is never drawn.
+struct Sgp4SoA {
+    size_t count = 0;
+    size_t nearCount = 0;          // near-Earth objects first, deep-space after
+    // secular pass, near-Earth objects (Sgp4Orbit fields)
+    std::vector<double> epoch, mo, mdot, argpo, argpdot, nodeo, nodedot, nodecf;
+    std::vector<double> cc1, bcc4, bcc5, d2, d3, d4, t2cof, t3cof, t4cof, t5cof;
+    std::vector<double> omgcof, xmcof, eta, delmo, sinmao, no, ao, ecco, inclo;
+    // mean elements at the current time, float, from the secular pass
+    std::vector<float> a, e, inc, node, argp, M;
+    std::vector<float> scale;      // km per earth radius; 0 puts a lost object at the centre
+    std::vector<float> x, y, z;    // TEME, km
+};
+
+class SatelliteCatalog {
+public:
+    explicit SatelliteCatalog(ThreadPool* pool = nullptr);
+
+    // Replace the catalogue with these sets; those sgp4Init rejects are
+    // skipped. Near-Earth objects are stored first, so names() and x()/y()/z()
+    // follow the catalogue's order within each group.
+    void assign(const std::vector<TwoLineElements>& sets);
+    bool load(const std::string& path);
+    void clear();
+    size_t size() const { return soa.count; }
+    size_t deepSpaceCount() const { return soa.count - soa.nearCount; }
+    const std::vector<std::string>& names() const { return objectNames; }
+
+    // Every object at tDays (days since J2000): refresh x()/y()/z().
+    void propagate(double tDays);
+
+    const float* x() const { return soa.x.data(); }
+    const float* y() const { return soa.y.data(); }
+    const float* z() const { return soa.z.data(); }
+
+    SimdLevel level;               // defaults to the best the CPU supports
+    int keplerIterations = 6;      // fixed Newton steps in the kernel; four reach float precision at e = 0.75
+    ThreadPool* pool = nullptr;
+
+    // statistics of the last load / propagate
+    size_t rejected = 0;           // sets that did not parse or initialise
+    size_t lost = 0;               // objects sgp4Mean gave up on (decayed)
+    double lastUpdateMs = 0.0;
+
+private:
+    void resizePadded(size_t n);
+    // Both passes over [begin, end); returns the objects lost there.
+    size_t propagateRange(double tDays, size_t begin, size_t end);
+    size_t secularRange(double tDays, size_t begin, size_t end);
+
+    Sgp4SoA soa;
+    std::vector<Sgp4Orbit> deep;   // soa index nearCount + k
+    std::vector<std::string> objectNames;
+};
+
+// --- kernels, one build per ISA ---
+// Periodic pass over [begin, end); both multiples of 8.
+namespace simd_scalar { void sgp4Kernel(Sgp4SoA& soa, size_t begin, size_t end, int iterations); }
+#if defined(SOLAR_X86_KERNELS)
+namespace simd_sse41 { void sgp4Kernel(Sgp4SoA& soa, size_t begin, size_t end, int iterations); }
+namespace simd_avx2 { void sgp4Kernel(Sgp4SoA& soa, size_t begin, size_t end, int iterations); }
+#endif
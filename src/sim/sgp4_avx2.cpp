@@ -0,0 +1,3 @@
+// src/sim/sgp4_avx2.cpp
+// AVX2/FMA build of the SGP4 kernel (compiled with -mavx2 -mfma).
+#include "sgp4_kernel.inl"
@@ -0,0 +1,91 @@
+// src/sim/sgp4_kernel.inl
+// SGP4 periodic pass written once against PackF: long-period J3 terms, the
+// Kepler solve, short-period J2 terms and the orientation, from the mean
+// elements the secular pass left. Included by sgp4_{scalar,sse,avx2}.cpp,
+// each compiled with its own ISA flags. Every lane runs the same fixed number
+// of clamped Newton steps, so there are no divergent loops.
+#include "sgp4.h"
+#include "simd_pack.h"
+
+namespace SIMD_NS {
+
+void sgp4Kernel(Sgp4SoA& soa, size_t begin, size_t end, int iterations) {
+    const int W = PackF::width;
+    const PackF one(1.0f), half(0.5f), j2((float)SGP4_J2), j3oj2((float)(SGP4_J3 / SGP4_J2));
+    const PackF twoPi(6.28318530717958648f), invTwoPi(0.159154943091895336f);
+    for (size_t k = begin; k < end; k += W) {
+        const PackF a = PackF::load(&soa.a[k]);
+        const PackF e = PackF::load(&soa.e[k]);
+        const PackF inc = PackF::load(&soa.inc[k]);
+        const PackF node = PackF::load(&soa.node[k]);
+        const PackF argp = PackF::load(&soa.argp[k]);
+
+        // long-period periodics
+        PackF sinip, cosip, sw, cw;
+        sincos(inc, sinip, cosip);
+        sincos(argp, sw, cw);
+        const PackF aycof = PackF(-0.5f) * j3oj2 * sinip;
+        const PackF xlcof = PackF(-0.25f) * j3oj2 * sinip * fmadd(PackF(5.0f), cosip, PackF(3.0f)) /
+                            max(one + cosip, PackF(1.5e-12f));
+        const PackF axnl = e * cw;
+        PackF temp = one / (a * (one - e * e));
+        const PackF aynl = fmadd(e, sw, temp * aycof);
+        PackF u = fmadd(temp * xlcof, axnl, PackF::load(&soa.M[k]) + argp);   // xl - node
+        u = u - twoPi * round(u * invTwoPi);
+
+        // Kepler's equation in the modified form
+        PackF eo1 = u, s, c;
+        for (int it = 0; it < iterations; ++it) {
+            sincos(eo1, s, c);
+            PackF step = (u - aynl * c + axnl * s - eo1) / (one - c * axnl - s * aynl);
+            step = max(PackF(-0.95f), min(PackF(0.95f), step));
+            eo1 = eo1 + step;
+        }
+        sincos(eo1, s, c);
+
+        // short-period periodics
+        const PackF ecose = fmadd(axnl, c, aynl * s);
+        const PackF esine = axnl * s - aynl * c;
+        const PackF el2 = fmadd(axnl, axnl, aynl * aynl);
+        const PackF pl = a * (one - el2);
+        const PackF rl = a * (one - ecose);
+        const PackF betal = sqrt(one - el2);
+        temp = esine / (one + betal);
+        const PackF ar = a / rl;
+        PackF sinu = ar * (s - aynl - axnl * temp);
+        PackF cosu = ar * (c - axnl + aynl * temp);
+        const PackF sin2u = PackF(2.0f) * cosu * sinu;
+        const PackF cos2u = one - PackF(2.0f) * sinu * sinu;
+        temp = one / pl;
+        const PackF temp1 = half * j2 * temp;
+        const PackF temp2 = temp1 * temp;
+        const PackF cosisq = cosip * cosip;
+        const PackF con41 = PackF(3.0f) * cosisq - one;
+        const PackF x1mth2 = one - cosisq;
+        const PackF x7thm1 = PackF(7.0f) * cosisq - one;
+        const PackF mrt = fmadd(rl, one - PackF(1.5f) * temp2 * betal * con41, half * temp1 * x1mth2 * cos2u);
+        const PackF dsu = PackF(-0.25f) * temp2 * x7thm1 * sin2u;
+        const PackF xnode = fmadd(PackF(1.5f) * temp2 * cosip, sin2u, node);
+        const PackF xinc = fmadd(PackF(1.5f) * temp2 * cosip * sinip, cos2u, inc);
+
+        // su = atan2(sinu, cosu) + dsu, as a rotation of the unit pair; |dsu| < ~1e-3
+        const PackF norm = one / sqrt(fmadd(sinu, sinu, cosu * cosu));
+        sinu = sinu * norm;
+        cosu = cosu * norm;
+        const PackF cd = one - half * dsu * dsu;
+        const PackF sinsu = fmadd(sinu, cd, cosu * dsu);
+        const PackF cossu = cosu * cd - sinu * dsu;
+
+        // orientation
+        PackF snod, cnod, sini, cosi;
+        sincos(xnode, snod, cnod);
+        sincos(xinc, sini, cosi);
+        const PackF r = mrt * PackF::load(&soa.scale[k]);
+        const PackF xmx = -snod * cosi, xmy = cnod * cosi;
+        (r * fmadd(xmx, sinsu, cnod * cossu)).store(&soa.x[k]);
+        (r * fmadd(xmy, sinsu, snod * cossu)).store(&soa.y[k]);
+        (r * sini * sinsu).store(&soa.z[k]);
+    }
+}
+
+} // namespace SIMD_NS
@@ -0,0 +1,4 @@
+// src/sim/sgp4_scalar.cpp
+// Baseline build of the SGP4 kernel; the fallback on every platform.
+#define SIMD_FORCE_SCALAR
+#include "sgp4_kernel.inl"
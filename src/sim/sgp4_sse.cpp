@@ -0,0 +1,4 @@
+// src/sim/sgp4_sse.cpp
+// SSE4.1 build of the SGP4 kernel (compiled with -msse4.1).
+#define SIMD_FORCE_SSE41
+#include "sgp4_kernel.inl"
@@ -0,0 +1,99 @@
+// src/sim/sim_lod.cpp
+#include "sim_lod.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+void classifySystems(const BodyRegistry& reg, const float* x, const float* y, const float* z,
+                     const float* viewProj, float pixelScale, float minPixels, uint8_t* lod) {
+    // frustum planes from the rows of viewProj (Gribb-Hartmann), normalised
+    auto row = [&](int r, float* out) {
+        for (int c = 0; c < 4; ++c) out[c] = viewProj[c * 4 + r];
+    };
+    float r0[4], r1[4], r2[4], r3[4];
+    row(0, r0); row(1, r1); row(2, r2); row(3, r3);
+    float planes[6][4];
+    for (int c = 0; c < 4; ++c) {
+        planes[0][c] = r3[c] + r0[c]; planes[1][c] = r3[c] - r0[c];
+        planes[2][c] = r3[c] + r1[c]; planes[3][c] = r3[c] - r1[c];
+        planes[4][c] = r3[c] + r2[c]; planes[5][c] = r3[c] - r2[c];
+    }
+    for (auto& p : planes) {
+        const float len = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+        if (len > 0.0f) for (float& v : p) v /= len;
+    }
+
+    for (size_t i = 0; i < reg.rootCount; ++i) {
+        // bounding sphere of the planet and its moon orbits
+        float radius = reg.bodySize[i];
+        for (uint32_t m = reg.moonBegin[i]; m < reg.moonEnd[i]; ++m) {
+            radius = std::max(radius, reg.orbitRadius[m] + reg.bodySize[m]);
+        }
+        bool inside = true;
+        for (const auto& p : planes) {
+            if (p[0] * x[i] + p[1] * y[i] + p[2] * z[i] + p[3] < -radius) { inside = false; break; }
+        }
+        const float w = r3[0] * x[i] + r3[1] * y[i] + r3[2] * z[i] + r3[3];
+        if (w <= radius) lod[i] = LOD_FULL;
+        else if (!inside) lod[i] = LOD_CULLED;
+        else lod[i] = radius * pixelScale / w < minPixels ? LOD_REDUCED : LOD_FULL;
+    }
+}
+
+void SimLodScheduler::setTiers(const BodyRegistry& reg, const std::vector<uint8_t>& systemLod, int focus,
+                               std::vector<uint8_t>& mask) {
+    const size_t roots = reg.rootCount;
+    if (lastTick.size() != roots) {
+        tier.assign(roots, LOD_FULL);
+        lastTick.assign(roots, 0);
+    }
+    for (size_t i = 0; i < roots; ++i) {
+        const uint8_t t = i < systemLod.size() && (int)i != focus ? systemLod[i] : (uint8_t)LOD_FULL;
+        // a system leaving FULL is current as of now
+        if (tier[i] == LOD_FULL && t != LOD_FULL) lastTick[i] = tickCount;
+        tier[i] = t;
+    }
+    mask.assign(reg.size(), 1);
+    fullBodies = roots;
+    frozenBodies = 0;
+    for (size_t i = 0; i < roots; ++i) {
+        const size_t moons = reg.moonEnd[i] - reg.moonBegin[i];
+        if (tier[i] == LOD_FULL) { fullBodies += moons; continue; }
+        std::fill(mask.begin() + reg.moonBegin[i], mask.begin() + reg.moonEnd[i], (uint8_t)0);
+        if (tier[i] == LOD_CULLED) frozenBodies += moons;
+    }
+}
+
+void SimLodScheduler::evaluateFull(BodyRegistry& reg, double simSeconds) const {
+    evaluateBodies(reg, simSeconds, 0, reg.rootCount);
+    for (size_t i = 0; i < reg.rootCount; ++i) {
+        if (i >= tier.size() || tier[i] == LOD_FULL) evaluateBodies(reg, simSeconds, reg.moonBegin[i], reg.moonEnd[i]);
+    }
+}
+
+void SimLodScheduler::refresh(BodyRegistry& draw, double simSeconds) {
+    auto t0 = std::chrono::steady_clock::now();
+    ++tickCount;
+    refreshedBodies = 0;
+    deferredSystems = 0;
+    const size_t roots = tier.size();
+    bool overBudget = false;
+    for (size_t k = 0; k < roots; ++k) {
+        const size_t i = (cursor + k) % roots;
+        if (tier[i] != LOD_REDUCED || tickCount - lastTick[i] < (uint64_t)reducedInterval) continue;
+        if (!overBudget) {
+            overBudget = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count()
+                         >= budgetMs;
+            // the next tick starts where this one ran out
+            if (overBudget) cursor = i;
+        }
+        if (overBudget) { ++deferredSystems; continue; }
+        // moons of one planet are contiguous, so this is one short sweep
+        evaluateBodies(draw, simSeconds, draw.moonBegin[i], draw.moonEnd[i]);
+        refreshedBodies += draw.moonEnd[i] - draw.moonBegin[i];
+        lastTick[i] = tickCount;
+    }
+    if (!overBudget && roots > 0) cursor = (cursor + 1) % roots;
+    lastMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
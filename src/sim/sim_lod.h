@@ -0,0 +1,52 @@
+// src/sim/sim_lod.h
+// Level of detail for the simulation. Each planet's moon system is stepped at
+// full rate when it is in focus or large on screen, refreshed from the closed
+// form every few ticks when it is small, and left frozen while off screen.
+// Refreshes are time-sliced round robin under a hard per-tick budget, so the
+// tick cost stays flat however many moons there are.
+#pragma once
+
+#include "body_registry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum SimLod : uint8_t { LOD_FULL = 0, LOD_REDUCED, LOD_CULLED };
+
+// Tier of every planet system (planet plus moons) against the camera.
+// viewProj is column-major; pixelScale = viewport height * proj[1][1] / 2, the
+// on-screen pixels of one scene unit at distance one. A system whose moon
+// orbits span fewer than minPixels is REDUCED and one outside the frustum is
+// CULLED; a camera inside a system always makes it FULL.
+void classifySystems(const BodyRegistry& reg, const float* x, const float* y, const float* z,
+                     const float* viewProj, float pixelScale, float minPixels, uint8_t* lod);
+
+struct SimLodScheduler {
+    double budgetMs = 0.5;          // hard cap on closed-form refreshes per tick
+    int reducedInterval = 8;        // ticks between refreshes of a REDUCED system
+
+    // Set the per-planet tiers (empty = everything FULL; `focus`, a planet
+    // index or -1, is FULL regardless) and fill mask[] for
+    // FixedStepper::setActive. Planets are always stepped, only moons drop out.
+    void setTiers(const BodyRegistry& reg, const std::vector<uint8_t>& systemLod, int focus,
+                  std::vector<uint8_t>& mask);
+    // Closed form for the planets and the moons of FULL systems.
+    void evaluateFull(BodyRegistry& reg, double simSeconds) const;
+    // Closed-form update of the REDUCED systems that are due, round robin
+    // from where the last tick ran out of budget, until the budget is spent.
+    void refresh(BodyRegistry& draw, double simSeconds);
+
+    // --- stats of the last refresh ---
+    size_t fullBodies = 0;          // planets + moons of FULL systems
+    size_t refreshedBodies = 0;
+    size_t deferredSystems = 0;     // due but over budget
+    size_t frozenBodies = 0;        // CULLED moons, not touched
+    double lastMs = 0.0;
+
+private:
+    std::vector<uint8_t> tier;      // per planet
+    std::vector<uint64_t> lastTick; // per planet, tick of the last refresh
+    uint64_t tickCount = 0;
+    size_t cursor = 0;
+};
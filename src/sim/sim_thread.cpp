@@ -0,0 +1,420 @@
+// src/sim/sim_thread.cpp
+#include "sim_thread.h"
+
+#include <chrono>
+#include <cmath>
+
+SimulationThread::SimulationThread(ThreadPool* pool, size_t extraMoons) : nbody(pool), belt(pool), sats(pool), fleet(pool) {
+    std::vector<Planet> planets = createSolarSystem();
+    addSyntheticMoons(planets, extraMoons);
+    bodies = buildRegistry(planets);
+    fleet.setBodies(planets);
+    drawBodies = bodies;
+    std::vector<OrbitalElements> els = planetElementsJ2000();
+    keplerScale.resize(planets.size());
+    for (size_t i = 0; i < planets.size(); ++i) {
+        keplerProp.add(els[i]);
+        keplerScale[i] = planets[i].orbitRadius / (float)els[i].a;
+        // trails span three quarters of an orbit
+        trailSpacing.push_back(0.75 * TWO_PI / (GAUSS_K * std::pow(els[i].a, -1.5)) / TRAIL_SAMPLES);
+    }
+    for (size_t i = bodies.rootCount; i < bodies.size(); ++i) {
+        if (bodies.info[i].name == "Moon") moonIndex = (int)i;
+    }
+    restartAt(0);
+    tick(0.0);   // the renderer always has a snapshot to draw
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+bool SimulationThread::loadEphemeris(const std::string& path) {
+    return eph.open(path);
+}
+
+bool SimulationThread::loadJplEphemeris(const std::string& path) {
+    return de.open(path);
+}
+
+bool SimulationThread::loadVsop87(const std::string& dir) {
+    return vsop.load(dir);
+}
+
+bool SimulationThread::loadTle(const std::string& path) {
+    return sats.load(path);
+}
+
+void SimulationThread::start() {
+    if (worker.joinable()) return;
+    stopping = false;
+    worker = std::thread([this] { run(); });
+}
+
+void SimulationThread::stop() {
+    stopping = true;
+    if (worker.joinable()) worker.join();
+}
+
+void SimulationThread::setControls(const SimControls& c) {
+    std::lock_guard<std::mutex> lk(controlMutex);
+    ctl = c;
+}
+
+SimControls SimulationThread::controls() const {
+    std::lock_guard<std::mutex> lk(controlMutex);
+    return ctl;
+}
+
+void SimulationThread::jumpTo(double days) {
+    jumpToTicks(ticksFromDays(days));
+}
+
+void SimulationThread::jumpToTicks(SimTicks t) {
+    std::lock_guard<std::mutex> lk(controlMutex);
+    jumpPending = true;
+    jumpTime = t;
+}
+
+void SimulationThread::record(const std::string& path) {
+    std::lock_guard<std::mutex> lk(controlMutex);
+    recordPending = true;
+    recordPath = path;
+}
+
+void SimulationThread::launchSpacecraft(int planet, size_t count, double vMinKms, double vMaxKms) {
+    std::lock_guard<std::mutex> lk(controlMutex);
+    launches.push_back({planet, count, vMinKms, vMaxKms});
+}
+
+void SimulationThread::clearSpacecraft() {
+    std::lock_guard<std::mutex> lk(controlMutex);
+    clearCraftPending = true;
+    launches.clear();
+}
+
+const SimSnapshot& SimulationThread::latest() {
+    snapshots.update();
+    return snapshots.front();
+}
+
+void SimulationThread::restartAt(SimTicks t) {
+    simTime = t;
+    const double days = ticksToDays(t);
+    evaluateBodies(bodies, ticksToSeconds(t));
+    // systems off the full tier are not redrawn until due, so start them right
+    evaluateBodies(drawBodies, ticksToSeconds(t));
+    stepper.reset(bodies);
+    rewindNBody(days);
+}
+
+void SimulationThread::rewindNBody(double days) {
+    auto t0 = std::chrono::steady_clock::now();
+    double at;
+    // far past the newest checkpoint the elements are quicker than integrating the gap
+    const bool covered = days <= checkpoints.newest() + checkpoints.intervalDays;
+    if (covered && checkpoints.nearest(days, at, checkpointScratch) && nbody.restoreState(checkpointScratch)) {
+        // steps from here on may not retrace the old ones exactly
+        checkpoints.truncateAfter(at);
+        rewindFromDays = at;
+        rewindGapDays = days - at;
+        rewindPending = true;
+    } else {
+        nbody.setState(createSolarSystemNBody(days), days);
+        checkpoints.clear();
+        nbody.saveState(checkpointScratch);
+        checkpoints.push(days, checkpointScratch);
+        rewindPending = false;
+    }
+    rewindMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    clearTrails();
+}
+
+void SimulationThread::clearTrails() {
+    const size_t n = trailSpacing.size();
+    trailRing.assign(n * TRAIL_SAMPLES * 3, 0.0f);
+    trailHead.assign(n, 0);
+    trailFill.assign(n, 0);
+    trailNext.assign(n, nbody.time);
+}
+
+// Called after every N-body step covering [t0, t1]: trail points fall on a
+// fixed time grid and are read from the dense output (DOP853) rather than
+// by making the integrator stop on them.
+void SimulationThread::sampleTrails(double t0, double t1) {
+    for (size_t i = 0; i < trailSpacing.size(); ++i) {
+        // after a long jump only the newest TRAIL_SAMPLES points matter
+        const double oldest = t1 - trailSpacing[i] * TRAIL_SAMPLES;
+        if (trailNext[i] < oldest) trailNext[i] = oldest;
+        for (; trailNext[i] <= t1; trailNext[i] += trailSpacing[i]) {
+            double h[3];
+            if (trailNext[i] < t0 || !nbody.heliocentricAt(i + 1, trailNext[i], h)) nbody.heliocentric(i + 1, h);
+            float* p = &trailRing[(i * TRAIL_SAMPLES + trailHead[i]) * 3];
+            p[0] = (float)h[0] * keplerScale[i];
+            p[1] = (float)h[2] * keplerScale[i];
+            p[2] = (float)h[1] * keplerScale[i];
+            trailHead[i] = (trailHead[i] + 1) % TRAIL_SAMPLES;
+            if (trailFill[i] < TRAIL_SAMPLES) ++trailFill[i];
+        }
+    }
+}
+
+void SimulationThread::applyControls(const SimControls& c) {
+    stepper.maxSubstepsPerFrame = c.substepBudget;
+    // block levels are phased on the substep count: restart them on a mode change
+    if (c.blockSteps != stepper.blockSteps || c.closedForm != stepperClosedForm) {
+        stepper.blockSteps = c.blockSteps;
+        stepperClosedForm = c.closedForm;
+        stepper.reset(bodies);
+    }
+    lod.budgetMs = c.lodBudgetMs;
+    lod.reducedInterval = c.lodInterval;
+    lod.setTiers(bodies, c.simLod ? c.systemLod : std::vector<uint8_t>(), c.focusBody, lodMask);
+    stepper.setActive(bodies, lodMask, simTime);
+    checkpoints.intervalDays = c.checkpointDays;
+    checkpoints.budgetBytes = c.checkpointBudgetMB << 20;
+    nbody.integrator = c.integrator;
+    nbody.forceMethod = c.barnesHut ? ForceMethod::BarnesHut : ForceMethod::Direct;
+    nbody.tree.theta = c.theta;
+    if (c.showBelt && belt.size() != c.beltCount) belt.generate(c.beltCount);
+}
+
+void SimulationThread::run() {
+    using clock = std::chrono::steady_clock;
+    auto last = clock::now();
+    while (!stopping) {
+        auto now = clock::now();
+        tick(std::chrono::duration<double>(now - last).count());
+        last = now;
+        std::this_thread::sleep_until(now + std::chrono::duration<double>(tickSeconds));
+    }
+}
+
+void SimulationThread::tick(double dtReal) {
+    auto t0 = std::chrono::steady_clock::now();
+    SimControls c;
+    bool jump;
+    SimTicks jumpTarget;
+    std::string recordTo;
+    bool recordChange;
+    std::vector<LaunchRequest> launchNow;
+    bool clearCraft;
+    {
+        std::lock_guard<std::mutex> lk(controlMutex);
+        c = ctl;
+        jump = jumpPending;
+        jumpTarget = jumpTime;
+        jumpPending = false;
+        recordChange = recordPending;
+        recordTo = recordPath;
+        recordPending = false;
+        launchNow.swap(launches);
+        clearCraft = clearCraftPending;
+        clearCraftPending = false;
+    }
+    if (recordChange) {
+        recorder.close();
+        if (!recordTo.empty()) recorder.open(recordTo, bodies.size());   // the snapshot reports it
+    }
+    applyControls(c);
+    if (jump) restartAt(jumpTarget);
+
+    double dtSim = c.running ? dtReal * c.timeMultiplier : 0.0;
+    stepper.advance(bodies, simTime, dtSim, c.closedForm);
+    if (clearCraft) fleet.clear();
+    const double launchDays = ticksToDays(stepper.renderTime(simTime));
+    for (const LaunchRequest& l : launchNow) {
+        for (size_t k = 0; k < l.count; ++k) {
+            const double f = l.count > 1 ? (double)k / (double)(l.count - 1) : 0.0;
+            fleet.launch(l.planet, launchDays, l.vMin + f * (l.vMax - l.vMin), launchSeed++);
+        }
+    }
+
+    SimSnapshot& s = snapshots.back();
+    fill(s, c);
+    s.tickMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    snapshots.publish();
+}
+
+void SimulationThread::fill(SimSnapshot& s, const SimControls& c) {
+    const SimTicks renderTime = stepper.renderTime(simTime);
+    const double renderDays = ticksToDays(renderTime);
+    if (c.closedForm) {
+        lod.evaluateFull(bodies, ticksToSeconds(simTime));
+        lod.evaluateFull(drawBodies, ticksToSeconds(renderTime));
+    } else {
+        stepper.interpolate(bodies, drawBodies);
+    }
+    lod.refresh(drawBodies, ticksToSeconds(renderTime));
+
+    s.px.resize(drawBodies.size()); s.py.resize(drawBodies.size()); s.pz.resize(drawBodies.size());
+    const size_t n = drawBodies.rootCount;
+    if (c.orbitModel == ORBIT_KEPLER) {
+        keplerProp.propagate(renderDays);
+        for (size_t i = 0; i < n; ++i) {
+            // ecliptic (z up) -> scene (y up)
+            s.px[i] = keplerProp.x()[i] * keplerScale[i];
+            s.py[i] = keplerProp.z()[i] * keplerScale[i];
+            s.pz[i] = keplerProp.y()[i] * keplerScale[i];
+        }
+    } else if (c.orbitModel == ORBIT_NBODY) {
+        // the integrator only runs forwards; going back restores a checkpoint
+        if (renderDays < nbody.stepBegin()) rewindNBody(renderDays);
+        // DOP853 chooses its own steps and the frame time is interpolated
+        const double dtMax = nbody.integrator == Integrator::DOP853 ? 30.0 : 1.0;
+        auto t0 = std::chrono::steady_clock::now();
+        int taken = nbody.advanceTo(renderDays, dtMax, 20000, [&](double a, double b) {
+            if (c.showTrails) sampleTrails(a, b);
+            if (checkpoints.due(b)) {
+                nbody.saveState(checkpointScratch);
+                checkpoints.push(b, checkpointScratch);
+            }
+        });
+        double spent = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (rewindPending) {
+            rewindMs += spent * 1000.0;
+            rewindPending = false;
+        }
+        if (taken > 0 && spent > 0.0) nbodyStepsPerSec = taken / spent;
+        for (size_t i = 0; i < n; ++i) {
+            double h[3];
+            if (!nbody.heliocentricAt(i + 1, renderDays, h)) nbody.heliocentric(i + 1, h);
+            s.px[i] = (float)h[0] * keplerScale[i];
+            s.py[i] = (float)h[2] * keplerScale[i];
+            s.pz[i] = (float)h[1] * keplerScale[i];
+        }
+    } else if (c.orbitModel == ORBIT_EPHEMERIS) {
+        // precomputed Chebyshev series; the Kepler elements outside its coverage
+        const bool covered = eph.valid() && eph.bodyCount() >= n &&
+                             renderDays >= eph.startDays() && renderDays <= eph.endDays();
+        if (!covered) keplerProp.propagate(renderDays);
+        for (size_t i = 0; i < n; ++i) {
+            double h[3];
+            if (covered) eph.evaluateTicks(i, renderTime, h);
+            else { h[0] = keplerProp.x()[i]; h[1] = keplerProp.y()[i]; h[2] = keplerProp.z()[i]; }
+            s.px[i] = (float)h[0] * keplerScale[i];
+            s.py[i] = (float)h[2] * keplerScale[i];
+            s.pz[i] = (float)h[1] * keplerScale[i];
+        }
+        s.ephemerisCovered = covered;
+    } else if (c.orbitModel == ORBIT_JPL_DE) {
+        // JPL positions in place of the hardcoded periods and circular radii
+        double h[24];
+        const bool covered = n <= 8 && de.planetsTicks(renderTime, h);
+        if (!covered) keplerProp.propagate(renderDays);
+        for (size_t i = 0; i < n; ++i) {
+            double x = covered ? h[3 * i] : keplerProp.x()[i];
+            double y = covered ? h[3 * i + 1] : keplerProp.y()[i];
+            double z = covered ? h[3 * i + 2] : keplerProp.z()[i];
+            s.px[i] = (float)x * keplerScale[i];
+            s.py[i] = (float)z * keplerScale[i];
+            s.pz[i] = (float)y * keplerScale[i];
+        }
+        // the Moon keeps its display radius but takes its direction from DE
+        double m[3];
+        if (covered && moonIndex >= 0 && de.moonTicks(renderTime, m)) {
+            drawBodies.orbitAngle[moonIndex] = (float)(std::atan2(m[1], m[0]) * 360.0 / TWO_PI);
+        }
+        s.ephemerisCovered = covered;
+    } else if (c.orbitModel == ORBIT_VSOP87 && vsop.valid() && n <= 8) {
+        double h[24];
+        vsop.planets(renderDays, c.vsopLevel, h);
+        for (size_t i = 0; i < n; ++i) {
+            s.px[i] = (float)h[3 * i] * keplerScale[i];
+            s.py[i] = (float)h[3 * i + 2] * keplerScale[i];
+            s.pz[i] = (float)h[3 * i + 1] * keplerScale[i];
+        }
+    } else {
+        rootPositions(drawBodies, s.px.data(), s.py.data(), s.pz.data());
+    }
+    moonPositions(drawBodies, s.px.data(), s.py.data(), s.pz.data());
+    // craft are placed relative to the bodies; new ones search their events here, on the pool
+    fleet.update(renderDays);
+    fleet.scenePositions(s.px.data(), s.py.data(), s.pz.data(), s.craft);
+    s.model.resize(16 * drawBodies.size());
+    modelMatrices(drawBodies, s.px.data(), s.py.data(), s.pz.data(), s.model.data());
+
+    if (c.showBelt) {
+        belt.update(renderDays);
+        const size_t m = belt.size();
+        s.beltX.assign(belt.x(), belt.x() + m);
+        s.beltY.assign(belt.y(), belt.y() + m);
+        s.beltZ.assign(belt.z(), belt.z() + m);
+    } else {
+        s.beltX.clear(); s.beltY.clear(); s.beltZ.clear();
+    }
+    if (c.showSatellites && sats.size() > 0) {
+        sats.propagate(renderDays);
+        const size_t m = sats.size();
+        s.satX.assign(sats.x(), sats.x() + m);
+        s.satY.assign(sats.y(), sats.y() + m);
+        s.satZ.assign(sats.z(), sats.z() + m);
+    } else {
+        s.satX.clear(); s.satY.clear(); s.satZ.clear();
+    }
+
+    s.sequence = ++sequence;
+    s.time = simTime;
+    s.renderTime = renderTime;
+    s.timeDays = ticksToDays(simTime);
+    s.renderDays = renderDays;
+    s.substeps = stepper.lastSubsteps;
+    s.bodyUpdates = stepper.lastBodyUpdates;
+    s.lodFull = lod.fullBodies;
+    s.lodRefreshed = lod.refreshedBodies;
+    s.lodDeferred = lod.deferredSystems;
+    s.lodFrozen = lod.frozenBodies;
+    s.lodMs = lod.lastMs;
+    s.stepSeconds = stepper.stepSeconds;
+    s.droppedSeconds = stepper.droppedSeconds;
+    s.nbodyStepsPerSec = nbodyStepsPerSec;
+    s.energyDrift = c.orbitModel == ORBIT_NBODY ? nbody.energyDrift() : 0.0;
+    s.nbodySteps = nbody.steps;
+    s.nbodyRejected = nbody.rejectedSteps;
+    s.nbodyForceEvals = nbody.forceEvaluations;
+    if (c.orbitModel == ORBIT_NBODY && c.showTrails) {
+        // unroll the rings oldest first so each planet is one line strip
+        const size_t np = trailSpacing.size();
+        s.trail.resize(np * TRAIL_SAMPLES * 3);
+        s.trailLength.resize(np);
+        for (size_t i = 0; i < np; ++i) {
+            const size_t len = trailFill[i];
+            const size_t start = (trailHead[i] + TRAIL_SAMPLES - len) % TRAIL_SAMPLES;
+            for (size_t k = 0; k < len; ++k) {
+                const float* src = &trailRing[(i * TRAIL_SAMPLES + (start + k) % TRAIL_SAMPLES) * 3];
+                float* dst = &s.trail[(i * TRAIL_SAMPLES + k) * 3];
+                dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2];
+            }
+            s.trailLength[i] = (uint32_t)len;
+        }
+    } else {
+        s.trail.clear();
+        s.trailLength.clear();
+    }
+    s.checkpoints = checkpoints.count();
+    s.checkpointBytes = checkpoints.bytes();
+    s.checkpointRatio = checkpoints.ratio();
+    s.checkpointOldest = checkpoints.oldest();
+    s.checkpointNewest = checkpoints.newest();
+    s.rewindFromDays = rewindFromDays;
+    s.rewindGapDays = rewindGapDays;
+    s.rewindMs = rewindMs;
+    if (recorder.recording()) {
+        recorder.add(renderTime, s.px.data(), s.py.data(), s.pz.data(), drawBodies.rotationAngle.data());
+    }
+    s.recording = recorder.recording();
+    s.recordedFrames = recorder.frames();
+    s.recordedBytes = recorder.bytes();
+    s.beltUpdateMs = belt.lastUpdateMs;
+    s.craftCount = fleet.size();
+    s.craftSwitches = fleet.switches;
+    s.craftSearched = fleet.searched;
+    s.craftUpdateMs = fleet.lastUpdateMs;
+    s.satCount = sats.size();
+    s.satDeep = sats.deepSpaceCount();
+    s.satLost = sats.lost;
+    s.satRejected = sats.rejected;
+    s.satUpdateMs = sats.lastUpdateMs;
+    s.beltMinAU = (float)belt.minRadius();
+    s.beltMaxAU = (float)belt.maxRadius();
+}
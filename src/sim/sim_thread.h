@@ -0,0 +1,208 @@
+// src/sim/sim_thread.h
+// Simulation on its own thread. Every tick it advances the fixed-step clock,
+// evaluates the selected orbit model, the asteroid belt and the satellite
+// catalogue, and publishes an
+// immutable snapshot through a triple buffer. The renderer draws the newest
+// snapshot it can get, so a slow N-body step never holds up a frame and a
+// slow frame never holds up the simulation.
+#pragma once
+
+#include "asteroid_belt.h"
+#include "checkpoint.h"
+#include "ephemeris.h"
+#include "jpl_de.h"
+#include "kepler.h"
+#include "nbody.h"
+#include "recording.h"
+#include "sgp4.h"
+#include "sim_lod.h"
+#include "solar_sim.h"
+#include "spacecraft.h"
+#include "triple_buffer.h"
+#include "vsop87.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool;
+
+// Points per planet in the N-body orbit trails.
+const size_t TRAIL_SAMPLES = 256;
+
+enum OrbitModel { ORBIT_CIRCULAR = 0, ORBIT_KEPLER, ORBIT_NBODY, ORBIT_EPHEMERIS, ORBIT_JPL_DE, ORBIT_VSOP87 };
+
+// Settings the UI edits; copied by the sim thread once per tick.
+struct SimControls {
+    bool running = true;
+    double timeMultiplier = 1.0;
+    bool closedForm = true;
+    int orbitModel = ORBIT_CIRCULAR;
+    Integrator integrator = Integrator::WisdomHolman;
+    bool barnesHut = false;
+    double theta = 0.5;
+    int substepBudget = 1000;
+    bool blockSteps = true;                // power-of-two step levels per body
+    bool showBelt = true;
+    bool showSatellites = true;            // the TLE catalogue, if one is loaded
+    bool showTrails = true;                // ORBIT_NBODY: orbit trails from sampled positions
+    double checkpointDays = 30.0;          // ORBIT_NBODY: simulated days between checkpoints
+    size_t checkpointBudgetMB = 32;        // memory for the checkpoint ring
+    size_t beltCount = 100000;
+    int vsopLevel = 0;                     // index into VSOP87_THRESHOLDS
+    // level of detail: per-planet SimLod tiers from the camera (classifySystems)
+    bool simLod = true;
+    int focusBody = -1;                    // planet index kept at full rate, -1 = none
+    std::vector<uint8_t> systemLod;        // empty = every system FULL
+    double lodBudgetMs = 0.5;              // per tick, for REDUCED refreshes
+    int lodInterval = 8;                   // ticks between REDUCED refreshes
+};
+
+struct SimSnapshot {
+    uint64_t sequence = 0;
+    SimTicks time = 0;                     // latest substep
+    SimTicks renderTime = 0;               // time of the interpolated state below
+    double timeDays = 0.0, renderDays = 0.0;  // the same as days since J2000
+    // per body in buildRegistry(createSolarSystem()) order, interpolated
+    std::vector<float> px, py, pz;         // centres, scene units (y up)
+    std::vector<float> model;              // 16 floats per body, column-major
+    std::vector<float> beltX, beltY, beltZ; // heliocentric ecliptic AU
+    // ORBIT_NBODY trails: TRAIL_SAMPLES xyz per planet, oldest first, scene
+    // units; trailLength[i] of them are filled. Empty when trails are off.
+    std::vector<float> trail;
+    std::vector<uint32_t> trailLength;
+    float beltMinAU = 0.0f, beltMaxAU = 0.0f;  // distance range the belt can reach
+    std::vector<float> satX, satY, satZ;   // Earth satellites, TEME km
+    // spacecraft: 4 floats each, scene xyz and the reference body's level (0 Sun, 1 planet, 2 moon)
+    std::vector<float> craft;
+
+    // --- stats ---
+    int substeps = 0;
+    size_t bodyUpdates = 0;                // bodies stepped this tick (block levels skip the slow ones)
+    size_t lodFull = 0, lodRefreshed = 0, lodDeferred = 0, lodFrozen = 0;
+    double lodMs = 0.0;
+    double stepSeconds = 0.0;
+    double droppedSeconds = 0.0;
+    double nbodyStepsPerSec = 0.0;
+    double energyDrift = 0.0;
+    long long nbodySteps = 0, nbodyRejected = 0, nbodyForceEvals = 0;
+    size_t checkpoints = 0, checkpointBytes = 0;
+    double checkpointRatio = 1.0;          // raw / compressed
+    double checkpointOldest = 0.0, checkpointNewest = 0.0;  // days
+    double rewindFromDays = 0.0, rewindGapDays = 0.0, rewindMs = 0.0;  // last scrub back
+    bool recording = false;                // StateRecorder running
+    size_t recordedFrames = 0, recordedBytes = 0;
+    double beltUpdateMs = 0.0;
+    size_t craftCount = 0, craftSwitches = 0, craftSearched = 0;
+    double craftUpdateMs = 0.0;
+    size_t satCount = 0, satDeep = 0, satLost = 0, satRejected = 0;
+    double satUpdateMs = 0.0;
+    double tickMs = 0.0;                   // cost of the tick that made this snapshot
+    bool ephemerisCovered = false;         // ORBIT_EPHEMERIS / ORBIT_JPL_DE: time inside the file
+};
+
+class SimulationThread {
+public:
+    // extraMoons: synthetic satellites as in addSyntheticMoons (same seed).
+    explicit SimulationThread(ThreadPool* pool = nullptr, size_t extraMoons = 0);
+    ~SimulationThread();
+
+    // Map a Chebyshev ephemeris for ORBIT_EPHEMERIS; call before start().
+    bool loadEphemeris(const std::string& path);
+    const Ephemeris& ephemeris() const { return eph; }
+    // Map a JPL DE binary file for ORBIT_JPL_DE; call before start().
+    bool loadJplEphemeris(const std::string& path);
+    const JplEphemeris& jplEphemeris() const { return de; }
+    // Read the VSOP87A series for ORBIT_VSOP87; call before start().
+    bool loadVsop87(const std::string& dir);
+    const Vsop87& vsop87() const { return vsop; }
+    // Read a TLE catalogue for the satellite layer; call before start().
+    bool loadTle(const std::string& path);
+    const SatelliteCatalog& satellites() const { return sats; }
+
+    void start();
+    void stop();
+
+    void setControls(const SimControls& c);
+    SimControls controls() const;
+    // Stream every tick's body states to `path` (see recording.h); an empty
+    // path stops. Applied by the sim thread on its next tick.
+    void record(const std::string& path);
+    // Restart every model at the given day (0 = reset).
+    void jumpTo(double days);
+    void jumpToTicks(SimTicks t);
+    // Launch `count` spacecraft from planet `planet` at the current time, with
+    // excess speeds spread over [vMinKms, vMaxKms]. Applied on the next tick.
+    void launchSpacecraft(int planet, size_t count, double vMinKms, double vMaxKms);
+    void clearSpacecraft();
+
+    // Renderer side, never blocks: the newest published snapshot.
+    const SimSnapshot& latest();
+
+    // One simulation tick for dtReal wall seconds (what the thread runs; also
+    // usable without start() for synchronous stepping).
+    void tick(double dtReal);
+
+    double tickSeconds = 1.0 / 240.0;     // target tick period
+
+private:
+    void run();
+    void applyControls(const SimControls& c);
+    void restartAt(SimTicks t);
+    void fill(SimSnapshot& s, const SimControls& c);
+    void clearTrails();
+    void sampleTrails(double t0, double t1);
+    // Restart the integrator at `days`: from the nearest checkpoint when the
+    // ring covers it (only the gap is integrated again), else from the elements.
+    void rewindNBody(double days);
+
+    BodyRegistry bodies;         // stepped state
+    BodyRegistry drawBodies;     // interpolated angles
+    FixedStepper stepper;
+    bool stepperClosedForm = true;   // mode the stepper was last reset for
+    SimLodScheduler lod;
+    std::vector<uint8_t> lodMask;    // per body, stepped or not
+    SimTicks simTime = 0;
+    std::vector<float> keplerScale;
+    KeplerPropagator keplerProp;
+    NBodySim nbody;
+    AsteroidBelt belt;
+    SatelliteCatalog sats;
+    SpacecraftFleet fleet;
+    uint32_t launchSeed = 1;
+    Ephemeris eph;
+    JplEphemeris de;
+    Vsop87 vsop;
+    int moonIndex = -1;          // Earth's Moon in the registry, aimed by ORBIT_JPL_DE
+    double nbodyStepsPerSec = 0.0;
+    CheckpointRing checkpoints;
+    std::vector<double> checkpointScratch;
+    bool rewindPending = false;      // fill() adds the re-integration to rewindMs
+    double rewindFromDays = 0.0, rewindGapDays = 0.0, rewindMs = 0.0;
+    // trail rings, TRAIL_SAMPLES per planet, one sample every trailSpacing days
+    std::vector<float> trailRing;
+    std::vector<size_t> trailHead, trailFill;
+    std::vector<double> trailNext, trailSpacing;
+    uint64_t sequence = 0;
+
+    TripleBuffer<SimSnapshot> snapshots;
+    mutable std::mutex controlMutex;
+    SimControls ctl;
+    bool jumpPending = false;
+    SimTicks jumpTime = 0;
+    bool recordPending = false;
+    std::string recordPath;
+    StateRecorder recorder;
+    struct LaunchRequest {
+        int planet;
+        size_t count;
+        double vMin, vMax;
+    };
+    std::vector<LaunchRequest> launches;
+    bool clearCraftPending = false;
+
+    std::thread worker;
+    std::atomic<bool> stopping{false};
+};
@@ -0,0 +1,58 @@
+// src/sim/sim_time.cpp
+#include "sim_time.h"
+
+#include <cmath>
+#include <cstdio>
+
+static const double MAX_DAYS = 1e11;
+
+SimTicks ticksFromDays(double days) {
+    if (!(days > -MAX_DAYS)) days = -MAX_DAYS;   // also NaN
+    if (days > MAX_DAYS) days = MAX_DAYS;
+    // whole days and fraction apart, so large dates keep their milliseconds
+    const double whole = std::floor(days);
+    return (SimTicks)whole * TICKS_PER_DAY + (SimTicks)std::llround((days - whole) * (double)TICKS_PER_DAY);
+}
+
+SimTicks ticksFromSeconds(double seconds) {
+    return ticksFromDays(seconds / 86400.0);
+}
+
+static int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    if ((a % b) < 0) --q;
+    return q;
+}
+
+void ticksToJulian(SimTicks t, int64_t& jdDay, double& jdFraction) {
+    // J2000 is JD 2451545.0, a noon, so JD days line up with tick days
+    const int64_t d = floorDiv(t, TICKS_PER_DAY);
+    jdDay = 2451545 + d;
+    jdFraction = (double)(t - d * TICKS_PER_DAY) / (double)TICKS_PER_DAY;
+}
+
+std::string formatCalendar(SimTicks t) {
+    // ticks from 2000-01-01 00:00, then days since 1970-01-01
+    const SimTicks midnight = t + TICKS_PER_DAY / 2;
+    const int64_t day = floorDiv(midnight, TICKS_PER_DAY);
+    int64_t ms = midnight - day * TICKS_PER_DAY;
+    int64_t z = day + 10957;
+
+    // civil_from_days (H. Hinnant), valid for any int64 day count
+    z += 719468;
+    const int64_t era = floorDiv(z, 146097);
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int64_t dom = doy - (153 * mp + 2) / 5 + 1;
+    const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+    const int64_t hh = ms / 3600000; ms -= hh * 3600000;
+    const int64_t mm = ms / 60000; ms -= mm * 60000;
+    char buf[128];   // six int64 fields at full width
+    std::snprintf(buf, sizeof(buf), "%04lld-%02lld-%02lld %02lld:%02lld:%02lld", (long long)year, (long long)month,
+                  (long long)dom, (long long)hh, (long long)mm, (long long)(ms / 1000));
+    return buf;
+}
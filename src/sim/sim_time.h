@@ -0,0 +1,35 @@
+// src/sim/sim_time.h
+// Simulation clock: an int64 count of milliseconds since J2000 (JD 2451545.0).
+// Substeps are whole ticks, so advancing the clock is exact integer addition:
+// a run lands on the same times however long it goes and a step never rounds
+// to nothing. Models still take days since J2000 as a double, derived here
+// with the whole days and the fraction converted separately.
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+typedef int64_t SimTicks;
+
+const int64_t TICKS_PER_SECOND = 1000;
+const int64_t TICKS_PER_DAY = 86400 * TICKS_PER_SECOND;
+
+// Nearest tick; clamped to +-1e11 days (a few hundred million years).
+SimTicks ticksFromDays(double days);
+SimTicks ticksFromSeconds(double seconds);
+
+inline double ticksToDays(SimTicks t) {
+    int64_t d = t / TICKS_PER_DAY, r = t % TICKS_PER_DAY;
+    if (r < 0) { --d; r += TICKS_PER_DAY; }
+    return (double)d + (double)r / (double)TICKS_PER_DAY;
+}
+
+inline double ticksToSeconds(SimTicks t) {
+    return (double)(t / TICKS_PER_SECOND) + (double)(t % TICKS_PER_SECOND) / (double)TICKS_PER_SECOND;
+}
+
+// Two-part Julian date: whole JD (days start at noon) and fraction in [0, 1).
+void ticksToJulian(SimTicks t, int64_t& jdDay, double& jdFraction);
+
+// Proleptic Gregorian "YYYY-MM-DD hh:mm:ss", astronomical year numbering.
+std::string formatCalendar(SimTicks t);
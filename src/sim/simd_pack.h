@@ -0,0 +1,258 @@
+// src/sim/simd_pack.h
+// Minimal float (PackF) and double (PackD) SIMD packs for the ISA the including translation unit is built for.
+// Kernels are written once against PackF and compiled several times (see
+// kepler_avx2.cpp / kepler_sse.cpp / kepler_scalar.cpp); each build lives in its
+// own namespace so the different PackF layouts never collide at link time.
+// SIMD_FORCE_SCALAR / SIMD_FORCE_SSE41 pin a build below what the flags allow.
+#pragma once
+
+#include <cmath>
+
+#if !defined(SIMD_FORCE_SCALAR) && !defined(SIMD_FORCE_SSE41) && defined(__AVX2__) && defined(__FMA__)
+#define SIMD_PACK_AVX2
+#include <immintrin.h>
+#define SIMD_NS simd_avx2
+#elif !defined(SIMD_FORCE_SCALAR) && defined(__SSE4_1__)
+#define SIMD_PACK_SSE41
+#include <smmintrin.h>
+#define SIMD_NS simd_sse41
+#else
+#define SIMD_NS simd_scalar
+#endif
+
+namespace SIMD_NS {
+
+#if defined(SIMD_PACK_AVX2)
+
+struct PackF {
+    static constexpr int width = 8;
+    __m256 v;
+    PackF() {}
+    PackF(__m256 x) : v(x) {}
+    PackF(float s) : v(_mm256_set1_ps(s)) {}
+    static PackF load(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+inline PackF operator+(PackF a, PackF b) { return _mm256_add_ps(a.v, b.v); }
+inline PackF operator-(PackF a, PackF b) { return _mm256_sub_ps(a.v, b.v); }
+inline PackF operator*(PackF a, PackF b) { return _mm256_mul_ps(a.v, b.v); }
+inline PackF operator/(PackF a, PackF b) { return _mm256_div_ps(a.v, b.v); }
+inline PackF fmadd(PackF a, PackF b, PackF c) { return _mm256_fmadd_ps(a.v, b.v, c.v); }
+inline PackF sqrt(PackF a) { return _mm256_sqrt_ps(a.v); }
+inline PackF abs(PackF a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline PackF min(PackF a, PackF b) { return _mm256_min_ps(a.v, b.v); }
+inline PackF max(PackF a, PackF b) { return _mm256_max_ps(a.v, b.v); }
+inline PackF round(PackF a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline PackF floor(PackF a) { return _mm256_floor_ps(a.v); }
+// Comparisons return all-ones lanes; select picks b where the mask is set.
+inline PackF cmpEq(PackF a, PackF b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+inline PackF cmpLt(PackF a, PackF b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline PackF maskOr(PackF a, PackF b) { return _mm256_or_ps(a.v, b.v); }
+inline PackF select(PackF mask, PackF a, PackF b) { return _mm256_blendv_ps(a.v, b.v, mask.v); }
+
+struct PackD {
+    static constexpr int width = 4;
+    __m256d v;
+    PackD() {}
+    PackD(__m256d x) : v(x) {}
+    PackD(double s) : v(_mm256_set1_pd(s)) {}
+    static PackD load(const double* p) { return _mm256_loadu_pd(p); }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+inline PackD operator+(PackD a, PackD b) { return _mm256_add_pd(a.v, b.v); }
+inline PackD operator-(PackD a, PackD b) { return _mm256_sub_pd(a.v, b.v); }
+inline PackD operator*(PackD a, PackD b) { return _mm256_mul_pd(a.v, b.v); }
+inline PackD operator/(PackD a, PackD b) { return _mm256_div_pd(a.v, b.v); }
+inline PackD fmadd(PackD a, PackD b, PackD c) { return _mm256_fmadd_pd(a.v, b.v, c.v); }
+inline PackD sqrt(PackD a) { return _mm256_sqrt_pd(a.v); }
+inline PackD abs(PackD a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+inline PackD min(PackD a, PackD b) { return _mm256_min_pd(a.v, b.v); }
+inline PackD max(PackD a, PackD b) { return _mm256_max_pd(a.v, b.v); }
+inline PackD round(PackD a) { return _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline PackD floor(PackD a) { return _mm256_floor_pd(a.v); }
+inline PackD cmpEq(PackD a, PackD b) { return _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ); }
+inline PackD cmpLt(PackD a, PackD b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+inline PackD maskOr(PackD a, PackD b) { return _mm256_or_pd(a.v, b.v); }
+inline PackD select(PackD mask, PackD a, PackD b) { return _mm256_blendv_pd(a.v, b.v, mask.v); }
+inline double hsum(PackD a) {
+    __m128d lo = _mm256_castpd256_pd128(a.v), hi = _mm256_extractf128_pd(a.v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+#elif defined(SIMD_PACK_SSE41)
+
+struct PackF {
+    static constexpr int width = 4;
+    __m128 v;
+    PackF() {}
+    PackF(__m128 x) : v(x) {}
+    PackF(float s) : v(_mm_set1_ps(s)) {}
+    static PackF load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+};
+inline PackF operator+(PackF a, PackF b) { return _mm_add_ps(a.v, b.v); }
+inline PackF operator-(PackF a, PackF b) { return _mm_sub_ps(a.v, b.v); }
+inline PackF operator*(PackF a, PackF b) { return _mm_mul_ps(a.v, b.v); }
+inline PackF operator/(PackF a, PackF b) { return _mm_div_ps(a.v, b.v); }
+inline PackF fmadd(PackF a, PackF b, PackF c) { return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v); }
+inline PackF sqrt(PackF a) { return _mm_sqrt_ps(a.v); }
+inline PackF abs(PackF a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline PackF min(PackF a, PackF b) { return _mm_min_ps(a.v, b.v); }
+inline PackF max(PackF a, PackF b) { return _mm_max_ps(a.v, b.v); }
+inline PackF round(PackF a) { return _mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline PackF floor(PackF a) { return _mm_floor_ps(a.v); }
+inline PackF cmpEq(PackF a, PackF b) { return _mm_cmpeq_ps(a.v, b.v); }
+inline PackF cmpLt(PackF a, PackF b) { return _mm_cmplt_ps(a.v, b.v); }
+inline PackF maskOr(PackF a, PackF b) { return _mm_or_ps(a.v, b.v); }
+inline PackF select(PackF mask, PackF a, PackF b) { return _mm_blendv_ps(a.v, b.v, mask.v); }
+
+struct PackD {
+    static constexpr int width = 2;
+    __m128d v;
+    PackD() {}
+    PackD(__m128d x) : v(x) {}
+    PackD(double s) : v(_mm_set1_pd(s)) {}
+    static PackD load(const double* p) { return _mm_loadu_pd(p); }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+};
+inline PackD operator+(PackD a, PackD b) { return _mm_add_pd(a.v, b.v); }
+inline PackD operator-(PackD a, PackD b) { return _mm_sub_pd(a.v, b.v); }
+inline PackD operator*(PackD a, PackD b) { return _mm_mul_pd(a.v, b.v); }
+inline PackD operator/(PackD a, PackD b) { return _mm_div_pd(a.v, b.v); }
+inline PackD fmadd(PackD a, PackD b, PackD c) { return _mm_add_pd(_mm_mul_pd(a.v, b.v), c.v); }
+inline PackD sqrt(PackD a) { return _mm_sqrt_pd(a.v); }
+inline PackD abs(PackD a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+inline PackD min(PackD a, PackD b) { return _mm_min_pd(a.v, b.v); }
+inline PackD max(PackD a, PackD b) { return _mm_max_pd(a.v, b.v); }
+inline PackD round(PackD a) { return _mm_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline PackD floor(PackD a) { return _mm_floor_pd(a.v); }
+inline PackD cmpEq(PackD a, PackD b) { return _mm_cmpeq_pd(a.v, b.v); }
+inline PackD cmpLt(PackD a, PackD b) { return _mm_cmplt_pd(a.v, b.v); }
+inline PackD maskOr(PackD a, PackD b) { return _mm_or_pd(a.v, b.v); }
+inline PackD select(PackD mask, PackD a, PackD b) { return _mm_blendv_pd(a.v, b.v, mask.v); }
+inline double hsum(PackD a) { return _mm_cvtsd_f64(_mm_add_sd(a.v, _mm_unpackhi_pd(a.v, a.v))); }
+
+#else
+
+// Scalar fallback (also what non-x86 targets such as Apple Silicon get; the
+// compiler is free to auto-vectorise the surrounding loops for NEON).
+struct PackF {
+    static constexpr int width = 1;
+    float v;
+    PackF() {}
+    PackF(float s) : v(s) {}
+    static PackF load(const float* p) { return *p; }
+    void store(float* p) const { *p = v; }
+};
+inline PackF operator+(PackF a, PackF b) { return a.v + b.v; }
+inline PackF operator-(PackF a, PackF b) { return a.v - b.v; }
+inline PackF operator*(PackF a, PackF b) { return a.v * b.v; }
+inline PackF operator/(PackF a, PackF b) { return a.v / b.v; }
+inline PackF fmadd(PackF a, PackF b, PackF c) { return a.v * b.v + c.v; }
+inline PackF sqrt(PackF a) { return std::sqrt(a.v); }
+inline PackF abs(PackF a) { return std::fabs(a.v); }
+inline PackF min(PackF a, PackF b) { return a.v < b.v ? a.v : b.v; }
+inline PackF max(PackF a, PackF b) { return a.v > b.v ? a.v : b.v; }
+inline PackF round(PackF a) { return std::nearbyint(a.v); }
+inline PackF floor(PackF a) { return std::floor(a.v); }
+inline PackF cmpEq(PackF a, PackF b) { return a.v == b.v ? 1.0f : 0.0f; }
+inline PackF cmpLt(PackF a, PackF b) { return a.v < b.v ? 1.0f : 0.0f; }
+inline PackF maskOr(PackF a, PackF b) { return (a.v != 0.0f || b.v != 0.0f) ? 1.0f : 0.0f; }
+inline PackF select(PackF mask, PackF a, PackF b) { return mask.v != 0.0f ? b : a; }
+
+struct PackD {
+    static constexpr int width = 1;
+    double v;
+    PackD() {}
+    PackD(double s) : v(s) {}
+    static PackD load(const double* p) { return *p; }
+    void store(double* p) const { *p = v; }
+};
+inline PackD operator+(PackD a, PackD b) { return a.v + b.v; }
+inline PackD operator-(PackD a, PackD b) { return a.v - b.v; }
+inline PackD operator*(PackD a, PackD b) { return a.v * b.v; }
+inline PackD operator/(PackD a, PackD b) { return a.v / b.v; }
+inline PackD fmadd(PackD a, PackD b, PackD c) { return a.v * b.v + c.v; }
+inline PackD sqrt(PackD a) { return std::sqrt(a.v); }
+inline PackD abs(PackD a) { return std::fabs(a.v); }
+inline PackD min(PackD a, PackD b) { return a.v < b.v ? a.v : b.v; }
+inline PackD max(PackD a, PackD b) { return a.v > b.v ? a.v : b.v; }
+inline PackD round(PackD a) { return std::nearbyint(a.v); }
+inline PackD floor(PackD a) { return std::floor(a.v); }
+inline PackD cmpEq(PackD a, PackD b) { return a.v == b.v ? 1.0 : 0.0; }
+inline PackD cmpLt(PackD a, PackD b) { return a.v < b.v ? 1.0 : 0.0; }
+inline PackD maskOr(PackD a, PackD b) { return (a.v != 0.0 || b.v != 0.0) ? 1.0 : 0.0; }
+inline PackD select(PackD mask, PackD a, PackD b) { return mask.v != 0.0 ? b : a; }
+inline double hsum(PackD a) { return a.v; }
+
+#endif
+
+inline PackF operator-(PackF a) { return PackF(0.0f) - a; }
+
+// sin and cos together (Cephes single-precision polynomials, ~1e-7 abs error
+// for |x| up to a few thousand radians).
+inline void sincos(PackF x, PackF &s, PackF &c) {
+    const PackF j = round(x * PackF(0.63661977236758134f));   // x * 2/pi
+    PackF y = fmadd(j, PackF(-1.5703125f), x);
+    y = fmadd(j, PackF(-4.837512969970703125e-4f), y);
+    y = fmadd(j, PackF(-7.54978995489188216e-8f), y);
+    const PackF z = y * y;
+
+    PackF ps = fmadd(z, PackF(-1.9515295891e-4f), PackF(8.3321608736e-3f));
+    ps = fmadd(ps, z, PackF(-1.6666654611e-1f));
+    ps = fmadd(ps * z, y, y);
+
+    PackF pc = fmadd(z, PackF(2.443315711809948e-5f), PackF(-1.388731625493765e-3f));
+    pc = fmadd(pc, z, PackF(4.166664568298827e-2f));
+    pc = fmadd(pc * z, z, fmadd(z, PackF(-0.5f), PackF(1.0f)));
+
+    // quadrant q = j mod 4, kept in float so no integer lanes are needed
+    const PackF q = j - PackF(4.0f) * floor(j * PackF(0.25f));
+    const PackF q1 = cmpEq(q, PackF(1.0f));
+    const PackF q2 = cmpEq(q, PackF(2.0f));
+    const PackF q3 = cmpEq(q, PackF(3.0f));
+    const PackF swap = maskOr(q1, q3);
+    PackF sOut = select(swap, ps, pc);
+    PackF cOut = select(swap, pc, ps);
+    sOut = select(maskOr(q2, q3), sOut, -sOut);
+    cOut = select(maskOr(q1, q2), cOut, -cOut);
+    s = sOut;
+    c = cOut;
+}
+
+inline PackD operator-(PackD a) { return PackD(0.0) - a; }
+
+// cos in double precision (Cephes sin.c polynomials on a three-part pi/2
+// reduction; ~1e-15 relative up to |x| ~ 1e6, which covers VSOP87 phases).
+inline PackD cos(PackD x) {
+    const PackD j = round(x * PackD(0.63661977236758134308));
+    PackD y = fmadd(j, PackD(-1.57079625129699707031), x);
+    y = fmadd(j, PackD(-7.54978941586159635335e-8), y);
+    y = fmadd(j, PackD(-5.39030285815811905290e-15), y);
+    const PackD z = y * y;
+
+    PackD ps = fmadd(z, PackD(1.58962301576546568060e-10), PackD(-2.50507477628578072866e-8));
+    ps = fmadd(ps, z, PackD(2.75573136213857245213e-6));
+    ps = fmadd(ps, z, PackD(-1.98412698295895385996e-4));
+    ps = fmadd(ps, z, PackD(8.33333333332211858878e-3));
+    ps = fmadd(ps, z, PackD(-1.66666666666666307295e-1));
+    ps = fmadd(ps * z, y, y);
+
+    PackD pc = fmadd(z, PackD(-1.13585365213876817300e-11), PackD(2.08757008419747316778e-9));
+    pc = fmadd(pc, z, PackD(-2.75573141792967388112e-7));
+    pc = fmadd(pc, z, PackD(2.48015872888517045348e-5));
+    pc = fmadd(pc, z, PackD(-1.38888888888730564116e-3));
+    pc = fmadd(pc, z, PackD(4.16666666666665929218e-2));
+    pc = fmadd(pc * z, z, fmadd(z, PackD(-0.5), PackD(1.0)));
+
+    // cos(y + q pi/2): q = 0 cos, 1 -sin, 2 -cos, 3 sin
+    const PackD q = j - PackD(4.0) * floor(j * PackD(0.25));
+    const PackD q1 = cmpEq(q, PackD(1.0));
+    const PackD q2 = cmpEq(q, PackD(2.0));
+    const PackD q3 = cmpEq(q, PackD(3.0));
+    const PackD r = select(maskOr(q1, q3), pc, ps);
+    return select(maskOr(q1, q2), r, -r);
+}
+
+} // namespace SIMD_NS
@@ -0,0 +1,432 @@
+// src/sim/solar_sim.cpp
+#include "solar_sim.h"
+#include "benchmarks.h"
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+
+double degPerSec(double days) {
+    return 360.0 / (days * 86400.0);
+}
+
+double rotSpeedH(double hours) {
+    return 360.0 / (hours * 3600.0);
+}
+
+static float wrapDegrees(double deg) {
+    double r = std::fmod(deg, 360.0);
+    if (r < 0.0) r += 360.0;
+    return (float)r;
+}
+
+const char* const PLANET_NAMES[PLANET_COUNT] = {"Mercury", "Venus", "Earth", "Mars",
+                                                 "Jupiter", "Saturn", "Uranus", "Neptune"};
+
+std::vector<Planet> createSolarSystem() {
+    std::map<std::string, double> orbitalPeriods = {
+        {"Mercury", 87.97},
+        {"Venus", 224.7},
+        {"Earth", 365.256},
+        {"Mars", 687.0},
+        {"Jupiter", 4331.0},
+        {"Saturn", 10747.0},
+        {"Uranus", 30589.0},
+        {"Neptune", 59800.0}
+    };
+
+    std::vector<Planet> planets = {
+        {"Mercury", 2.0f, degPerSec(orbitalPeriods["Mercury"]), rotSpeedH(1407.6), 0.01f, 0.09f, 0.0f, 0.0f, false, {}},
+        {"Venus",   3.0f, degPerSec(orbitalPeriods["Venus"]),   rotSpeedH(-5832.5), 177.4f, 0.19f, 60.0f, 0.0f, false, {}},
+        {"Earth",   4.0f, degPerSec(orbitalPeriods["Earth"]),   rotSpeedH(23.93), 23.44f, 0.205f, 120.0f, 0.0f, false, {}},
+        {"Mars",    5.0f, degPerSec(orbitalPeriods["Mars"]),    rotSpeedH(24.62), 25.19f, 0.14f, 200.0f, 0.0f, false, {}},
+        {"Jupiter", 7.0f, degPerSec(orbitalPeriods["Jupiter"]), rotSpeedH(9.93), 3.13f, 0.48f, 20.0f, 0.0f, false, {}},
+        {"Saturn",  9.0f, degPerSec(orbitalPeriods["Saturn"]),  rotSpeedH(10.56), 26.73f, 0.42f, 300.0f, 0.0f, true, {}},
+        {"Uranus",  11.5f, degPerSec(orbitalPeriods["Uranus"]),  rotSpeedH(-17.24), 97.77f, 0.28f, 340.0f, 0.0f, false, {}},
+        {"Neptune", 14.0f, degPerSec(orbitalPeriods["Neptune"]), rotSpeedH(16.11), 28.32f, 0.27f, 80.0f, 0.0f, false, {}}
+    };
+    planets[2].moons.push_back({
+        "Moon",
+        0.3f,
+        degPerSec(27.3),
+        degPerSec(27.3),
+        0.05f,
+        0.0f, 0.0f
+    });
+
+    for (auto &p : planets) {
+        p.orbitPhase = p.orbitAngle;
+        for (auto &m : p.moons) m.orbitPhase = m.orbitAngle;
+    }
+    return planets;
+}
+
+void addSyntheticMoons(std::vector<Planet>& planets, size_t count, unsigned seed) {
+    if (planets.empty()) return;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uperiod(0.5, 80.0), uangle(0.0, 360.0);
+    std::uniform_real_distribution<float> uradius(1.2f, 3.0f);
+    for (size_t k = 0; k < count; ++k) {
+        Planet &p = planets[k % planets.size()];
+        double period = uperiod(rng);
+        Moon m = {p.name + " sat " + std::to_string(k), p.size * uradius(rng), degPerSec(period),
+                  degPerSec(period), 0.01f, (float)uangle(rng), 0.0f};
+        m.orbitPhase = m.orbitAngle;
+        p.moons.push_back(m);
+    }
+}
+
+// --- fixed-timestep driver ---
+double substepSeconds(const BodyRegistry& bodies, double maxDegrees, double maxSeconds) {
+    double fastest = 0.0;
+    for (double w : bodies.orbitSpeed) fastest = std::fmax(fastest, std::fabs(w));
+    const double limit = fastest > 0.0 ? std::fmin(maxSeconds, maxDegrees / fastest) : maxSeconds;
+    const double ticks = std::floor(limit * (double)TICKS_PER_SECOND);
+    return std::fmax(ticks, 1.0) / (double)TICKS_PER_SECOND;
+}
+
+void FixedStepper::reset(BodyRegistry& bodies) {
+    stepSeconds = substepSeconds(bodies, maxStepDegrees, maxStepSeconds);
+    stepTicks = ticksFromSeconds(stepSeconds);
+    if (active.size() != bodies.size()) active.clear();
+    assignStepLevels(bodies, stepSeconds, maxStepDegrees, blockSteps ? maxStepSeconds : 0.0,
+                     active.empty() ? nullptr : active.data());
+    substep = 0;
+    accumulator = stepSeconds;   // alpha = 1: render exactly the given state
+    // "previous" = one own step back, so every level interpolates from the start
+    const size_t n = bodies.size();
+    prevOrbit.resize(n);
+    prevRotation.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double dt = stepSeconds * (double)(1u << bodies.stepLevel[i]);
+        prevOrbit[i] = (float)(bodies.orbitAngle[i] - dt * bodies.orbitSpeed[i]);
+        prevRotation[i] = (float)(bodies.rotationAngle[i] - dt * bodies.rotationSpeed[i]);
+    }
+}
+
+void FixedStepper::setActive(BodyRegistry& bodies, const std::vector<uint8_t>& mask, SimTicks simTime) {
+    if (mask == active) return;
+    if (prevOrbit.size() != bodies.size() || bodies.stepLevel.size() != bodies.size()) {
+        active = mask;
+        reset(bodies);
+        return;
+    }
+    for (size_t i = 0; i < bodies.size() && i < mask.size(); ++i) {
+        const bool was = active.empty() || active[i];
+        if (!mask[i] || was) continue;
+        // a level-L body's state belongs to the last multiple of 2^L substeps
+        const uint64_t span = 1ull << bodies.stepLevel[i];
+        const double own = stepSeconds * (double)span;
+        const double t = ticksToSeconds(simTime - (SimTicks)(substep & (span - 1)) * stepTicks);
+        evaluateBodies(bodies, t, i, i + 1);
+        prevOrbit[i] = (float)(bodies.orbitAngle[i] - own * bodies.orbitSpeed[i]);
+        prevRotation[i] = (float)(bodies.rotationAngle[i] - own * bodies.rotationSpeed[i]);
+    }
+    active = mask;
+    assignStepLevels(bodies, stepSeconds, maxStepDegrees, blockSteps ? maxStepSeconds : 0.0, active.data());
+}
+
+int FixedStepper::advance(BodyRegistry& bodies, SimTicks& simTime, double dtSim, bool closedForm) {
+    if (prevOrbit.size() != bodies.size() || bodies.stepLevel.size() != bodies.size() ||
+        substepSeconds(bodies, maxStepDegrees, maxStepSeconds) != stepSeconds) {
+        reset(bodies);
+    }
+    accumulator += dtSim;
+
+    long long n = (long long)std::floor(accumulator / stepSeconds);
+    lastBodyUpdates = 0;
+    if (closedForm) {
+        // nothing to integrate: jump the clock by whole substeps
+        accumulator -= n * stepSeconds;
+        simTime += n * stepTicks;
+        substep += (uint64_t)n;
+        lastSubsteps = (int)n;
+        return lastSubsteps;
+    }
+
+    if (n > maxSubstepsPerFrame) {
+        droppedSeconds += (n - maxSubstepsPerFrame) * stepSeconds;
+        accumulator -= (n - maxSubstepsPerFrame) * stepSeconds;
+        n = maxSubstepsPerFrame;
+    }
+    for (long long k = 0; k < n; ++k) {
+        // levels 0..L are due when 2^L divides the substep count
+        ++substep;
+        int top = 0;
+        while (top < MAX_STEP_LEVEL && (substep & ((2ull << top) - 1)) == 0) ++top;
+        lastBodyUpdates += stepBodyLevels(bodies, top, stepSeconds, prevOrbit.data(), prevRotation.data());
+        simTime += stepTicks;
+        accumulator -= stepSeconds;
+    }
+    lastSubsteps = (int)n;
+    return lastSubsteps;
+}
+
+// Angle difference along the direction of motion, assuming less than a full
+// turn per substep.
+static double forwardDelta(double from, double to, double speed) {
+    double d = std::fmod(to - from, 360.0);
+    if (speed >= 0.0) { if (d < 0.0) d += 360.0; }
+    else if (d > 0.0) d -= 360.0;
+    return d;
+}
+
+void FixedStepper::interpolate(const BodyRegistry& current, BodyRegistry& out) const {
+    const size_t n = current.size();
+    if (prevOrbit.size() != n) {
+        out.orbitAngle = current.orbitAngle;
+        out.rotationAngle = current.rotationAngle;
+        return;
+    }
+    const double a = alpha();
+    const bool levels = current.stepLevel.size() == n;
+    for (size_t i = 0; i < n; ++i) {
+        if (!active.empty() && !active[i]) continue;
+        // a body on level L last stepped (substep mod 2^L) substeps ago
+        const int level = levels ? current.stepLevel[i] : 0;
+        const uint64_t span = 1ull << level;
+        const double ai = 1.0 + ((double)(substep & (span - 1)) - 1.0 + a) / (double)span;
+        out.orbitAngle[i] = wrapDegrees(prevOrbit[i] + ai * forwardDelta(prevOrbit[i], current.orbitAngle[i], current.orbitSpeed[i]));
+        out.rotationAngle[i] = wrapDegrees(prevRotation[i] + ai * forwardDelta(prevRotation[i], current.rotationAngle[i], current.rotationSpeed[i]));
+    }
+}
+
+// --- headless batch propagation ---
+HeadlessStats runHeadless(double years, SimTicks stepTicks, bool closedForm, size_t extraMoons, bool blockSteps) {
+    HeadlessStats stats;
+    std::vector<Planet> planets = createSolarSystem();
+    addSyntheticMoons(planets, extraMoons);
+    BodyRegistry bodies = buildRegistry(planets);
+    const long long steps = stepTicks > 0 ? (long long)(ticksFromDays(years * 365.256) / stepTicks) : 0;
+    const double dtSim = ticksToSeconds(stepTicks);   // exact: a whole number of milliseconds
+    SimTicks simTime = 0;
+
+    FixedStepper limits;
+    assignStepLevels(bodies, dtSim, limits.maxStepDegrees, limits.maxStepSeconds);
+    std::vector<float> prevOrbit(bodies.size()), prevRotation(bodies.size());
+    long long updates = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long s = 0; s < steps; ++s) {
+        simTime += stepTicks;
+        if (closedForm) {
+            evaluateBodies(bodies, ticksToSeconds(simTime));
+        } else if (blockSteps) {
+            int top = 0;
+            while (top < MAX_STEP_LEVEL && ((s + 1) & ((2ll << top) - 1)) == 0) ++top;
+            updates += (long long)stepBodyLevels(bodies, top, dtSim, prevOrbit.data(), prevRotation.data());
+        } else {
+            stepBodies(bodies, dtSim);
+        }
+    }
+    // a level-L body was last stepped at the last multiple of 2^L: bring every level up to the end time
+    if (!closedForm && blockSteps) finishBodyLevels(bodies, (uint64_t)steps, dtSim);
+    auto t1 = std::chrono::steady_clock::now();
+
+    stats.steps = steps;
+    stats.flatBodySteps = steps * (long long)bodies.size();
+    stats.bodySteps = blockSteps && !closedForm ? updates : stats.flatBodySteps;
+    stats.simulatedDays = ticksToDays(simTime);
+    stats.wallSeconds = std::chrono::duration<double>(t1 - t0).count();
+
+    // Print the final state so the stepping loop cannot be optimised away.
+    for (size_t i = 0; i < bodies.rootCount; ++i) {
+        std::cout << bodies.info[i].name << ": orbit " << bodies.orbitAngle[i]
+                  << " deg, rotation " << bodies.rotationAngle[i] << " deg\n";
+    }
+    return stats;
+}
+
+// Index into createSolarSystem() / planetElementsJ2000() by name (any case), or -1.
+static int planetIndex(const std::string& name) {
+    for (size_t i = 0; i < PLANET_COUNT; ++i) {
+        const char* n = PLANET_NAMES[i];
+        size_t c = 0;
+        while (n[c] && c < name.size() && std::tolower((unsigned char)n[c]) == std::tolower((unsigned char)name[c])) ++c;
+        if (!n[c] && c == name.size()) return (int)i;
+    }
+    return -1;
+}
+
+int headlessMain(int argc, char** argv) {
+    double years = 1.0;
+    double dtSim = 3600.0;
+    bool closedForm = false;
+    double nbodyYears = 0.0;
+    size_t particles = 0;
+    size_t barnesHut = 0;
+    double theta = 0.5;
+    size_t moons = 0;
+    bool blockSteps = false;
+    std::string ephemerisPath;
+    double fromYears = -100.0, toYears = 100.0, granuleDays = 16.0;
+    int degree = 13;
+    bool nbodySource = false;
+    std::string recordPath;
+    double recordDays = 365.25, recordSpeed = 10.0;   // --days also sets the screening window
+    bool events = false;
+    size_t approachBodies = 0;
+    size_t ensembleMembers = 0;
+    double thresholdAU = 1e-3;
+    std::string porkchopFrom, porkchopTo, porkchopPath;
+    double departYears = 20.0;
+    size_t grid = 1000;
+    std::string assistFrom, assistTo, assistVia;
+    int maxFlybys = 3;
+    size_t spacecraft = 0;
+    std::string sgp4Source;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless" && i + 1 < argc && argv[i+1][0] != '-') years = std::atof(argv[++i]);
+        else if (arg == "--dt" && i + 1 < argc) dtSim = std::atof(argv[++i]);
+        else if (arg == "--closed-form") closedForm = true;
+        else if (arg == "--moons" && i + 1 < argc) moons = (size_t)std::atol(argv[++i]);
+        else if (arg == "--block-steps") blockSteps = true;
+        else if (arg == "--build-ephemeris" && i + 1 < argc) ephemerisPath = argv[++i];
+        else if (arg == "--from" && i + 1 < argc) fromYears = std::atof(argv[++i]);
+        else if (arg == "--to" && i + 1 < argc) toYears = std::atof(argv[++i]);
+        else if (arg == "--granule" && i + 1 < argc) granuleDays = std::atof(argv[++i]);
+        else if (arg == "--degree" && i + 1 < argc) degree = std::atoi(argv[++i]);
+        else if (arg == "--source" && i + 1 < argc) nbodySource = std::string(argv[++i]) == "nbody";
+        else if (arg == "--kepler" && i + 1 < argc) return runKeplerBenchmark((size_t)std::atol(argv[++i]), 100);
+        else if (arg == "--nbody" && i + 1 < argc) nbodyYears = std::atof(argv[++i]);
+        else if (arg == "--particles" && i + 1 < argc) particles = (size_t)std::atol(argv[++i]);
+        else if (arg == "--theta" && i + 1 < argc) theta = std::atof(argv[++i]);
+        else if (arg == "--barnes-hut" && i + 1 < argc) barnesHut = (size_t)std::atol(argv[++i]);
+        else if (arg == "--de" && i + 1 < argc) return runJplDeBenchmark(argv[++i], 100000);
+        else if (arg == "--vsop87" && i + 1 < argc) return runVsop87Benchmark(argv[++i], 4096);
+        else if (arg == "--sim-lod" && i + 1 < argc) return runSimLodBenchmark((size_t)std::atol(argv[++i]), 2000);
+        else if (arg == "--events") events = true;
+        else if (arg == "--ensemble" && i + 1 < argc) ensembleMembers = (size_t)std::atol(argv[++i]);
+        else if (arg == "--approaches" && i + 1 < argc) approachBodies = (size_t)std::atol(argv[++i]);
+        else if (arg == "--threshold" && i + 1 < argc) thresholdAU = std::atof(argv[++i]);
+        else if (arg == "--porkchop" && i + 2 < argc) {
+            porkchopFrom = argv[++i];
+            porkchopTo = argv[++i];
+        }
+        else if (arg == "--gravity-assist" && i + 2 < argc) {
+            assistFrom = argv[++i];
+            assistTo = argv[++i];
+        }
+        else if (arg == "--via" && i + 1 < argc) assistVia = argv[++i];
+        else if (arg == "--flybys" && i + 1 < argc) maxFlybys = std::atoi(argv[++i]);
+        else if (arg == "--spacecraft" && i + 1 < argc) spacecraft = (size_t)std::atol(argv[++i]);
+        else if (arg == "--sgp4" && i + 1 < argc) sgp4Source = argv[++i];
+        else if (arg == "--depart" && i + 1 < argc) departYears = std::atof(argv[++i]);
+        else if (arg == "--grid" && i + 1 < argc) grid = (size_t)std::atol(argv[++i]);
+        else if (arg == "--out" && i + 1 < argc) porkchopPath = argv[++i];
+        else if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--days" && i + 1 < argc) recordDays = std::atof(argv[++i]);
+        else if (arg == "--speed" && i + 1 < argc) recordSpeed = std::atof(argv[++i]);
+    }
+    if (!ephemerisPath.empty()) {
+        if (toYears <= fromYears || granuleDays <= 0.0 || degree < 1) {
+            std::cerr << "Bad ephemeris range/granule/degree\n";
+            return 1;
+        }
+        return runEphemerisBuild(ephemerisPath, fromYears, toYears, granuleDays, degree, nbodySource);
+    }
+    if (!porkchopFrom.empty()) {
+        const int from = planetIndex(porkchopFrom), to = planetIndex(porkchopTo);
+        if (from < 0 || to < 0 || from == to || grid < 2 || recordDays <= 0.0) {
+            std::cerr << "Bad porkchop bodies/grid/days\n";
+            return 1;
+        }
+        return runPorkchop(from, to, departYears, recordDays, grid, porkchopPath);
+    }
+    if (!assistFrom.empty()) {
+        const int from = planetIndex(assistFrom), to = planetIndex(assistTo);
+        std::vector<int> via;
+        bool ok = from >= 0 && to >= 0 && from != to && recordDays > 0.0;
+        for (size_t b = 0; ok && b < assistVia.size();) {
+            size_t e = assistVia.find(',', b);
+            if (e == std::string::npos) e = assistVia.size();
+            via.push_back(planetIndex(assistVia.substr(b, e - b)));
+            ok = via.back() >= 0;
+            b = e + 1;
+        }
+        if (!ok) {
+            std::cerr << "Bad gravity-assist bodies/days\n";
+            return 1;
+        }
+        return runGravityAssist(from, to, via, maxFlybys, departYears, recordDays);
+    }
+    if (spacecraft > 0) {
+        if (recordDays <= 0.0) {
+            std::cerr << "Bad spacecraft days\n";
+            return 1;
+        }
+        return runSpacecraft(spacecraft, departYears, recordDays);
+    }
+    if (!sgp4Source.empty()) {
+        if (recordDays < 0.0) {
+            std::cerr << "Bad SGP4 days\n";
+            return 1;
+        }
+        return runSgp4(sgp4Source, recordDays);
+    }
+    if (ensembleMembers > 0) return runEnsembleBenchmark(ensembleMembers, years);
+    if (approachBodies > 0) {
+        if (recordDays <= 0.0 || thresholdAU <= 0.0) {
+            std::cerr << "Bad screening days/threshold\n";
+            return 1;
+        }
+        return runApproachScreen(approachBodies, recordDays, thresholdAU);
+    }
+    if (events) {
+        if (toYears <= fromYears) {
+            std::cerr << "Bad event search range\n";
+            return 1;
+        }
+        return runEventSearch(fromYears, toYears, 20);
+    }
+    if (!recordPath.empty()) {
+        if (recordDays <= 0.0 || recordSpeed <= 0.0) {
+            std::cerr << "Bad recording days/speed\n";
+            return 1;
+        }
+        return runRecording(recordPath, recordDays, recordSpeed, moons);
+    }
+    if (barnesHut > 0) return runBarnesHutBenchmark(barnesHut, theta, 10);
+    if (nbodyYears > 0.0) return runNBodyBenchmark(nbodyYears, dtSim / 86400.0, particles);
+    if (years <= 0.0 || ticksFromSeconds(dtSim) <= 0) {
+        std::cerr << "Usage: --headless <years> [--dt <seconds>] [--closed-form] [--moons <n>] [--block-steps]\n"
+                  << "       --kepler <bodies>\n"
+                  << "       --nbody <years> [--dt <seconds>] [--particles <n>]\n"
+                  << "       --barnes-hut <particles> [--theta <angle>]\n"
+                  << "       --build-ephemeris <file> [--from <years>] [--to <years>] [--granule <days>]\n"
+                  << "                         [--degree <n>] [--source kepler|nbody]\n"
+                  << "       --de <jpl-de-file> | --vsop87 <dir>\n"
+                  << "       --sim-lod <moons>\n"
+                  << "       --events [--from <years>] [--to <years>]\n"
+                  << "       --approaches <bodies> [--days <days>] [--threshold <AU>]\n"
+                  << "       --headless <years> --ensemble <members>\n"
+                  << "       --gravity-assist <planet> <planet> [--via <planet,...> | --flybys <n>] [--depart <years>]\n"
+                  << "                        [--days <days>]\n"
+                  << "       --porkchop <planet> <planet> [--depart <years>] [--days <days>] [--grid <n>] [--out <file>]\n"
+                  << "       --spacecraft <n> [--depart <years>] [--days <days>]\n"
+                  << "       --sgp4 <tle-file>|<count> [--days <days>]\n"
+                  << "       --record <file> [--days <days>] [--speed <days/s>] [--moons <n>]\n";
+        return 1;
+    }
+
+    std::cout << "Headless run: " << years << " years, dt = " << ticksToSeconds(ticksFromSeconds(dtSim)) << " s"
+              << (closedForm ? " (closed-form)" : "") << (moons ? ", " + std::to_string(moons) + " extra moons" : "")
+              << (blockSteps ? ", block timesteps" : "") << "\n";
+    HeadlessStats st = runHeadless(years, ticksFromSeconds(dtSim), closedForm, moons, blockSteps);
+    const double rate = st.wallSeconds > 0.0 ? st.bodySteps / st.wallSeconds : 0.0;
+    std::cout << "Steps: " << st.steps << ", body-steps: " << st.bodySteps
+              << ", wall: " << st.wallSeconds << " s\n";
+    std::cout << "Throughput: " << rate << " body-steps/s\n";
+    if (st.bodySteps != st.flatBodySteps) {
+        // what the same wall time covers at dt, had every body been stepped every step
+        std::cout << "Flat-equivalent: " << st.flatBodySteps << " body-steps ("
+                  << (st.wallSeconds > 0.0 ? st.flatBodySteps / st.wallSeconds : 0.0) << "/s, "
+                  << (double)st.flatBodySteps / (double)std::max(1ll, st.bodySteps) << "x fewer updates)\n";
+    }
+    return 0;
+}
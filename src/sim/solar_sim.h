@@ -0,0 +1,120 @@
+// src/sim/solar_sim.h
+// Simulation state and stepping, kept free of GL/GLFW/ImGui so it can run headless.
+#pragma once
+
+#include "body_registry.h"
+#include "sim_time.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Moon {
+    std::string name;
+    float orbitRadius;
+    double orbitSpeed;
+    double rotationSpeed;
+    float size;
+    float orbitAngle;
+    float rotationAngle;
+    float orbitPhase = 0.0f;    // orbitAngle at simulated time 0
+};
+
+struct Planet {
+    std::string name;
+    float orbitRadius;
+    double orbitSpeed;
+    double rotationSpeed;
+    float axialTilt;
+    float size;
+    float orbitAngle;
+    float rotationAngle;
+    bool hasRing;
+    std::vector<Moon> moons;
+    float orbitPhase = 0.0f;
+};
+
+// --- speed helpers (degrees per simulated second) ---
+double degPerSec(double days);
+double rotSpeedH(double hours);
+
+// Sun-ordered planets with their moons, same order as the viewer's focus list.
+std::vector<Planet> createSolarSystem();
+// The planets' names in that order, which planetElementsJ2000() shares.
+const size_t PLANET_COUNT = 8;
+extern const char* const PLANET_NAMES[PLANET_COUNT];
+
+// Planet/Moon describe the system; the simulation runs on the flat
+// BodyRegistry built from them (stepBodies / evaluateBodies, where the
+// closed-form path sets every angle straight from absolute simulated time,
+// O(bodies) regardless of how far the jump is and free of accumulated drift).
+
+// Add `count` small satellites spread over the planets, for scaling tests.
+void addSyntheticMoons(std::vector<Planet>& planets, size_t count, unsigned seed = 7);
+
+// --- fixed-timestep driver ---
+// Frame time is accumulated and consumed in equal substeps, each short enough
+// that no orbit advances more than maxStepDegrees (the fastest body sets the
+// pace), so the result no longer depends on frame rate. Slower bodies sit on
+// power-of-two block levels and are only stepped every 2^level substeps.
+// Rendering interpolates every body between its own last two stepped states.
+struct FixedStepper {
+    double maxStepDegrees = 2.0;     // orbital advance cap per substep
+    double maxStepSeconds = 21600.0; // keeps spin interpolation unambiguous
+    int maxSubstepsPerFrame = 1000;  // time beyond this is dropped, not queued
+    bool blockSteps = true;          // false: every body every substep
+
+    double stepSeconds = 0.0;        // current (base) substep length, whole ticks
+    SimTicks stepTicks = 0;
+    double accumulator = 0.0;        // unconsumed sim seconds, < stepSeconds
+    int lastSubsteps = 0;
+    size_t lastBodyUpdates = 0;      // bodies stepped during the last advance()
+    double droppedSeconds = 0.0;     // total sim time discarded by the budget
+    uint64_t substep = 0;            // substeps since reset(), drives the block levels
+    std::vector<float> prevOrbit, prevRotation;  // angles one own step back
+    std::vector<uint8_t> active;     // per body, 0 = not stepped (sim LOD); empty = all
+
+    // Consume dtSim seconds. simTime is the time of the latest stepped state
+    // and moves by whole substeps only. Closed-form mode only advances the
+    // clock; the caller evaluates at renderTime(). Returns the substeps taken.
+    int advance(BodyRegistry& bodies, SimTicks& simTime, double dtSim, bool closedForm);
+    // Restart from the given state (after a jump or reset); assigns the block levels.
+    void reset(BodyRegistry& bodies);
+    // Change which bodies are stepped. Bodies joining are first set from the
+    // closed form at their level's phase so they continue seamlessly.
+    void setActive(BodyRegistry& bodies, const std::vector<uint8_t>& mask, SimTicks simTime);
+
+    double alpha() const { return stepSeconds > 0.0 ? accumulator / stepSeconds : 0.0; }
+    // Time of the interpolated render state.
+    SimTicks renderTime(SimTicks simTime) const { return simTime + ticksFromSeconds(accumulator - stepSeconds); }
+    // Angles of out = previous + alpha_i * (current - previous), following each
+    // body's direction of motion, alpha_i measured in the body's own step.
+    // Inactive bodies are left as they are in out, which must have current's layout.
+    void interpolate(const BodyRegistry& current, BodyRegistry& out) const;
+};
+
+// Longest substep keeping every orbital advance under maxDegrees, rounded
+// down to whole clock ticks (at least one).
+double substepSeconds(const BodyRegistry& bodies, double maxDegrees, double maxSeconds);
+
+// --- headless batch propagation ---
+struct HeadlessStats {
+    double simulatedDays = 0.0;
+    long long steps = 0;
+    long long bodySteps = 0;         // body updates actually made
+    long long flatBodySteps = 0;     // what stepping every body every step costs
+    double wallSeconds = 0.0;
+};
+
+// Steps of stepTicks on an integer SimTicks clock, as FixedStepper::advance.
+// blockSteps: put bodies on power-of-two levels of the step (see FixedStepper).
+HeadlessStats runHeadless(double years, SimTicks stepTicks, bool closedForm, size_t extraMoons = 0,
+                          bool blockSteps = false);
+
+// Entry point for `--headless <years> [--dt <seconds>] [--closed-form] [--moons <n>] [--block-steps]` or
+// one of the benchmarks (`--kepler`, `--nbody`, `--barnes-hut`, `--de`, `--vsop87`, `--sim-lod`),
+// an event search (`--events`), approach screening (`--approaches`), a Monte Carlo ensemble
+// (`--ensemble`), a porkchop grid (`--porkchop`), a gravity-assist search (`--gravity-assist`),
+// patched-conic spacecraft (`--spacecraft`), SGP4 satellites (`--sgp4`) or a recording capture
+// (`--record`); returns the process exit code.
+int headlessMain(int argc, char** argv);
@@ -0,0 +1,399 @@
+// src/sim/spacecraft.cpp
+#include "spacecraft.h"
+#include "solar_sim.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// Moons that get a sphere of influence: mass as a fraction of the planet's, mean radius.
+struct KnownMoon {
+    const char* name;
+    double massRatio;
+    double radiusKm;
+};
+static const KnownMoon KNOWN_MOONS[] = {
+    {"Moon", 0.0123000371, 1737.4},
+};
+
+static const double SUN_RADIUS_KM = 695700.0;
+static const double ARM_EPS = 1e-10;         // AU a boundary function must reach before it can fire
+static const double EVENT_TOLERANCE = 1e-9;  // days
+
+static double dot3(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static double norm3(const double v[3]) {
+    return std::sqrt(dot3(v, v));
+}
+
+// --- hierarchy ---
+void ConicSystem::state(int body, double tDays, double r[3], double v[3]) const {
+    const ConicBody& b = bodies[body];
+    if (b.parent < 0) {
+        r[0] = r[1] = r[2] = v[0] = v[1] = v[2] = 0.0;
+        return;
+    }
+    keplerState(b.orbit, b.centralMass, tDays, r, v);
+}
+
+float ConicSystem::sceneRadius(double rAU) const {
+    if (radialAU.size() < 2) return (float)rAU;
+    size_t k = 1;
+    while (k + 1 < radialAU.size() && rAU > radialAU[k]) ++k;
+    // the last pair extrapolates past the outermost planet
+    const double f = (rAU - radialAU[k - 1]) / (radialAU[k] - radialAU[k - 1]);
+    return (float)(radialScene[k - 1] + f * (radialScene[k] - radialScene[k - 1]));
+}
+
+ConicSystem buildConicSystem(const std::vector<Planet>& planets) {
+    const double gmSun = GAUSS_K * GAUSS_K;
+    ConicSystem sys;
+    ConicBody sun;
+    sun.name = "Sun";
+    sun.gm = gmSun;
+    sun.radius = SUN_RADIUS_KM / AU_KM;
+    sys.bodies.push_back(sun);
+    sys.radialAU.push_back(0.0);
+    sys.radialScene.push_back(0.0f);
+
+    const std::vector<OrbitalElements> els = planetElementsJ2000();
+    const std::vector<double> masses = planetMassesSolar();
+    const std::vector<double> radii = planetRadiiKm();
+    const size_t n = std::min(planets.size(), els.size());
+    for (size_t i = 0; i < n; ++i) {
+        ConicBody p;
+        p.name = planets[i].name;
+        p.parent = 0;
+        p.registry = (int)i;
+        p.level = 1;
+        p.gm = gmSun * masses[i];
+        p.soi = els[i].a * std::pow(masses[i], 0.4);
+        p.radius = radii[i] / AU_KM;
+        p.orbit = els[i];
+        p.centralMass = 1.0 + masses[i];
+        const double q = els[i].a * (1.0 - els[i].e);
+        p.maxSpeed = GAUSS_K * std::sqrt(p.centralMass * (2.0 / q - 1.0 / els[i].a));
+        // the sphere of influence spans three drawn radii
+        p.sceneScale = 3.0f * planets[i].size / (float)p.soi;
+        sys.bodies[0].children.push_back((int)sys.bodies.size());
+        sys.bodies.push_back(p);
+        sys.radialAU.push_back(els[i].a);
+        sys.radialScene.push_back(planets[i].orbitRadius);
+    }
+
+    // moons follow the planets in the registry, grouped by planet
+    int registry = (int)planets.size();
+    for (size_t i = 0; i < planets.size(); ++i) {
+        for (const Moon& m : planets[i].moons) {
+            const int index = registry++;
+            if (i >= n || m.orbitSpeed == 0.0) continue;
+            const KnownMoon* known = nullptr;
+            for (const KnownMoon& k : KNOWN_MOONS) {
+                if (m.name == k.name) known = &k;
+            }
+            if (!known) continue;
+            const int parent = (int)i + 1;
+            ConicBody& p = sys.bodies[parent];
+            const double mass = masses[i] * known->massRatio;
+            // the registry's circle: same period and phase, radius from Kepler's third law
+            const double periodDays = 360.0 / (std::fabs(m.orbitSpeed) * 86400.0);
+            const double meanMotion = TWO_PI / periodDays;
+            const double central = masses[i] + mass;
+            const double sign = m.orbitSpeed < 0.0 ? -1.0 : 1.0;
+            ConicBody c;
+            c.name = m.name;
+            c.parent = parent;
+            c.registry = index;
+            c.level = 2;
+            c.gm = gmSun * mass;
+            c.radius = known->radiusKm / AU_KM;
+            c.orbit.a = std::cbrt(gmSun * central / (meanMotion * meanMotion));
+            c.orbit.e = 0.0;
+            c.orbit.i = sign < 0.0 ? 0.5 * TWO_PI : 0.0;
+            c.orbit.raan = c.orbit.argPeri = 0.0;
+            c.orbit.M0 = sign * m.orbitPhase * TWO_PI / 360.0;
+            c.orbit.epoch = 0.0;
+            c.centralMass = central;
+            c.soi = c.orbit.a * std::pow(known->massRatio, 0.4);
+            c.maxSpeed = meanMotion * c.orbit.a;
+            // the planet's frame keeps the moon's drawn orbit radius
+            if (p.children.empty()) p.sceneScale = m.orbitRadius / (float)c.orbit.a;
+            c.sceneScale = std::max(p.sceneScale, 3.0f * m.size / (float)c.soi);
+            p.children.push_back((int)sys.bodies.size());
+            sys.bodies.push_back(c);
+        }
+    }
+    return sys;
+}
+
+// --- fleet ---
+SpacecraftFleet::SpacecraftFleet(ThreadPool* pool) : pool(pool) {}
+
+void SpacecraftFleet::setBodies(const std::vector<Planet>& planets) {
+    sys = buildConicSystem(planets);
+    craft.clear();
+}
+
+void SpacecraftFleet::clear() {
+    craft.clear();
+    active = 0;
+}
+
+size_t SpacecraftFleet::add(int body, double tDays, const double r[3], const double v[3]) {
+    Craft c;
+    ConicSegment seg;
+    seg.t0 = tDays;
+    seg.body = body;
+    for (int k = 0; k < 3; ++k) {
+        seg.r0[k] = r[k];
+        seg.v0[k] = v[k];
+    }
+    seg.next = -1;   // searched by update(), on the pool
+    c.segments.push_back(seg);
+    craft.push_back(c);
+    return craft.size() - 1;
+}
+
+size_t SpacecraftFleet::launch(int planet, double tDays, double vInfKms, uint32_t seed) {
+    const int body = planet + 1;
+    if (planet < 0 || body >= (int)sys.bodies.size() || sys.bodies[body].level != 1) return craft.size();
+    const ConicBody& b = sys.bodies[body];
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> gauss;
+    double u[3], w[3];
+    do {
+        for (int k = 0; k < 3; ++k) u[k] = gauss(rng);
+    } while (norm3(u) < 1e-6);
+    const double nu = norm3(u);
+    for (int k = 0; k < 3; ++k) u[k] /= nu;
+    // velocity perpendicular to the radius: the launch is at periapsis
+    double nw;
+    do {
+        for (int k = 0; k < 3; ++k) w[k] = gauss(rng);
+        const double along = dot3(w, u);
+        for (int k = 0; k < 3; ++k) w[k] -= along * u[k];
+        nw = norm3(w);
+    } while (nw < 1e-6);
+
+    const double rp = launchRadius * b.radius;
+    const double vInf = vInfKms * 86400.0 / AU_KM;
+    const double vp = std::sqrt(vInf * vInf + 2.0 * b.gm / rp);
+    double r[3], v[3];
+    for (int k = 0; k < 3; ++k) {
+        r[k] = rp * u[k];
+        v[k] = vp * w[k] / nw;
+    }
+    return add(body, tDays, r, v);
+}
+
+void SpacecraftFleet::closeSegment(ConicSegment& seg) const {
+    const ConicBody& b = sys.bodies[seg.body];
+    const double gm = b.gm;
+    // speed on the conic is v(r) = sqrt(gm (2/r - alpha)), largest at periapsis
+    const double alpha = 2.0 / norm3(seg.r0) - dot3(seg.v0, seg.v0) / gm;
+    const double h[3] = {seg.r0[1] * seg.v0[2] - seg.r0[2] * seg.v0[1], seg.r0[2] * seg.v0[0] - seg.r0[0] * seg.v0[2],
+                         seg.r0[0] * seg.v0[1] - seg.r0[1] * seg.v0[0]};
+    const double p = dot3(h, h) / gm;
+    const double rp = p / (1.0 + std::sqrt(std::max(0.0, 1.0 - p * alpha)));
+
+    // boundaries: leaving this body's sphere, then entering each child's
+    std::vector<int> target;
+    std::vector<double> rate;   // bound on |dg/dt| beyond the craft's own speed
+    if (b.parent >= 0) {
+        target.push_back(b.parent);
+        rate.push_back(0.0);
+    }
+    for (int c : b.children) {
+        target.push_back(c);
+        rate.push_back(sys.bodies[c].maxSpeed);
+    }
+    const size_t m = target.size();
+    const double tEnd = seg.t0 + horizonDays;
+    if (m == 0) {
+        seg.t1 = tEnd;
+        seg.next = seg.body;
+        return;
+    }
+
+    auto speedAt = [&](double radius) {
+        return radius > 0.0 ? std::sqrt(std::max(0.0, gm * (2.0 / radius - alpha))) : 1e30;
+    };
+    auto boundary = [&](size_t k, double t, const double r[3]) {
+        if (target[k] == b.parent) return b.soi - norm3(r);
+        double rc[3], vc[3];
+        sys.state(target[k], t, rc, vc);
+        const double d[3] = {r[0] - rc[0], r[1] - rc[1], r[2] - rc[2]};
+        return norm3(d) - sys.bodies[target[k]].soi;
+    };
+    auto evaluate = [&](double t, double r[3], double* g) {
+        double v[3];
+        propagateConic(seg.r0, seg.v0, gm, t - seg.t0, r, v);
+        for (size_t k = 0; k < m; ++k) g[k] = boundary(k, t, r);
+    };
+
+    std::vector<double> g(m), g1(m);
+    std::vector<char> armed(m);
+    double t = seg.t0, r[3], r1[3];
+    evaluate(t, r, g.data());
+    for (size_t k = 0; k < m; ++k) armed[k] = g[k] > ARM_EPS;
+    for (int steps = 0; t < tEnd && steps < maxSearchSteps; ++steps) {
+        // no boundary can be reached within |g| / (bound on |dg/dt|). The
+        // speed bound vMax must hold over the step: moving at most vMax * step
+        // keeps the craft above rLow, so it holds if v(rLow) <= vMax. Raise
+        // vMax until it does; the periapsis speed always does.
+        const double rNow = norm3(r);
+        double vMax = speedAt(rNow), step = hMax;
+        for (int it = 0; it < 8; ++it) {
+            step = hMax;
+            for (size_t k = 0; k < m; ++k) step = std::min(step, std::fabs(g[k]) / (vMax + rate[k]));
+            const double need = speedAt(std::max(rp, rNow - vMax * step));
+            if (need <= vMax) break;
+            vMax = it < 6 ? need : speedAt(rp);
+        }
+        const double t1 = std::min(t + std::max(step, hMin), tEnd);
+        evaluate(t1, r1, g1.data());
+
+        int hit = -1;
+        double tHit = t1;
+        for (size_t k = 0; k < m; ++k) {
+            if (!armed[k] || g1[k] > 0.0) continue;
+            double lo = t, hi = t1, rm[3], vm[3];
+            while (hi - lo > EVENT_TOLERANCE) {
+                const double mid = 0.5 * (lo + hi);
+                propagateConic(seg.r0, seg.v0, gm, mid - seg.t0, rm, vm);
+                if (boundary(k, mid, rm) > 0.0) lo = mid;
+                else hi = mid;
+            }
+            if (hit < 0 || hi < tHit) {
+                hit = (int)k;
+                tHit = hi;
+            }
+        }
+        if (hit >= 0) {
+            seg.t1 = tHit;
+            seg.next = target[hit];
+            return;
+        }
+        for (size_t k = 0; k < m; ++k) {
+            if (g1[k] > ARM_EPS) armed[k] = 1;
+        }
+        t = t1;
+        g.swap(g1);
+        for (int k = 0; k < 3; ++k) r[k] = r1[k];
+    }
+    seg.t1 = t;   // the horizon, or as far as the step limit reached
+    seg.next = seg.body;
+}
+
+ConicSegment SpacecraftFleet::nextSegment(const ConicSegment& seg) const {
+    double r[3], v[3];
+    propagateConic(seg.r0, seg.v0, sys.bodies[seg.body].gm, seg.t1 - seg.t0, r, v);
+    double rb[3] = {0, 0, 0}, vb[3] = {0, 0, 0};
+    double sign = 0.0;
+    if (seg.next == sys.bodies[seg.body].parent) {
+        sys.state(seg.body, seg.t1, rb, vb);   // out: add the old body's state
+        sign = 1.0;
+    } else if (seg.next != seg.body) {
+        sys.state(seg.next, seg.t1, rb, vb);   // in: subtract the new body's
+        sign = -1.0;
+    }
+    ConicSegment out;
+    out.t0 = seg.t1;
+    out.body = seg.next;
+    for (int k = 0; k < 3; ++k) {
+        out.r0[k] = r[k] + sign * rb[k];
+        out.v0[k] = v[k] + sign * vb[k];
+    }
+    return out;
+}
+
+void SpacecraftFleet::updateCraft(Craft& c, double tDays, const SearchClock& clock, Tally& tally) const {
+    std::vector<ConicSegment>& s = c.segments;
+    if (s.empty() || tDays < s.front().t0) {
+        c.active = false;
+        return;
+    }
+    const size_t from = std::min(c.cursor, s.size() - 1);
+    size_t k = from;
+    if (tDays < s[k].t0) {
+        // back: the last segment starting at or before tDays
+        auto it = std::upper_bound(s.begin(), s.begin() + (std::ptrdiff_t)k, tDays,
+                                   [](double t, const ConicSegment& seg) { return t < seg.t0; });
+        k = (size_t)(it - s.begin()) - 1;
+    }
+    for (;;) {
+        if (s[k].next < 0) {
+            // out of budget: stay on the open conic until a later update
+            if (clock.budgetMs > 0.0 && std::chrono::steady_clock::now() > clock.deadline) {
+                ++tally.deferred;
+                break;
+            }
+            closeSegment(s[k]);
+            ++tally.found;
+        }
+        if (tDays < s[k].t1) break;
+        if (k + 1 == s.size()) s.push_back(nextSegment(s[k]));
+        ++k;
+    }
+    for (size_t j = std::min(from, k); j < std::max(from, k); ++j) {
+        if (s[j].next != s[j].body) ++tally.passed;
+    }
+    c.cursor = k;
+    c.active = true;
+    c.body = s[k].body;
+    double v[3];
+    propagateConic(s[k].r0, s[k].v0, sys.bodies[c.body].gm, tDays - s[k].t0, c.r, v);
+}
+
+void SpacecraftFleet::update(double tDays) {
+    auto t0 = std::chrono::steady_clock::now();
+    SearchClock clock;
+    clock.budgetMs = searchBudgetMs;
+    clock.deadline = t0 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double, std::milli>(std::max(0.0, searchBudgetMs)));
+    switches = 0;
+    searched = 0;
+    deferred = 0;
+    auto run = [&](size_t begin, size_t end) {
+        Tally tally;
+        for (size_t i = begin; i < end; ++i) updateCraft(craft[i], tDays, clock, tally);
+        switches += tally.passed;
+        searched += tally.found;
+        deferred += tally.deferred;
+    };
+    // a craft that has to search its events takes far longer than one that
+    // does not, so chunks stay small
+    if (pool && craft.size() > 64) pool->parallelFor(craft.size(), 16, run);
+    else run(0, craft.size());
+    active = 0;
+    for (const Craft& c : craft) active += c.active ? 1 : 0;
+    lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void SpacecraftFleet::scenePositions(const float* px, const float* py, const float* pz,
+                                     std::vector<float>& out) const {
+    out.clear();
+    out.reserve(4 * active);
+    for (const Craft& c : craft) {
+        if (!c.active) continue;
+        const ConicBody& b = sys.bodies[c.body];
+        // ecliptic (z up) -> scene (y up)
+        if (b.registry < 0) {
+            const double d = norm3(c.r);
+            const double s = d > 0.0 ? sys.sceneRadius(d) / d : 0.0;
+            out.push_back((float)(c.r[0] * s));
+            out.push_back((float)(c.r[2] * s));
+            out.push_back((float)(c.r[1] * s));
+        } else {
+            const float s = b.sceneScale;
+            out.push_back(px[b.registry] + (float)c.r[0] * s);
+            out.push_back(py[b.registry] + (float)c.r[2] * s);
+            out.push_back(pz[b.registry] + (float)c.r[1] * s);
+        }
+        out.push_back((float)b.level);
+    }
+}
@@ -0,0 +1,146 @@
+// src/sim/spacecraft.h
+// Spacecraft on patched conics through the Sun -> planet -> moon hierarchy.
+// A spacecraft is always on a two-body conic about one reference body. It
+// changes reference where it crosses a sphere of influence: outwards to the
+// parent when it leaves its body's sphere, inwards to a child when it enters
+// one. Only moons with a known mass have a sphere; massless synthetic moons
+// are passed through.
+//
+// Crossings are found once, when a conic segment is started, not by testing
+// distances every tick. The search covers a fixed horizon (or step count;
+// the segment then ends early and is searched again from there). It steps
+// the boundary functions g = soi - |r| (leaving) and g = |r - r_child| -
+// soi_child (entering) by conservative advancement: a step never exceeds |g|
+// over a bound on how fast g can change. Within a step a sign change is
+// therefore only possible in the hMin tail. A crossing is then bisected to
+// 1e-9 days. A boundary only fires after g has been seen positive. The
+// segment that starts on a boundary therefore does not fire on it straight away.
+//
+// Each spacecraft keeps its list of segments, so moving the clock back is a
+// binary search and moving it forward only solves the events not yet found.
+// Searches run inside update(), on the pool, up to searchBudgetMs per call. A
+// craft whose segment is still waiting is drawn on that segment's conic, so
+// a mass launch is spread over a few ticks instead of stalling one. Otherwise
+// a tick costs one conic propagation per spacecraft.
+//
+// Planets move on the J2000 mean elements (kepler.h). Moons move on circles
+// with the registry's period and phase. Scene positions follow the drawn
+// body: a craft is placed at its reference body's scene centre plus its
+// offset times that body's sceneScale. Sun-centred craft use a radial map
+// through the planets' (a, orbitRadius) pairs. Both are display choices, so a
+// marker jumps where its reference body changes.
+#pragma once
+
+#include "kepler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+struct Planet;
+
+struct ConicBody {
+    std::string name;
+    int parent = -1;              // ConicSystem index; -1 for the Sun
+    int registry = -1;            // BodyRegistry index; -1 for the Sun
+    int level = 0;                // 0 Sun, 1 planet, 2 moon
+    double gm = 0.0;              // AU^3/day^2
+    double soi = 1e30;            // sphere of influence, AU
+    double radius = 0.0;          // AU
+    OrbitalElements orbit{};      // about the parent
+    double centralMass = 1.0;     // solar masses, for keplerState
+    double maxSpeed = 0.0;        // bound on the orbital speed about the parent, AU/day
+    float sceneScale = 1.0f;      // scene units per AU inside the sphere
+    std::vector<int> children;
+};
+
+struct ConicSystem {
+    std::vector<ConicBody> bodies;        // the Sun, the planets, then moons with a mass
+    std::vector<double> radialAU;         // Sun-frame scene map: heliocentric distance ...
+    std::vector<float> radialScene;       // ... to scene distance, piecewise linear
+
+    // State of `body` relative to its parent.
+    void state(int body, double tDays, double r[3], double v[3]) const;
+    float sceneRadius(double rAU) const;
+};
+
+// Planet order and registry indices as buildRegistry(planets).
+ConicSystem buildConicSystem(const std::vector<Planet>& planets);
+
+struct ConicSegment {
+    double t0 = 0.0, t1 = 0.0;    // days since J2000; the segment holds on [t0, t1)
+    int body = 0;                 // reference body (ConicSystem index)
+    int next = -1;                // reference from t1 on; == body at the horizon, -1 before the search
+    double r0[3] = {0, 0, 0};     // state about `body` at t0, AU and AU/day
+    double v0[3] = {0, 0, 0};
+};
+
+class SpacecraftFleet {
+public:
+    explicit SpacecraftFleet(ThreadPool* pool = nullptr);
+
+    // Build the hierarchy from the given planets and remove every craft.
+    void setBodies(const std::vector<Planet>& planets);
+    const ConicSystem& system() const { return sys; }
+
+    // Leave planet `planet` (createSolarSystem() index) at tDays on a
+    // hyperbola with excess speed vInfKms. Periapsis is at launchRadius planet
+    // radii, in a random direction and plane. Returns the craft index.
+    size_t launch(int planet, double tDays, double vInfKms, uint32_t seed);
+    // A craft with state (r, v) about `body` (ConicSystem index) from tDays on.
+    size_t add(int body, double tDays, const double r[3], const double v[3]);
+    void clear();
+    size_t size() const { return craft.size(); }
+
+    // Move every craft to tDays, in either direction.
+    void update(double tDays);
+    // After update(): 4 floats per active craft, scene xyz (y up) and the
+    // level of its reference body. px/py/pz are the registry's scene centres.
+    void scenePositions(const float* px, const float* py, const float* pz, std::vector<float>& out) const;
+
+    // Every segment of craft i found so far.
+    const std::vector<ConicSegment>& segments(size_t i) const { return craft[i].segments; }
+
+    ThreadPool* pool = nullptr;
+    double horizonDays = 365.25;  // longest segment before its events are searched again
+    double hMin = 1e-3, hMax = 30.0;   // days, search steps
+    int maxSearchSteps = 256;     // per segment, so one search stays short
+    double launchRadius = 1.1;
+    double searchBudgetMs = 2.0;  // per update(); <= 0: no limit
+
+    // statistics of the last update()
+    size_t active = 0;
+    std::atomic<size_t> switches{0};     // reference changes passed
+    std::atomic<size_t> searched{0};     // segments whose events were searched
+    std::atomic<size_t> deferred{0};     // craft left on an unsearched segment by the budget
+    double lastUpdateMs = 0.0;
+
+private:
+    struct Craft {
+        std::vector<ConicSegment> segments;
+        size_t cursor = 0;        // segment used by the last update
+        bool active = false;
+        int body = 0;             // at the last update
+        double r[3] = {0, 0, 0};  // about `body`
+    };
+
+    struct SearchClock {
+        double budgetMs;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    struct Tally {
+        size_t passed = 0, found = 0, deferred = 0;
+    };
+
+    void closeSegment(ConicSegment& seg) const;
+    // The segment after `seg` (whose events have been searched); its own are not yet.
+    ConicSegment nextSegment(const ConicSegment& seg) const;
+    void updateCraft(Craft& c, double tDays, const SearchClock& clock, Tally& tally) const;
+
+    ConicSystem sys;
+    std::vector<Craft> craft;
+};
@@ -0,0 +1,82 @@
+// src/sim/thread_pool.cpp
+#include "thread_pool.h"
+
+static thread_local bool insidePool = false;
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto &w : workers) w.join();
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    if (workers.empty() || insidePool || count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> callLock(callMutex);
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        job = &fn;
+        jobCount = count;
+        jobGrain = grain;
+        next.store(0);
+        busy = (unsigned)workers.size();
+        ++generation;
+    }
+    wakeCv.notify_all();
+
+    insidePool = true;
+    runChunks();
+    insidePool = false;
+
+    std::unique_lock<std::mutex> lk(mutex);
+    doneCv.wait(lk, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::runChunks() {
+    for (;;) {
+        size_t b = next.fetch_add(jobGrain);
+        if (b >= jobCount) break;
+        size_t e = b + jobGrain < jobCount ? b + jobGrain : jobCount;
+        (*job)(b, e);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    insidePool = true;
+    unsigned long long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mutex);
+            wakeCv.wait(lk, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            if (--busy == 0) doneCv.notify_one();
+        }
+    }
+}
+
+ThreadPool& sharedThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,49 @@
+// src/sim/thread_pool.h
+// Fixed pool of worker threads for data-parallel loops. Chunks are handed out
+// from a shared atomic counter, so fast threads keep taking work until the
+// range is exhausted and uneven chunks balance themselves.
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // threads == 0 uses every hardware thread (the caller counts as one).
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size() + 1; }
+
+    // Calls fn(begin, end) over [0, count) in chunks of `grain`, blocking until
+    // every chunk is done. The calling thread takes chunks too. Nested calls
+    // from inside fn run inline.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex callMutex;      // one parallelFor at a time
+    std::mutex mutex;
+    std::condition_variable wakeCv, doneCv;
+    bool stopping = false;
+    unsigned long long generation = 0;
+    unsigned busy = 0;
+
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t jobCount = 0, jobGrain = 1;
+    std::atomic<size_t> next{0};
+};
+
+// Process-wide pool shared by the simulation subsystems.
+ThreadPool& sharedThreadPool();
@@ -0,0 +1,37 @@
+// src/sim/triple_buffer.h
+// Single-producer / single-consumer triple buffer. The writer fills back()
+// and publish()es it; the reader picks up the newest published slot with
+// update() and reads front() for as long as it likes. Neither side ever
+// waits: one atomic word holds the index of the spare slot plus a "fresh"
+// bit, and each side swaps its own slot with the spare.
+#pragma once
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+public:
+    // --- writer ---
+    T& back() { return slots[backIdx]; }
+    void publish() {
+        backIdx = spare.exchange(backIdx | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // --- reader ---
+    // Returns true if a newer slot was taken.
+    bool update() {
+        if (!(spare.load(std::memory_order_relaxed) & FRESH)) return false;
+        frontIdx = spare.exchange(frontIdx, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& front() const { return slots[frontIdx]; }
+
+private:
+    static const unsigned INDEX = 3u;
+    static const unsigned FRESH = 4u;
+
+    T slots[3];
+    std::atomic<unsigned> spare{1u};
+    unsigned backIdx = 0;     // writer-owned
+    unsigned frontIdx = 2;    // reader-owned
+};
@@ -0,0 +1,160 @@
+// src/sim/vsop87.cpp
+#include "vsop87.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const size_t VSOP_PAD = 4;   // widest PackD (AVX2)
+
+Vsop87::Vsop87() : level(detectSimdLevel()) {}
+
+bool Vsop87::load(const std::string& dir) {
+    const char* ext[8] = {"mer", "ven", "ear", "mar", "jup", "sat", "ura", "nep"};
+    for (int p = 0; p < 8; ++p) {
+        if (!loadPlanet(p, dir + "/VSOP87A." + ext[p])) return false;
+    }
+    return true;
+}
+
+bool Vsop87::loadPlanet(int planet, const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    // Header lines: " VSOP87 VERSION A1  MERCURY  VARIABLE 1 (XYZ)  *T**0  1449 TERMS ..."
+    // Term lines end in the amplitude A, phase B and frequency C.
+    struct Term { double a, b, c; };
+    std::vector<std::vector<Term>> raw;
+    std::vector<std::pair<int, int>> keys;   // (coord, power)
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find("VSOP87") != std::string::npos) {
+            size_t v = line.find("VARIABLE"), t = line.find("*T**");
+            if (v == std::string::npos || t == std::string::npos) {
+                std::cerr << "Bad VSOP87 header in " << path << "\n";
+                return false;
+            }
+            keys.push_back({std::atoi(line.c_str() + v + 8) - 1, std::atoi(line.c_str() + t + 4)});
+            raw.emplace_back();
+            continue;
+        }
+        if (raw.empty()) continue;
+        std::istringstream ss(line);
+        std::vector<std::string> tok;
+        std::string w;
+        while (ss >> w) tok.push_back(w);
+        if (tok.size() < 4) continue;
+        const size_t n = tok.size();
+        raw.back().push_back({std::atof(tok[n - 3].c_str()), std::atof(tok[n - 2].c_str()), std::atof(tok[n - 1].c_str())});
+    }
+    if (raw.empty()) {
+        std::cerr << "No VSOP87 series in " << path << "\n";
+        return false;
+    }
+
+    // reloading a planet drops its old series
+    series.erase(std::remove_if(series.begin(), series.end(), [&](const Series& s) { return s.planet == planet; }),
+                 series.end());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        std::vector<Term>& terms = raw[i];
+        if (keys[i].first < 0 || keys[i].first > 2 || terms.empty()) continue;
+        std::stable_sort(terms.begin(), terms.end(),
+                         [](const Term& x, const Term& y) { return std::fabs(x.a) > std::fabs(y.a); });
+        Series s;
+        s.planet = planet;
+        s.coord = keys[i].first;
+        s.power = keys[i].second;
+        s.begin = A.size();
+        const size_t padded = (terms.size() + VSOP_PAD - 1) / VSOP_PAD * VSOP_PAD;
+        for (const Term& t : terms) { A.push_back(t.a); B.push_back(t.b); C.push_back(t.c); }
+        A.resize(s.begin + padded, 0.0); B.resize(s.begin + padded, 0.0); C.resize(s.begin + padded, 0.0);
+        for (int l = 0; l < VSOP87_LEVELS; ++l) {
+            size_t keep = 0;
+            while (keep < terms.size() && std::fabs(terms[keep].a) >= VSOP87_THRESHOLDS[l]) ++keep;
+            s.count[l] = (keep + VSOP_PAD - 1) / VSOP_PAD * VSOP_PAD;
+        }
+        series.push_back(s);
+    }
+    loaded[planet] = true;
+    return true;
+}
+
+bool Vsop87::valid() const {
+    return std::all_of(loaded, loaded + 8, [](bool b) { return b; });
+}
+
+size_t Vsop87::termCount(int lvl) const {
+    size_t n = 0;
+    for (const Series& s : series) n += s.count[lvl];
+    return n;
+}
+
+double Vsop87::sum(const Series& s, int lvl, double T) const {
+    const size_t n = s.count[lvl];
+    const double* a = A.data() + s.begin;
+    const double* b = B.data() + s.begin;
+    const double* c = C.data() + s.begin;
+    switch (level) {
+#if defined(SOLAR_X86_KERNELS)
+        case SimdLevel::AVX2: return simd_avx2::vsopSum(a, b, c, n, T);
+        case SimdLevel::SSE41: return simd_sse41::vsopSum(a, b, c, n, T);
+#endif
+        default: return simd_scalar::vsopSum(a, b, c, n, T);
+    }
+}
+
+void Vsop87::position(int planet, double tDays, int lvl, double out[3]) const {
+    const double T = tDays / 365250.0;
+    out[0] = out[1] = out[2] = 0.0;
+    for (const Series& s : series) {
+        if (s.planet != planet) continue;
+        out[s.coord] += std::pow(T, s.power) * sum(s, lvl, T);
+    }
+}
+
+void Vsop87::planets(double tDays, int lvl, double* out) const {
+    const double T = tDays / 365250.0;
+    std::fill(out, out + 24, 0.0);
+    for (const Series& s : series) out[3 * s.planet + s.coord] += std::pow(T, s.power) * sum(s, lvl, T);
+}
+
+void Vsop87::batchRange(const double* epochs, size_t begin, size_t end, int lvl, double* out) const {
+    // epochs as millennia, padded to whole packs
+    const size_t m = end - begin;
+    const size_t padded = (m + VSOP_PAD - 1) / VSOP_PAD * VSOP_PAD;
+    std::vector<double> T(padded), acc(padded);
+    for (size_t e = 0; e < padded; ++e) T[e] = epochs[begin + std::min(e, m - 1)] / 365250.0;
+    std::fill(out + begin * 24, out + end * 24, 0.0);
+
+    for (const Series& s : series) {
+        const size_t n = s.count[lvl];
+        const double* a = A.data() + s.begin;
+        const double* b = B.data() + s.begin;
+        const double* c = C.data() + s.begin;
+        switch (level) {
+#if defined(SOLAR_X86_KERNELS)
+            case SimdLevel::AVX2: simd_avx2::vsopSumEpochs(a, b, c, n, T.data(), padded, acc.data()); break;
+            case SimdLevel::SSE41: simd_sse41::vsopSumEpochs(a, b, c, n, T.data(), padded, acc.data()); break;
+#endif
+            default: simd_scalar::vsopSumEpochs(a, b, c, n, T.data(), padded, acc.data()); break;
+        }
+        for (size_t e = 0; e < m; ++e) {
+            out[(begin + e) * 24 + 3 * s.planet + s.coord] += std::pow(T[e], s.power) * acc[e];
+        }
+    }
+}
+
+void Vsop87::planetsBatch(const double* epochs, size_t count, int lvl, double* out, ThreadPool* pool) const {
+    if (count == 0) return;
+    // 64 epochs keep the working set of a series pass in L1
+    const size_t block = 64;
+    auto range = [&](size_t b, size_t e) {
+        for (size_t k = b; k < e; k += block) batchRange(epochs, k, std::min(k + block, e), lvl, out);
+    };
+    if (pool) pool->parallelFor(count, block, range);
+    else range(0, count);
+}
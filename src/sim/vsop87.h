@@ -0,0 +1,80 @@
+// src/sim/vsop87.h
+// VSOP87 analytic planetary theory (Bretagnon & Francou 1988), version A:
+// heliocentric rectangular coordinates in the ecliptic and equinox of J2000,
+// AU, for Mercury..Neptune with the Earth itself (not the barycentre).
+//
+// Each coordinate is sum_a T^a * sum_k A_k cos(B_k + C_k T), T in Julian
+// millennia from J2000. The coefficient files (VSOP87A.mer .. VSOP87A.nep,
+// from the IMCCE/CDS distribution) are read at startup. Terms are sorted by
+// amplitude, so a truncation level is just a shorter prefix of each series;
+// the sums run through per-ISA double-precision kernels, across terms for
+// one epoch or across epochs for a batch.
+#pragma once
+
+#include "kepler.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Amplitude cut-offs in AU; level 0 keeps every term.
+const int VSOP87_LEVELS = 6;
+const double VSOP87_THRESHOLDS[VSOP87_LEVELS] = {0.0, 1e-9, 1e-8, 1e-7, 1e-6, 1e-5};
+
+class Vsop87 {
+public:
+    Vsop87();
+
+    // Read VSOP87A.mer, .ven, .ear, .mar, .jup, .sat, .ura, .nep from dir.
+    bool load(const std::string& dir);
+    // One planet (0 = Mercury .. 7 = Neptune) from one VSOP87A file.
+    bool loadPlanet(int planet, const std::string& path);
+    bool valid() const;
+
+    // Terms evaluated per epoch for all eight planets at a level.
+    size_t termCount(int level) const;
+
+    // Heliocentric ecliptic J2000 position, AU.
+    void position(int planet, double tDays, int level, double out[3]) const;
+    // All eight planets: out = 24 doubles.
+    void planets(double tDays, int level, double* out) const;
+    // out[(e * 8 + planet) * 3 + axis]; every term is evaluated for a whole
+    // pack of epochs at once. Splits across the pool.
+    void planetsBatch(const double* epochs, size_t count, int level, double* out,
+                      ThreadPool* pool = nullptr) const;
+
+    SimdLevel level;
+
+private:
+    struct Series {
+        int planet, coord, power;
+        size_t begin;                    // into A/B/C
+        size_t count[VSOP87_LEVELS];     // prefix per level, whole packs
+    };
+    double sum(const Series& s, int lvl, double T) const;
+    void batchRange(const double* epochs, size_t begin, size_t end, int lvl, double* out) const;
+
+    std::vector<double> A, B, C;
+    std::vector<Series> series;
+    bool loaded[8] = {};
+};
+
+// --- kernels, one build per ISA ---
+// vsopSum: sum_k A cos(B + C T) for one T; n a multiple of 4.
+// vsopSumEpochs: acc[e] = sum_k A cos(B + C T[e]); m a multiple of 4.
+namespace simd_scalar {
+double vsopSum(const double* A, const double* B, const double* C, size_t n, double T);
+void vsopSumEpochs(const double* A, const double* B, const double* C, size_t n, const double* T, size_t m, double* acc);
+}
+#if defined(SOLAR_X86_KERNELS)
+namespace simd_sse41 {
+double vsopSum(const double* A, const double* B, const double* C, size_t n, double T);
+void vsopSumEpochs(const double* A, const double* B, const double* C, size_t n, const double* T, size_t m, double* acc);
+}
+namespace simd_avx2 {
+double vsopSum(const double* A, const double* B, const double* C, size_t n, double T);
+void vsopSumEpochs(const double* A, const double* B, const double* C, size_t n, const double* T, size_t m, double* acc);
+}
+#endif
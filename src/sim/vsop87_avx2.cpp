@@ -0,0 +1,3 @@
+// src/sim/vsop87_avx2.cpp
+// AVX2/FMA build of the VSOP87 kernels (compiled with -mavx2 -mfma).
+#include "vsop87_kernel.inl"
@@ -0,0 +1,36 @@
+// src/sim/vsop87_kernel.inl
+// VSOP87 series sums written once against PackD. Included by
+// vsop87_{scalar,sse,avx2}.cpp, each compiled with its own ISA flags.
+#include "vsop87.h"
+#include "simd_pack.h"
+
+namespace SIMD_NS {
+
+double vsopSum(const double* A, const double* B, const double* C, size_t n, double T) {
+    const int W = PackD::width;
+    const PackD t(T);
+    PackD acc0(0.0), acc1(0.0);   // two chains hide the FMA latency
+    size_t k = 0;
+    for (; k + 2 * W <= n; k += 2 * W) {
+        acc0 = fmadd(PackD::load(A + k), cos(fmadd(PackD::load(C + k), t, PackD::load(B + k))), acc0);
+        acc1 = fmadd(PackD::load(A + k + W), cos(fmadd(PackD::load(C + k + W), t, PackD::load(B + k + W))), acc1);
+    }
+    for (; k < n; k += W) {
+        acc0 = fmadd(PackD::load(A + k), cos(fmadd(PackD::load(C + k), t, PackD::load(B + k))), acc0);
+    }
+    return hsum(acc0 + acc1);
+}
+
+void vsopSumEpochs(const double* A, const double* B, const double* C, size_t n, const double* T, size_t m, double* acc) {
+    const int W = PackD::width;
+    for (size_t e = 0; e < m; e += W) {
+        const PackD t = PackD::load(T + e);
+        PackD sum(0.0);
+        for (size_t k = 0; k < n; ++k) {
+            sum = fmadd(PackD(A[k]), cos(fmadd(PackD(C[k]), t, PackD(B[k]))), sum);
+        }
+        sum.store(acc + e);
+    }
+}
+
+} // namespace SIMD_NS
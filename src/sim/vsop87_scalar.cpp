@@ -0,0 +1,4 @@
+// src/sim/vsop87_scalar.cpp
+// Baseline build of the VSOP87 kernels; the fallback on every platform.
+#define SIMD_FORCE_SCALAR
+#include "vsop87_kernel.inl"
@@ -0,0 +1,4 @@
+// src/sim/vsop87_sse.cpp
+// SSE4.1 build of the VSOP87 kernels (compiled with -msse4.1).
+#define SIMD_FORCE_SSE41
+#include "vsop87_kernel.inl"